@@ -80,6 +80,16 @@ namespace media {
             });
         }
 
+        inline etl::optional<net::link::ChannelStatistics> get_channel_statistics() const {
+            using Result = etl::optional<net::link::ChannelStatistics>;
+            return get_media_interactor_ref().template visit<Result>(util::Visitor{
+                [](const uhf::UhfInteractor<RW> &media) -> Result {
+                    return media.get_channel_statistics();
+                },
+                [](const auto &) -> Result { return etl::nullopt; },
+            });
+        }
+
       public:
         inline void execute(net::frame::FrameService &fs, util::Time &time, util::Rand &rand) {
             etl::visit(
@@ -108,6 +118,19 @@ namespace media {
                 : net::link::MediaPortOperationResult::Failure;
         }
 
+        inline net::link::MediaPortOperationResult
+        serial_try_negotiate_baud_rate(uint32_t baud_rate, util::Time &time) {
+            auto &&interactor = get_media_interactor_ref();
+            if (!interactor.template holds_alternative<serial::SerialInteractor<RW>>()) {
+                return net::link::MediaPortOperationResult::UnsupportedOperation;
+            }
+
+            auto &media = interactor.template get<serial::SerialInteractor<RW>>();
+            return media.try_negotiate_baud_rate(baud_rate, time)
+                ? net::link::MediaPortOperationResult::Success
+                : net::link::MediaPortOperationResult::Failure;
+        }
+
         inline etl::expected<nb::Poll<nb::Future<bool>>, net::link::MediaPortUnsupportedOperation>
         wifi_join_ap(
             etl::span<const uint8_t> ssid,
@@ -10,6 +10,9 @@ namespace media {
     template <nb::AsyncReadableWritable RW>
     class SerialPortMediaPort {
         memory::Static<net::link::FrameBroker> broker_;
+        serial::FrameFormat serial_format_;
+        serial::BaudRateConfig baud_rate_;
+        bool enable_uhf_aggregation_;
         etl::variant<
             MediaDetector<RW>,
             memory::Static<uhf::UhfInteractor<RW>>,
@@ -27,9 +30,15 @@ namespace media {
         SerialPortMediaPort(
             memory::Static<RW> &serial,
             memory::Static<net::link::MeasuredLinkFrameQueue> &queue,
-            util::Time &time
+            util::Time &time,
+            serial::FrameFormat serial_format = serial::DEFAULT_FRAME_FORMAT,
+            const serial::BaudRateConfig &baud_rate = serial::BaudRateConfig{},
+            bool enable_uhf_aggregation = false
         )
             : broker_{queue},
+              serial_format_{serial_format},
+              baud_rate_{baud_rate},
+              enable_uhf_aggregation_{enable_uhf_aggregation},
               state_{MediaDetector<RW>{serial, time}} {}
 
         inline void initialize_media_port(net::link::MediaPortNumber port) {
@@ -47,7 +56,9 @@ namespace media {
 
                 switch (poll_media_type.unwrap()) {
                 case net::link::MediaType::UHF: {
-                    state_.template emplace<memory::Static<uhf::UhfInteractor<RW>>>(*rw, broker_);
+                    state_.template emplace<memory::Static<uhf::UhfInteractor<RW>>>(
+                        *rw, broker_, enable_uhf_aggregation_
+                    );
                     break;
                 }
                 case net::link::MediaType::Wifi: {
@@ -58,7 +69,7 @@ namespace media {
                 }
                 case net::link::MediaType::Serial: {
                     state_.template emplace<memory::Static<serial::SerialInteractor<RW>>>(
-                        *rw, broker_
+                        *rw, broker_, serial_format_, baud_rate_
                     );
                     break;
                 }
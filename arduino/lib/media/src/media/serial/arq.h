@@ -0,0 +1,224 @@
+#pragma once
+
+#include "./frame.h"
+#include <nb/time.h>
+#include <net/frame.h>
+#include <tl/vec.h>
+
+namespace media::serial {
+    // 確認応答を待たずに送信できるフレーム数
+    constexpr uint8_t ARQ_WINDOW_SIZE = 4;
+    constexpr util::Duration ARQ_RETRANSMISSION_TIMEOUT = util::Duration::from_millis(300);
+    constexpr uint8_t ARQ_MAX_RETRANSMISSION_COUNT = 3;
+    // 確認応答だけのフレームを送る前に，データフレームに載せる機会を待つ時間
+    constexpr util::Duration ARQ_ACK_DELAY = util::Duration::from_millis(20);
+
+    // 選択的確認応答のビット数
+    constexpr uint8_t ARQ_SELECTIVE_ACK_BITS = 8;
+    static_assert(ARQ_WINDOW_SIZE <= ARQ_SELECTIVE_ACK_BITS);
+
+    struct ArqOutgoingFrame {
+        uint8_t sequence;
+        SerialFrameHeader header;
+        net::frame::FrameBufferReader reader;
+    };
+
+    /**
+     * 送信側の窓．確認応答されていないフレームを保持し，タイムアウトしたものを再送する．
+     */
+    class ArqSendWindow {
+        struct Entry {
+            uint8_t sequence;
+            SerialFrameHeader header;
+            net::frame::FrameBufferReader reader;
+            uint8_t retransmission_count;
+            etl::optional<nb::Delay> timeout; // 送信し終えるまでは無効
+        };
+
+        tl::Vec<Entry, ARQ_WINDOW_SIZE> entries_{};
+        uint8_t next_sequence_{0};
+        uint16_t retransmission_count_{0};
+        uint16_t give_up_count_{0};
+
+        static bool is_acked(uint8_t sequence, uint8_t ack, uint8_t selective_ack) {
+            uint8_t behind = ack - sequence;
+            if (behind >= 1 && behind <= ARQ_WINDOW_SIZE) {
+                return true;
+            }
+            uint8_t ahead = sequence - ack - 1;
+            return ahead < ARQ_SELECTIVE_ACK_BITS && (selective_ack >> ahead) & 1;
+        }
+
+        etl::optional<uint8_t> find(uint8_t sequence) const {
+            for (uint8_t i = 0; i < entries_.size(); i++) {
+                if (entries_[i].sequence == sequence) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+      public:
+        // 確認応答されていない最も古いフレームから，窓の大きさ以上先には送らない
+        bool full() const {
+            for (const auto &entry : entries_) {
+                if (static_cast<uint8_t>(next_sequence_ - entry.sequence) >= ARQ_WINDOW_SIZE) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline uint8_t in_flight_count() const {
+            return entries_.size();
+        }
+
+        // 再送した回数
+        inline uint16_t retransmission_count() const {
+            return retransmission_count_;
+        }
+
+        // 再送回数の上限に達し，届けるのを諦めたフレーム数
+        inline uint16_t give_up_count() const {
+            return give_up_count_;
+        }
+
+        ArqOutgoingFrame
+        push(const SerialFrameHeader &header, net::frame::FrameBufferReader &&reader) {
+            FASSERT(!entries_.full());
+            uint8_t sequence = next_sequence_++;
+            ArqOutgoingFrame frame{
+                .sequence = sequence,
+                .header = header,
+                .reader = reader.make_initial_clone(),
+            };
+            entries_.push_back(Entry{
+                .sequence = sequence,
+                .header = header,
+                .reader = etl::move(reader),
+                .retransmission_count = 0,
+                .timeout = etl::nullopt,
+            });
+            return frame;
+        }
+
+        // フレームを送信し終えた時点から，再送までの時間を計る
+        void on_sent(uint8_t sequence, util::Time &time) {
+            auto opt_index = find(sequence);
+            if (opt_index.has_value()) {
+                entries_[*opt_index].timeout = nb::Delay{time, ARQ_RETRANSMISSION_TIMEOUT};
+            }
+        }
+
+        void on_ack_received(uint8_t ack, uint8_t selective_ack) {
+            uint8_t i = 0;
+            while (i < entries_.size()) {
+                if (is_acked(entries_[i].sequence, ack, selective_ack)) {
+                    entries_.swap_remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        // タイムアウトしたフレームがあれば，再送するフレームとして返す
+        etl::optional<ArqOutgoingFrame> poll_retransmission(util::Time &time) {
+            uint8_t i = 0;
+            while (i < entries_.size()) {
+                auto &entry = entries_[i];
+                if (!entry.timeout.has_value() || entry.timeout->poll(time).is_pending()) {
+                    i++;
+                    continue;
+                }
+
+                if (entry.retransmission_count >= ARQ_MAX_RETRANSMISSION_COUNT) {
+                    LOG_INFO(FLASH_STRING("Serial: give up retransmission"));
+                    give_up_count_++;
+                    entries_.swap_remove(i);
+                    continue;
+                }
+
+                entry.retransmission_count++;
+                entry.timeout = etl::nullopt;
+                retransmission_count_++;
+                return ArqOutgoingFrame{
+                    .sequence = entry.sequence,
+                    .header = entry.header,
+                    .reader = entry.reader.make_initial_clone(),
+                };
+            }
+            return etl::nullopt;
+        }
+    };
+
+    /**
+     * 受信側の窓．受信済みのシーケンス番号を覚えておき，再送された重複フレームを取り除く．
+     *
+     * フレームは受信した順に上位層へ渡し，並べ替えはしない．
+     */
+    class ArqReceiveWindow {
+        uint8_t expected_{0};
+        uint8_t received_{0}; // ビット`i`は，`expected_ + 1 + i`を受信済みであることを表す
+        etl::optional<nb::Delay> ack_delay_{};
+
+      public:
+        bool is_duplicate(uint8_t sequence) const {
+            uint8_t behind = expected_ - sequence;
+            if (behind >= 1 && behind <= ARQ_WINDOW_SIZE) {
+                return true;
+            }
+            uint8_t ahead = sequence - expected_ - 1;
+            return ahead < ARQ_SELECTIVE_ACK_BITS && (received_ >> ahead) & 1;
+        }
+
+        void on_data_accepted(uint8_t sequence) {
+            uint8_t offset = sequence - expected_;
+
+            // 窓から大きく外れている場合は，相手が再起動したものとみなして窓を合わせる
+            if (offset > ARQ_SELECTIVE_ACK_BITS) {
+                expected_ = sequence;
+                received_ = 0;
+                offset = 0;
+            }
+
+            if (offset != 0) {
+                received_ |= 1 << (offset - 1);
+                return;
+            }
+
+            expected_++;
+            while (received_ & 1) {
+                received_ >>= 1;
+                expected_++;
+            }
+            received_ >>= 1;
+        }
+
+        inline void request_ack(util::Time &time) {
+            if (!ack_delay_.has_value()) {
+                ack_delay_.emplace(time, ARQ_ACK_DELAY);
+            }
+        }
+
+        // データフレームに載せられなかった確認応答を，単独で送るべきか
+        inline bool poll_ack_due(util::Time &time) const {
+            return ack_delay_.has_value() && ack_delay_->poll(time).is_ready();
+        }
+
+        // 確認応答を載せたARQヘッダを作る
+        ArqHeader make_header(uint8_t flags, uint8_t sequence) {
+            ack_delay_ = etl::nullopt;
+            return ArqHeader{
+                .flags = flags,
+                .sequence = sequence,
+                .ack = expected_,
+                .selective_ack = received_,
+            };
+        }
+    };
+
+    struct Arq {
+        ArqSendWindow send;
+        ArqReceiveWindow receive;
+    };
+} // namespace media::serial
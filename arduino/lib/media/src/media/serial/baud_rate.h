@@ -0,0 +1,393 @@
+#pragma once
+
+#include <etl/optional.h>
+#include <etl/variant.h>
+#include <logger.h>
+#include <nb/serde.h>
+#include <nb/time.h>
+#include <stdint.h>
+
+namespace media::serial {
+    // 値が大きいほど速い
+    enum class BaudRate : uint8_t {
+        B19200 = 0,
+        B38400 = 1,
+        B57600 = 2,
+        B115200 = 3,
+    };
+
+    // 起動時の速度．切り替えに失敗した場合もこの速度に戻す
+    constexpr BaudRate DEFAULT_BAUD_RATE = BaudRate::B19200;
+
+    inline constexpr uint32_t to_bps(BaudRate rate) {
+        switch (rate) {
+        case BaudRate::B38400:
+            return 38400;
+        case BaudRate::B57600:
+            return 57600;
+        case BaudRate::B115200:
+            return 115200;
+        default:
+            return 19200;
+        }
+    }
+
+    inline constexpr etl::optional<BaudRate> baud_rate_from_bps(uint32_t bps) {
+        for (auto rate :
+             {BaudRate::B19200, BaudRate::B38400, BaudRate::B57600, BaudRate::B115200}) {
+            if (to_bps(rate) == bps) {
+                return rate;
+            }
+        }
+        return etl::nullopt;
+    }
+
+    inline constexpr bool is_valid_baud_rate(uint8_t rate) {
+        return rate <= static_cast<uint8_t>(BaudRate::B115200);
+    }
+
+    struct BaudRateConfig {
+        // 相手から提案された場合も，この速度より速くはしない
+        BaudRate max{DEFAULT_BAUD_RATE};
+        // 相手を見つけたときに自ら交渉を始めるか．相手が交渉に対応している場合のみ有効にする
+        bool auto_negotiate{false};
+    };
+
+    template <typename T>
+    concept BaudRateConfigurable = requires(T &rw, uint32_t bps) {
+        { rw.set_baud_rate(bps) };
+    };
+
+    constexpr auto BAUD_RATE_NEGOTIATION_TIMEOUT = util::Duration::from_millis(1000);
+    // 送信バッファに残ったフレームを送り切るための待ち時間
+    constexpr auto BAUD_RATE_SWITCH_DELAY = util::Duration::from_millis(100);
+    constexpr auto BAUD_RATE_CONFIRM_INTERVAL = util::Duration::from_millis(200);
+    constexpr auto BAUD_RATE_CONFIRM_TIMEOUT = util::Duration::from_millis(1000);
+
+    // `BAUD_RATE_ERROR_CHECK_INTERVAL`の間に，次のいずれかを超えたら既定の速度に戻す
+    constexpr auto BAUD_RATE_ERROR_CHECK_INTERVAL = util::Duration::from_millis(1000);
+    constexpr uint16_t BAUD_RATE_MAX_FRAME_ERRORS = 3;
+    constexpr uint16_t BAUD_RATE_MAX_DISCARDED_BYTES = 32;
+
+    // 既定でない速度で，この間フレームを受信しなければ`Confirm`で相手の速度を確かめる
+    constexpr auto BAUD_RATE_PROBE_INTERVAL = util::Duration::from_millis(1000);
+    // 既定でない速度で，この間正しいフレームを受信しなければ既定の速度に戻す
+    constexpr auto BAUD_RATE_SILENCE_TIMEOUT = util::Duration::from_millis(3000);
+
+    // 通信速度を交渉するための制御フレームの種類
+    enum class BaudRateControlType : uint8_t {
+        Request = 1,    // 対応できる最大の速度を提案する
+        Accept = 2,     // 提案と自身の最大の速度のうち，遅い方を切り替え先として返す
+        Confirm = 3,    // 切り替え後の速度で疎通を確かめる
+        ConfirmAck = 4, // `Confirm`への応答
+    };
+
+    inline constexpr bool is_valid_baud_rate_control_type(uint8_t type) {
+        return type >= static_cast<uint8_t>(BaudRateControlType::Request) &&
+            type <= static_cast<uint8_t>(BaudRateControlType::ConfirmAck);
+    }
+
+    struct BaudRateControl {
+        BaudRateControlType type;
+        BaudRate baud_rate;
+    };
+
+    class AsyncBaudRateControlSerializer {
+        nb::ser::Bin<uint8_t> type_;
+        nb::ser::Bin<uint8_t> baud_rate_;
+
+      public:
+        inline explicit AsyncBaudRateControlSerializer(const BaudRateControl &control)
+            : type_{static_cast<uint8_t>(control.type)},
+              baud_rate_{static_cast<uint8_t>(control.baud_rate)} {}
+
+        template <nb::ser::AsyncWritable W>
+        inline nb::Poll<nb::ser::SerializeResult> serialize(W &writer) {
+            SERDE_SERIALIZE_OR_RETURN(type_.serialize(writer));
+            return baud_rate_.serialize(writer);
+        }
+
+        inline constexpr uint8_t serialized_length() const {
+            return type_.serialized_length() + baud_rate_.serialized_length();
+        }
+    };
+
+    class AsyncBaudRateControlDeserializer {
+        nb::de::Bin<uint8_t> type_;
+        nb::de::Bin<uint8_t> baud_rate_;
+
+      public:
+        inline BaudRateControl result() const {
+            return BaudRateControl{
+                .type = static_cast<BaudRateControlType>(type_.result()),
+                .baud_rate = static_cast<BaudRate>(baud_rate_.result()),
+            };
+        }
+
+        template <nb::de::AsyncReadable R>
+        inline nb::Poll<nb::de::DeserializeResult> deserialize(R &reader) {
+            SERDE_DESERIALIZE_OR_RETURN(type_.deserialize(reader));
+            SERDE_DESERIALIZE_OR_RETURN(baud_rate_.deserialize(reader));
+            return is_valid_baud_rate_control_type(type_.result()) &&
+                    is_valid_baud_rate(baud_rate_.result())
+                ? nb::de::DeserializeResult::Ok
+                : nb::de::DeserializeResult::Invalid;
+        }
+    };
+
+    /**
+     * 相手と通信速度を交渉し，両端で同時に切り替える．
+     *
+     * 1. 一方が`Request`で対応できる最大の速度を提案し，相手は`Accept`で切り替え先を返す．
+     * 2. 双方とも，送信中のフレームを送り終えてから`BAUD_RATE_SWITCH_DELAY`後に切り替える．
+     * 3. 切り替え後は`Confirm`を送り合い，`BAUD_RATE_CONFIRM_TIMEOUT`以内に応答がなければ戻す．
+     *
+     * 切り替えた後も受信エラーが多ければ既定の速度に戻す．相手は速度の合わないフレームを
+     * 受信してエラーが増えるため，同じように既定の速度に戻る．
+     * 相手が既定の速度で再起動した場合や通信が途絶えた場合に備え，
+     * `BAUD_RATE_SILENCE_TIMEOUT`の間正しいフレームを受信しなければ既定の速度に戻す．
+     */
+    class BaudRateNegotiator {
+        struct Idle {};
+
+        struct Requesting {
+            nb::Delay timeout;
+        };
+
+        struct Switching {
+            BaudRate target;
+            etl::optional<nb::Delay> delay; // 送信中のフレームを送り終えてから開始する
+        };
+
+        struct Confirming {
+            nb::Delay timeout;
+            nb::Debounce confirm_interval;
+        };
+
+        BaudRate max_;
+        BaudRate current_{DEFAULT_BAUD_RATE};
+        bool auto_negotiation_pending_;
+        etl::variant<Idle, Requesting, Switching, Confirming> state_{};
+        etl::optional<BaudRateControl> outgoing_{};
+
+        etl::optional<nb::Debounce> error_check_{};
+        uint16_t last_frame_errors_{0};
+        uint16_t last_discarded_bytes_{0};
+
+        etl::optional<nb::Delay> silence_{}; // 最後に正しいフレームを受信してからの時間
+        etl::optional<nb::Debounce> probe_{};
+        uint16_t last_received_frames_{0};
+
+        template <typename RW>
+        void apply(RW &rw, BaudRate rate) {
+            if constexpr (BaudRateConfigurable<RW>) {
+                rw.set_baud_rate(to_bps(rate));
+            }
+            current_ = rate;
+            LOG_INFO(FLASH_STRING("Serial: baud rate "), to_bps(rate));
+        }
+
+        template <typename RW>
+        void fall_back(RW &rw) {
+            LOG_INFO(FLASH_STRING("Serial: fall back to default baud rate"));
+            apply(rw, DEFAULT_BAUD_RATE);
+            state_.emplace<Idle>();
+            outgoing_ = etl::nullopt;
+        }
+
+        void on_request_received(BaudRate proposed, bool yields) {
+            bool idle = etl::holds_alternative<Idle>(state_);
+            // 互いに提案し合った場合は，アドレスの大きい方が相手の提案に応じる
+            if (!idle && !(etl::holds_alternative<Requesting>(state_) && yields)) {
+                return;
+            }
+
+            BaudRate target = etl::min(proposed, max_);
+            outgoing_ = BaudRateControl{.type = BaudRateControlType::Accept, .baud_rate = target};
+            if (target == current_) {
+                state_.emplace<Idle>();
+            } else {
+                state_.emplace<Switching>(Switching{.target = target, .delay = etl::nullopt});
+            }
+        }
+
+        void on_accept_received(BaudRate target) {
+            if (!etl::holds_alternative<Requesting>(state_)) {
+                return;
+            }
+
+            if (target == current_) {
+                state_.emplace<Idle>();
+            } else {
+                state_.emplace<Switching>(Switching{.target = target, .delay = etl::nullopt});
+            }
+        }
+
+      public:
+        explicit BaudRateNegotiator(const BaudRateConfig &config)
+            : max_{config.max},
+              auto_negotiation_pending_{config.auto_negotiate} {}
+
+        inline BaudRate baud_rate() const {
+            return current_;
+        }
+
+        inline bool is_negotiating() const {
+            return !etl::holds_alternative<Idle>(state_);
+        }
+
+        // 切り替えの直前と直後は，制御フレーム以外を送らない
+        inline bool is_data_paused() const {
+            return etl::holds_alternative<Switching>(state_) ||
+                etl::holds_alternative<Confirming>(state_);
+        }
+
+        // `max`を上限として交渉を始める．交渉中の場合は始めない
+        bool start(BaudRate max, util::Time &time) {
+            if (is_negotiating()) {
+                return false;
+            }
+
+            max_ = max;
+            auto_negotiation_pending_ = false;
+            outgoing_ = BaudRateControl{.type = BaudRateControlType::Request, .baud_rate = max};
+            state_.emplace<Requesting>(
+                Requesting{.timeout = nb::Delay{time, BAUD_RATE_NEGOTIATION_TIMEOUT}}
+            );
+            return true;
+        }
+
+        void on_control_received(const BaudRateControl &control, bool yields) {
+            switch (control.type) {
+            case BaudRateControlType::Request:
+                on_request_received(control.baud_rate, yields);
+                break;
+            case BaudRateControlType::Accept:
+                on_accept_received(control.baud_rate);
+                break;
+            case BaudRateControlType::Confirm:
+                if (control.baud_rate == current_) {
+                    outgoing_ = BaudRateControl{
+                        .type = BaudRateControlType::ConfirmAck,
+                        .baud_rate = current_,
+                    };
+                }
+                [[fallthrough]];
+            case BaudRateControlType::ConfirmAck:
+                if (etl::holds_alternative<Confirming>(state_) && control.baud_rate == current_) {
+                    state_.emplace<Idle>();
+                }
+                break;
+            }
+        }
+
+        // 送るべき制御フレーム
+        inline const etl::optional<BaudRateControl> &outgoing() const {
+            return outgoing_;
+        }
+
+        inline void on_outgoing_started() {
+            outgoing_ = etl::nullopt;
+        }
+
+        /**
+         * @param initiates 自動で交渉を始める側か
+         * @param sender_idle 送信中のフレームがないか
+         * @param received_frames 正しく受信したフレームの数
+         */
+        template <typename RW>
+        void execute(
+            RW &rw,
+            bool initiates,
+            bool sender_idle,
+            uint16_t frame_errors,
+            uint16_t discarded_bytes,
+            uint16_t received_frames,
+            util::Time &time
+        ) {
+            if (auto_negotiation_pending_ && initiates && max_ != current_) {
+                start(max_, time);
+            }
+
+            if (etl::holds_alternative<Requesting>(state_)) {
+                if (etl::get<Requesting>(state_).timeout.poll(time).is_ready()) {
+                    LOG_INFO(FLASH_STRING("Serial: baud rate negotiation timed out"));
+                    state_.emplace<Idle>();
+                    outgoing_ = etl::nullopt;
+                }
+            }
+
+            if (etl::holds_alternative<Switching>(state_)) {
+                auto &state = etl::get<Switching>(state_);
+                if (!state.delay.has_value()) {
+                    if (!sender_idle || outgoing_.has_value()) {
+                        return;
+                    }
+                    state.delay.emplace(time, BAUD_RATE_SWITCH_DELAY);
+                }
+                if (state.delay->poll(time).is_pending()) {
+                    return;
+                }
+
+                apply(rw, state.target);
+                outgoing_ =
+                    BaudRateControl{.type = BaudRateControlType::Confirm, .baud_rate = current_};
+                state_.emplace<Confirming>(Confirming{
+                    .timeout = nb::Delay{time, BAUD_RATE_CONFIRM_TIMEOUT},
+                    .confirm_interval = nb::Debounce{time, BAUD_RATE_CONFIRM_INTERVAL},
+                });
+                error_check_.emplace(time, BAUD_RATE_ERROR_CHECK_INTERVAL);
+                last_frame_errors_ = frame_errors;
+                last_discarded_bytes_ = discarded_bytes;
+                silence_.emplace(time, BAUD_RATE_SILENCE_TIMEOUT);
+                probe_.emplace(time, BAUD_RATE_PROBE_INTERVAL);
+                last_received_frames_ = received_frames;
+                return;
+            }
+
+            if (etl::holds_alternative<Confirming>(state_)) {
+                auto &state = etl::get<Confirming>(state_);
+                if (state.timeout.poll(time).is_ready()) {
+                    fall_back(rw);
+                    return;
+                }
+                if (state.confirm_interval.poll(time).is_ready()) {
+                    outgoing_ = BaudRateControl{
+                        .type = BaudRateControlType::Confirm,
+                        .baud_rate = current_,
+                    };
+                }
+                return;
+            }
+
+            if (current_ == DEFAULT_BAUD_RATE) {
+                return;
+            }
+
+            if (received_frames != last_received_frames_) {
+                last_received_frames_ = received_frames;
+                silence_.emplace(time, BAUD_RATE_SILENCE_TIMEOUT);
+                probe_.emplace(time, BAUD_RATE_PROBE_INTERVAL);
+            } else if (silence_->poll(time).is_ready()) {
+                LOG_INFO(FLASH_STRING("Serial: no frame received at current baud rate"));
+                fall_back(rw);
+                return;
+            } else if (probe_->poll(time).is_ready() && !outgoing_.has_value()) {
+                // 同じ速度の相手は`ConfirmAck`を返すため，通信が途絶えていても速度を保てる
+                outgoing_ =
+                    BaudRateControl{.type = BaudRateControlType::Confirm, .baud_rate = current_};
+            }
+
+            if (error_check_.has_value() && error_check_->poll(time).is_ready()) {
+                uint16_t new_frame_errors = frame_errors - last_frame_errors_;
+                uint16_t new_discarded_bytes = discarded_bytes - last_discarded_bytes_;
+                last_frame_errors_ = frame_errors;
+                last_discarded_bytes_ = discarded_bytes;
+                if (new_frame_errors > BAUD_RATE_MAX_FRAME_ERRORS ||
+                    new_discarded_bytes > BAUD_RATE_MAX_DISCARDED_BYTES) {
+                    fall_back(rw);
+                }
+            }
+        }
+    };
+} // namespace media::serial
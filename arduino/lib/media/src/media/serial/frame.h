@@ -4,6 +4,7 @@
 #include <net/frame.h>
 #include <net/link.h>
 #include <stdint.h>
+#include <util/crc.h>
 
 namespace media::serial {
     class AsyncSerialAddressDeserializer {
@@ -40,11 +41,15 @@ namespace media::serial {
     // # シリアル通信のフレームレイアウト
     //
     // 1. プリアンブル(8byte)
-    // 2. 上位プロトコル(1byte)
-    // 3. 送信元アドレス(1byte)
-    // 4. 宛先アドレス(1byte)
-    // 5. データ長(1byte)
-    // 6. データ
+    // 2. ARQヘッダ(4byte, 最後のプリアンブルが`LAST_PREAMBLE_WITH_ARQ`の場合のみ)
+    // 3. 上位プロトコル(1byte)
+    // 4. 送信元アドレス(1byte)
+    // 5. 宛先アドレス(1byte)
+    // 6. データ長(1byte)
+    // 7. データ
+    // 8. CRC-16(2byte, 最後のプリアンブルが`LAST_PREAMBLE`以外の場合のみ)
+    //
+    // CRCは2から7までを対象とし，リトルエンディアンで書き込む．
 
     constexpr uint8_t HEADER_LENGTH =
         net::frame::PROTOCOL_SIZE + SerialAddress::SIZE * 2 + net::frame::BODY_LENGTH_SIZE;
@@ -52,7 +57,103 @@ namespace media::serial {
     constexpr uint8_t PREAMBLE = 0b10101010;
     constexpr uint8_t PREAMBLE_LENGTH = 7;
     constexpr uint8_t LAST_PREAMBLE = 0b10101011;
+    constexpr uint8_t LAST_PREAMBLE_WITH_CRC = 0b10101101;
+    constexpr uint8_t LAST_PREAMBLE_WITH_ARQ = 0b10101110;
     constexpr uint8_t LAST_PREAMBLE_LENGTH = 1;
+    constexpr uint8_t CRC_LENGTH = 2;
+
+    // 後の形式ほど多くの機能を持ち，前の形式の機能を全て含む
+    enum class FrameFormat : uint8_t {
+        Plain,
+        Crc,
+        Arq,
+    };
+
+    // 送信するフレームの形式の既定値．相手がより後の形式を使っていれば，そちらに合わせる
+    constexpr FrameFormat DEFAULT_FRAME_FORMAT = FrameFormat::Plain;
+
+    inline constexpr uint8_t last_preamble_of(FrameFormat format) {
+        switch (format) {
+        case FrameFormat::Crc:
+            return LAST_PREAMBLE_WITH_CRC;
+        case FrameFormat::Arq:
+            return LAST_PREAMBLE_WITH_ARQ;
+        default:
+            return LAST_PREAMBLE;
+        }
+    }
+
+    inline constexpr bool has_crc(FrameFormat format) {
+        return format != FrameFormat::Plain;
+    }
+
+    // シーケンス番号が有効な，データを運ぶフレームであることを表す
+    constexpr uint8_t ARQ_FLAG_DATA = 0b00000001;
+
+    struct ArqHeader {
+        uint8_t flags;
+        uint8_t sequence;
+        uint8_t ack;           // 次に受信を期待するシーケンス番号
+        uint8_t selective_ack; // ビット`i`は，`ack + 1 + i`を受信済みであることを表す
+
+        inline bool has_data() const {
+            return flags & ARQ_FLAG_DATA;
+        }
+    };
+
+    inline void update_crc(util::Crc16 &crc, const ArqHeader &header) {
+        crc.update(header.flags);
+        crc.update(header.sequence);
+        crc.update(header.ack);
+        crc.update(header.selective_ack);
+    }
+
+    class AsyncArqHeaderSerializer {
+        nb::ser::Bin<uint8_t> flags_;
+        nb::ser::Bin<uint8_t> sequence_;
+        nb::ser::Bin<uint8_t> ack_;
+        nb::ser::Bin<uint8_t> selective_ack_;
+
+      public:
+        inline explicit AsyncArqHeaderSerializer(const ArqHeader &header)
+            : flags_{header.flags},
+              sequence_{header.sequence},
+              ack_{header.ack},
+              selective_ack_{header.selective_ack} {}
+
+        template <nb::ser::AsyncWritable W>
+        inline nb::Poll<nb::ser::SerializeResult> serialize(W &writer) {
+            SERDE_SERIALIZE_OR_RETURN(flags_.serialize(writer));
+            SERDE_SERIALIZE_OR_RETURN(sequence_.serialize(writer));
+            SERDE_SERIALIZE_OR_RETURN(ack_.serialize(writer));
+            return selective_ack_.serialize(writer);
+        }
+    };
+
+    class AsyncArqHeaderDeserializer {
+        nb::de::Bin<uint8_t> flags_;
+        nb::de::Bin<uint8_t> sequence_;
+        nb::de::Bin<uint8_t> ack_;
+        nb::de::Bin<uint8_t> selective_ack_;
+
+      public:
+        inline ArqHeader result() const {
+            return ArqHeader{
+                .flags = flags_.result(),
+                .sequence = sequence_.result(),
+                .ack = ack_.result(),
+                .selective_ack = selective_ack_.result(),
+            };
+        }
+
+        template <nb::de::AsyncReadable R>
+        inline nb::Poll<nb::de::DeserializeResult> deserialize(R &reader) {
+            SERDE_DESERIALIZE_OR_RETURN(flags_.deserialize(reader));
+            SERDE_DESERIALIZE_OR_RETURN(sequence_.deserialize(reader));
+            SERDE_DESERIALIZE_OR_RETURN(ack_.deserialize(reader));
+            return selective_ack_.deserialize(reader);
+        }
+    };
 
     struct SerialFrameHeader {
         net::frame::ProtocolNumber protocol_number;
@@ -61,6 +162,13 @@ namespace media::serial {
         uint8_t length;
     };
 
+    inline void update_crc(util::Crc16 &crc, const SerialFrameHeader &header) {
+        crc.update(static_cast<uint8_t>(header.protocol_number));
+        crc.update(header.source.get());
+        crc.update(header.destination.get());
+        crc.update(header.length);
+    }
+
     class AsyncSerialFrameHeaderSerializer {
         nb::ser::Bin<uint8_t> protocol_number_;
         AsyncSerialAddressSerializer source_;
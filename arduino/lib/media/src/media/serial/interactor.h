@@ -12,6 +12,54 @@ namespace media::serial {
 
         FrameSender sender_;
         FrameReceiver receiver_;
+        FrameFormat format_;
+        Arq arq_{};
+        BaudRateNegotiator negotiator_;
+
+        inline FrameFormat send_format() const {
+            if (receiver_.remote_uses_arq()) {
+                return FrameFormat::Arq;
+            }
+            if (receiver_.remote_uses_crc() && format_ == FrameFormat::Plain) {
+                return FrameFormat::Crc;
+            }
+            return format_;
+        }
+
+        // 速度を変更できないシリアルでは，既定の速度より速い速度を提案しない
+        static inline constexpr BaudRate supported_baud_rate(BaudRate rate) {
+            return BaudRateConfigurable<RW> ? rate : DEFAULT_BAUD_RATE;
+        }
+
+        void execute_negotiator(
+            net::frame::FrameService &fs,
+            const SerialAddress &self_address,
+            util::Time &time
+        ) {
+            auto remote_address = receiver_.get_remote_address();
+            if (!remote_address.has_value()) {
+                return;
+            }
+
+            // 互いに自動で交渉を始めないよう，アドレスの小さい方だけが始める
+            bool initiates = self_address.get() < remote_address->get();
+            auto control = receiver_.take_control();
+            if (control.has_value()) {
+                negotiator_.on_control_received(*control, !initiates);
+            }
+
+            const auto &counter = receiver_.error_counter();
+            negotiator_.execute(
+                rw_, initiates, sender_.is_idle(), counter.frame_error_count(),
+                counter.discarded_byte_count(), receiver_.received_frame_count(), time
+            );
+
+            const auto &outgoing = negotiator_.outgoing();
+            if (outgoing.has_value() && sender_.is_idle() &&
+                sender_.try_start_control_frame(fs, self_address, *remote_address, *outgoing)) {
+                negotiator_.on_outgoing_started();
+            }
+        }
 
       public:
         SerialInteractor() = delete;
@@ -20,10 +68,20 @@ namespace media::serial {
         SerialInteractor &operator=(const SerialInteractor &) = delete;
         SerialInteractor &operator=(SerialInteractor &&) = delete;
 
-        explicit SerialInteractor(RW &rw, memory::Static<net::link::FrameBroker> &broker)
+        explicit SerialInteractor(
+            RW &rw,
+            memory::Static<net::link::FrameBroker> &broker,
+            FrameFormat format = DEFAULT_FRAME_FORMAT,
+            const BaudRateConfig &baud_rate = BaudRateConfig{}
+        )
             : rw_{rw},
               sender_{broker},
-              receiver_{broker} {}
+              receiver_{broker},
+              format_{format},
+              negotiator_{BaudRateConfig{
+                  .max = supported_baud_rate(baud_rate.max),
+                  .auto_negotiate = baud_rate.auto_negotiate,
+              }} {}
 
       public:
         inline constexpr net::link::AddressTypeSet supported_address_types() const {
@@ -43,11 +101,39 @@ namespace media::serial {
         }
 
         inline void execute(net::frame::FrameService &service, util::Time &time) {
-            receiver_.execute(service, rw_, time);
+            receiver_.execute(service, rw_, arq_, time);
             auto self_address = receiver_.get_self_address();
-            if (self_address.has_value()) {
-                sender_.execute(rw_, *self_address, receiver_.get_remote_address());
+            if (!self_address.has_value()) {
+                return;
+            }
+
+            execute_negotiator(service, *self_address, time);
+            if (!sender_.is_idle() || !negotiator_.is_data_paused()) {
+                sender_.execute(
+                    rw_, *self_address, receiver_.get_remote_address(), send_format(), arq_, time
+                );
+            }
+        }
+
+        inline const ArqSendWindow &arq_send_window() const {
+            return arq_.send;
+        }
+
+        inline const SerialErrorCounter &error_counter() const {
+            return receiver_.error_counter();
+        }
+
+        inline BaudRate baud_rate() const {
+            return negotiator_.baud_rate();
+        }
+
+        // `bps`を上限として相手と通信速度を交渉する
+        inline bool try_negotiate_baud_rate(uint32_t bps, util::Time &time) {
+            auto rate = baud_rate_from_bps(bps);
+            if (!rate.has_value() || supported_baud_rate(*rate) != *rate) {
+                return false;
             }
+            return negotiator_.start(*rate, time);
         }
 
         inline bool try_initialize_local_address(net::link::Address address) {
@@ -1,59 +1,203 @@
 #pragma once
 
+#include "./arq.h"
+#include "./baud_rate.h"
 #include "./frame.h"
 #include <etl/optional.h>
 #include <nb/serde.h>
 #include <net/frame.h>
 #include <net/link.h>
+#include <util/crc.h>
 
 namespace media::serial {
-    struct SkipPreamble {
+    class SerialErrorCounter {
+        uint16_t crc_error_count_{0};
+        uint16_t header_error_count_{0};
+        uint16_t discarded_byte_count_{0};
+
+        static inline void saturating_add(uint16_t &count, uint16_t value) {
+            count = count > 0xFFFF - value ? 0xFFFF : count + value;
+        }
+
+      public:
+        // CRCが一致せずに破棄したフレーム数
+        inline uint16_t crc_error_count() const {
+            return crc_error_count_;
+        }
+
+        // ヘッダが不正で破棄したフレーム数
+        inline uint16_t header_error_count() const {
+            return header_error_count_;
+        }
+
+        // プリアンブルを探す間に読み捨てたバイト数
+        inline uint16_t discarded_byte_count() const {
+            return discarded_byte_count_;
+        }
+
+        inline void on_crc_error() {
+            saturating_add(crc_error_count_, 1);
+        }
+
+        inline void on_header_error() {
+            saturating_add(header_error_count_, 1);
+        }
+
+        // ヘッダかCRCが不正で破棄したフレーム数
+        inline uint16_t frame_error_count() const {
+            uint16_t count = crc_error_count_;
+            saturating_add(count, header_error_count_);
+            return count;
+        }
+
+        inline void on_bytes_discarded(uint8_t count) {
+            saturating_add(discarded_byte_count_, count);
+        }
+    };
+
+    /**
+     * プリアンブルを1バイトずつ照合する．
+     *
+     * 照合に失敗しても，読んだバイトが`PREAMBLE`であれば一致の途中として扱うため，
+     * ノイズの直後に始まるフレームのプリアンブルを読み捨てることがない．
+     */
+    class MatchPreamble {
+        uint8_t matched_length_{0};
+
+      public:
+        // 照合できたフレームの形式を返す
         template <nb::AsyncReadable R>
-        inline nb::Poll<nb::DeserializeResult> deserialize(R &readable) {
-        continue_outer:
-            POLL_UNWRAP_OR_RETURN(readable.poll_readable(PREAMBLE_LENGTH + LAST_PREAMBLE_LENGTH));
-            for (uint8_t i = 0; i < PREAMBLE_LENGTH; i++) {
-                if (readable.read_unchecked() != PREAMBLE) {
-                    goto continue_outer;
+        nb::Poll<FrameFormat> execute(R &readable, SerialErrorCounter &counter) {
+            while (true) {
+                POLL_UNWRAP_OR_RETURN(readable.poll_readable(1));
+                uint8_t byte = readable.read_unchecked();
+                if (byte == PREAMBLE) {
+                    if (matched_length_ < PREAMBLE_LENGTH) {
+                        matched_length_++;
+                    } else {
+                        counter.on_bytes_discarded(1);
+                    }
+                    continue;
                 }
-            }
 
-            for (uint8_t i = 0; i < LAST_PREAMBLE_LENGTH; i++) {
-                if (readable.read_unchecked() != LAST_PREAMBLE) {
-                    goto continue_outer;
+                if (matched_length_ == PREAMBLE_LENGTH) {
+                    for (auto format : {FrameFormat::Plain, FrameFormat::Crc, FrameFormat::Arq}) {
+                        if (byte == last_preamble_of(format)) {
+                            matched_length_ = 0;
+                            return format;
+                        }
+                    }
                 }
-            }
 
-            return nb::DeserializeResult::Ok;
+                counter.on_bytes_discarded(matched_length_ + 1);
+                matched_length_ = 0;
+            }
         }
     };
 
+    /**
+     * データを受信してフレームバッファに書き込む．
+     * CRCが付いている場合は，受信したバイトから順にCRCを計算する．
+     */
     class ReceiveData {
+        SerialFrameHeader header_;
         net::frame::FrameBufferWriter frame_writer_;
+        etl::optional<util::Crc16> crc_;
 
       public:
-        inline explicit ReceiveData(net::frame::FrameBufferWriter &&frame_writer)
-            : frame_writer_{etl::move(frame_writer)} {}
+        inline explicit ReceiveData(
+            const SerialFrameHeader &header,
+            net::frame::FrameBufferWriter &&frame_writer,
+            etl::optional<util::Crc16> crc
+        )
+            : header_{header},
+              frame_writer_{etl::move(frame_writer)},
+              crc_{crc} {}
+
+        inline const SerialFrameHeader &header() const {
+            return header_;
+        }
+
+        inline const etl::optional<util::Crc16> &crc() const {
+            return crc_;
+        }
+
+        inline net::frame::FrameBufferReader create_reader() const {
+            return frame_writer_.create_reader();
+        }
 
         template <nb::AsyncReadable R>
         inline nb::Poll<void> execute(R &readable) {
             while (!frame_writer_.is_all_written()) {
                 POLL_UNWRAP_OR_RETURN(readable.poll_readable(1));
-                frame_writer_.write_unchecked(readable.read_unchecked());
+                // CRCは実際に受信したバイトだけで計算する
+                if constexpr (nb::AsyncBulkReadable<R>) {
+                    auto buffer = frame_writer_.writable_buffer();
+                    uint8_t read = readable.read_into(buffer);
+                    if (read == 0) {
+                        return nb::pending;
+                    }
+                    frame_writer_.commit_unchecked(read);
+                    if (crc_.has_value()) {
+                        crc_->update(buffer.first(read));
+                    }
+                } else {
+                    uint8_t byte = readable.read_unchecked();
+                    frame_writer_.write_unchecked(byte);
+                    if (crc_.has_value()) {
+                        crc_->update(byte);
+                    }
+                }
             }
             return nb::ready();
         }
     };
 
+    // 受信したCRCを，ヘッダとデータから計算したCRCと照合する
+    class VerifyCrc {
+        SerialFrameHeader header_;
+        net::frame::FrameBufferReader frame_reader_;
+        uint16_t expected_;
+        nb::de::Bin<uint16_t> crc_{};
+
+      public:
+        inline explicit VerifyCrc(
+            const SerialFrameHeader &header,
+            net::frame::FrameBufferReader &&frame_reader,
+            uint16_t expected
+        )
+            : header_{header},
+              frame_reader_{etl::move(frame_reader)},
+              expected_{expected} {}
+
+        inline const SerialFrameHeader &header() const {
+            return header_;
+        }
+
+        inline net::frame::FrameBufferReader &frame_reader() {
+            return frame_reader_;
+        }
+
+        template <nb::AsyncReadable R>
+        inline nb::Poll<bool> execute(R &readable) {
+            auto result = POLL_UNWRAP_OR_RETURN(crc_.deserialize(readable));
+            return result == nb::DeserializeResult::Ok && crc_.result() == expected_;
+        }
+    };
+
     class DiscardData {
         nb::de::SkipNBytes discarding_;
+        nb::de::SkipNBytes discarding_crc_;
 
       public:
-        inline explicit DiscardData(uint8_t length) : discarding_{length} {}
+        inline explicit DiscardData(uint8_t length, bool with_crc)
+            : discarding_{length},
+              discarding_crc_{with_crc ? CRC_LENGTH : static_cast<uint8_t>(0)} {}
 
         template <nb::AsyncReadable R>
         inline nb::Poll<void> execute(R &reader) {
             POLL_UNWRAP_OR_RETURN(discarding_.deserialize(reader));
+            POLL_UNWRAP_OR_RETURN(discarding_crc_.deserialize(reader));
             return nb::ready();
         }
     };
@@ -62,7 +206,20 @@ namespace media::serial {
         memory::Static<net::link::FrameBroker> &broker_;
         etl::optional<SerialAddress> self_address_;
         etl::optional<SerialAddress> remote_address_;
-        etl::variant<SkipPreamble, AsyncSerialFrameHeaderDeserializer, ReceiveData, DiscardData>
+        FrameFormat format_{FrameFormat::Plain};
+        etl::optional<ArqHeader> arq_header_{};
+        bool remote_uses_crc_{false};
+        bool remote_uses_arq_{false};
+        etl::optional<BaudRateControl> control_{};
+        SerialErrorCounter error_counter_{};
+        uint16_t received_frame_count_{0};
+        etl::variant<
+            MatchPreamble,
+            AsyncArqHeaderDeserializer,
+            AsyncSerialFrameHeaderDeserializer,
+            ReceiveData,
+            VerifyCrc,
+            DiscardData>
             state_{};
 
       public:
@@ -76,6 +233,32 @@ namespace media::serial {
             return remote_address_;
         }
 
+        // リモートからCRC付きのフレームを正しく受信したことがあるか
+        inline bool remote_uses_crc() const {
+            return remote_uses_crc_;
+        }
+
+        // リモートからARQヘッダ付きのフレームを正しく受信したことがあるか
+        inline bool remote_uses_arq() const {
+            return remote_uses_arq_;
+        }
+
+        inline const SerialErrorCounter &error_counter() const {
+            return error_counter_;
+        }
+
+        // 最後まで正しく受信したフレームの数．一周して0に戻る
+        inline uint16_t received_frame_count() const {
+            return received_frame_count_;
+        }
+
+        // 受信した通信速度の制御フレームを取り出す
+        inline etl::optional<BaudRateControl> take_control() {
+            auto control = control_;
+            control_ = etl::nullopt;
+            return control;
+        }
+
       private:
         void update_address_by_received_frame_header(const SerialFrameHeader &header) {
             // 最初に受信したフレームの送信元アドレスをリモートアドレスとする
@@ -95,15 +278,151 @@ namespace media::serial {
             }
         }
 
+        inline bool is_addressed_to_self(const SerialFrameHeader &header) const {
+            return header.destination == *self_address_ && header.source == *remote_address_;
+        }
+
+        inline nb::Poll<void> poll_dispatch(
+            const SerialFrameHeader &header,
+            net::frame::FrameBufferReader &&reader,
+            util::Time &time
+        ) {
+            return broker_->poll_dispatch_received_frame(
+                header.protocol_number, net::link::Address{header.source}, etl::move(reader), time
+            );
+        }
+
+        // CRCのないフレームは，受信しながら上位層に渡す
+        void on_header_received(
+            net::frame::FrameService &fs,
+            const SerialFrameHeader &header,
+            util::Time &time
+        ) {
+            update_address_by_received_frame_header(header);
+
+            if (!is_addressed_to_self(header)) {
+                state_.emplace<DiscardData>(header.length, false);
+            } else if (auto &&poll_writer = fs.request_frame_writer(header.length);
+                       poll_writer.is_pending()) {
+                LOG_INFO(FLASH_STRING("Serial: no writer, discard frame"));
+                state_.emplace<DiscardData>(header.length, false);
+            } else {
+                auto &&writer = poll_writer.unwrap();
+                if (poll_dispatch(header, writer.create_reader(), time).is_ready()) {
+                    state_.emplace<ReceiveData>(header, etl::move(writer), etl::nullopt);
+                } else {
+                    state_.emplace<DiscardData>(header.length, false);
+                }
+            }
+        }
+
+        // CRCのあるフレームは，CRCを照合するまでアドレスを信用せず，上位層にも渡さない
+        void on_header_with_crc_received(
+            net::frame::FrameService &fs,
+            const SerialFrameHeader &header
+        ) {
+            auto &&poll_writer = fs.request_frame_writer(header.length);
+            if (poll_writer.is_pending()) {
+                LOG_INFO(FLASH_STRING("Serial: no writer, discard frame"));
+                state_.emplace<DiscardData>(header.length, true);
+                return;
+            }
+
+            util::Crc16 crc;
+            if (arq_header_.has_value()) {
+                update_crc(crc, *arq_header_);
+            }
+            update_crc(crc, header);
+            state_.emplace<ReceiveData>(header, etl::move(poll_writer.unwrap()), crc);
+        }
+
+        void on_crc_verified(VerifyCrc &state, Arq &arq, util::Time &time) {
+            remote_uses_crc_ = true;
+            received_frame_count_++;
+
+            const auto &header = state.header();
+            update_address_by_received_frame_header(header);
+            if (arq_header_.has_value()) {
+                on_arq_frame_verified(state, arq, time);
+                return;
+            }
+
+            if (!is_addressed_to_self(header)) {
+                return;
+            }
+            if (header.protocol_number == net::frame::ProtocolNumber::NoProtocol) {
+                on_control_frame_received(state.frame_reader());
+                return;
+            }
+            if (poll_dispatch(header, etl::move(state.frame_reader()), time).is_pending()) {
+                LOG_INFO(FLASH_STRING("Serial: broker full, discard frame"));
+            }
+        }
+
+        // 制御フレームはCRCのあるフレームでのみ送られ，上位層には渡さない
+        void on_control_frame_received(net::frame::FrameBufferReader &reader) {
+            AsyncBaudRateControlDeserializer deserializer;
+            auto poll_result = reader.deserialize(deserializer);
+            if (poll_result.is_ready() && poll_result.unwrap() == nb::DeserializeResult::Ok) {
+                control_ = deserializer.result();
+            }
+        }
+
+        // 上位層に渡せなかったデータフレームは確認応答せず，相手に再送させる
+        void on_arq_frame_verified(VerifyCrc &state, Arq &arq, util::Time &time) {
+            remote_uses_arq_ = true;
+            arq.send.on_ack_received(arq_header_->ack, arq_header_->selective_ack);
+
+            const auto &header = state.header();
+            if (!arq_header_->has_data() || !is_addressed_to_self(header)) {
+                return;
+            }
+
+            uint8_t sequence = arq_header_->sequence;
+            arq.receive.request_ack(time);
+            if (arq.receive.is_duplicate(sequence)) {
+                return;
+            }
+
+            if (poll_dispatch(header, etl::move(state.frame_reader()), time).is_ready()) {
+                arq.receive.on_data_accepted(sequence);
+            } else {
+                LOG_INFO(FLASH_STRING("Serial: broker full, wait for retransmission"));
+            }
+        }
+
       public:
         template <nb::AsyncReadable R>
-        void execute(net::frame::FrameService &fs, R &readable, util::Time &time) {
-            if (etl::holds_alternative<SkipPreamble>(state_)) {
-                if (etl::get<SkipPreamble>(state_).deserialize(readable).is_ready()) {
+        void execute(net::frame::FrameService &fs, R &readable, Arq &arq, util::Time &time) {
+            if (etl::holds_alternative<MatchPreamble>(state_)) {
+                auto poll = etl::get<MatchPreamble>(state_).execute(readable, error_counter_);
+                if (poll.is_pending()) {
+                    return;
+                }
+                format_ = poll.unwrap();
+                arq_header_ = etl::nullopt;
+                if (format_ == FrameFormat::Arq) {
+                    state_.emplace<AsyncArqHeaderDeserializer>();
+                } else {
                     state_.emplace<AsyncSerialFrameHeaderDeserializer>();
                 }
             }
 
+            if (etl::holds_alternative<AsyncArqHeaderDeserializer>(state_)) {
+                auto &state = etl::get<AsyncArqHeaderDeserializer>(state_);
+                auto poll_result = state.deserialize(readable);
+                if (poll_result.is_pending()) {
+                    return;
+                }
+                if (poll_result.unwrap() != nb::DeserializeResult::Ok) {
+                    error_counter_.on_header_error();
+                    state_.emplace<MatchPreamble>();
+                    return;
+                }
+                arq_header_ = state.result();
+                state_.emplace<AsyncSerialFrameHeaderDeserializer>();
+            }
+
             if (etl::holds_alternative<AsyncSerialFrameHeaderDeserializer>(state_)) {
                 auto &state = etl::get<AsyncSerialFrameHeaderDeserializer>(state_);
                 auto poll_result = state.deserialize(readable);
@@ -111,42 +430,55 @@ namespace media::serial {
                     return;
                 }
                 if (poll_result.unwrap() != nb::DeserializeResult::Ok) {
-                    state_ = SkipPreamble{};
+                    error_counter_.on_header_error();
+                    state_.emplace<MatchPreamble>();
                     return;
                 }
 
-                const auto &header = state.result();
-                update_address_by_received_frame_header(header);
-
-                if (header.destination != *self_address_ || header.source != *remote_address_) {
-                    state_ = DiscardData{header.length};
-                } else if (auto &&poll_writer = fs.request_frame_writer(header.length);
-                           poll_writer.is_pending()) {
-                    LOG_INFO(FLASH_STRING("Serial: no writer, discard frame"));
-                    state_ = DiscardData{header.length};
+                const auto header = state.result();
+                if (has_crc(format_)) {
+                    on_header_with_crc_received(fs, header);
                 } else {
-                    auto &&writer = poll_writer.unwrap();
-                    auto poll = broker_->poll_dispatch_received_frame(
-                        header.protocol_number, net::link::Address{header.source},
-                        writer.create_reader(), time
-                    );
-                    if (poll.is_ready()) {
-                        state_ = ReceiveData{etl::move(writer)};
-                    } else {
-                        state_ = DiscardData{header.length};
-                    }
+                    on_header_received(fs, header, time);
                 }
             }
 
             if (etl::holds_alternative<ReceiveData>(state_)) {
-                if (etl::get<ReceiveData>(state_).execute(readable).is_ready()) {
-                    state_.emplace<SkipPreamble>();
+                auto &state = etl::get<ReceiveData>(state_);
+                if (state.execute(readable).is_pending()) {
+                    return;
+                }
+
+                if (!state.crc().has_value()) {
+                    received_frame_count_++;
+                    state_.emplace<MatchPreamble>();
+                } else {
+                    auto header = state.header();
+                    auto reader = state.create_reader();
+                    uint16_t crc = state.crc()->value();
+                    state_.emplace<VerifyCrc>(header, etl::move(reader), crc);
+                }
+            }
+
+            if (etl::holds_alternative<VerifyCrc>(state_)) {
+                auto &state = etl::get<VerifyCrc>(state_);
+                auto poll_verified = state.execute(readable);
+                if (poll_verified.is_pending()) {
+                    return;
+                }
+
+                if (poll_verified.unwrap()) {
+                    on_crc_verified(state, arq, time);
+                } else {
+                    LOG_INFO(FLASH_STRING("Serial: CRC mismatch, discard frame"));
+                    error_counter_.on_crc_error();
                 }
+                state_.emplace<MatchPreamble>();
             }
 
             if (etl::holds_alternative<DiscardData>(state_)) {
                 if (etl::get<DiscardData>(state_).execute(readable).is_ready()) {
-                    state_.emplace<SkipPreamble>();
+                    state_.emplace<MatchPreamble>();
                 }
             }
         }
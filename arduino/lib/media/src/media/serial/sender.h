@@ -1,15 +1,22 @@
 #pragma once
 
+#include "./arq.h"
+#include "./baud_rate.h"
 #include "./frame.h"
 #include <nb/serde.h>
 #include <net/frame.h>
 #include <net/link.h>
+#include <util/crc.h>
 
 namespace media::serial {
     class AsyncPreambleSerializer {
+        uint8_t last_preamble_;
         bool done_{false};
 
       public:
+        inline explicit AsyncPreambleSerializer(FrameFormat format)
+            : last_preamble_{last_preamble_of(format)} {}
+
         template <nb::AsyncWritable W>
         inline nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
             if (done_) {
@@ -22,7 +29,7 @@ namespace media::serial {
             }
 
             for (uint8_t i = 0; i < LAST_PREAMBLE_LENGTH; i++) {
-                writable.write_unchecked(LAST_PREAMBLE);
+                writable.write_unchecked(last_preamble_);
             }
 
             done_ = true;
@@ -30,63 +37,251 @@ namespace media::serial {
         }
     };
 
+    // データを書き込みながらCRCを計算し，CRCを付ける場合はデータに続けて書き込む
+    class AsyncPayloadSerializer {
+        net::frame::FrameBufferReader reader_;
+        etl::optional<util::Crc16> crc_;
+        etl::optional<nb::ser::Bin<uint16_t>> crc_serializer_{};
+
+      public:
+        explicit AsyncPayloadSerializer(
+            net::frame::FrameBufferReader &&reader,
+            etl::optional<util::Crc16> crc
+        )
+            : reader_{etl::move(reader)},
+              crc_{crc} {}
+
+        template <nb::AsyncWritable W>
+        nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
+            while (!reader_.is_all_read()) {
+                POLL_UNWRAP_OR_RETURN(reader_.poll_readable(1));
+                SERDE_SERIALIZE_OR_RETURN(writable.poll_writable(1));
+
+                if constexpr (nb::AsyncBulkWritable<W>) {
+                    auto buffer = reader_.readable_buffer();
+                    uint8_t written = writable.write_from(buffer);
+                    if (written == 0) {
+                        return nb::pending;
+                    }
+                    reader_.consume_unchecked(written);
+                    if (crc_.has_value()) {
+                        crc_->update(buffer.first(written));
+                    }
+                } else {
+                    uint8_t byte = reader_.read_unchecked();
+                    writable.write_unchecked(byte);
+                    if (crc_.has_value()) {
+                        crc_->update(byte);
+                    }
+                }
+            }
+
+            if (!crc_.has_value()) {
+                return nb::ser::SerializeResult::Ok;
+            }
+            if (!crc_serializer_.has_value()) {
+                crc_serializer_.emplace(crc_->value());
+            }
+            return crc_serializer_->serialize(writable);
+        }
+    };
+
     class AsyncFrameSerializer {
         AsyncPreambleSerializer preamble_;
+        etl::optional<AsyncArqHeaderSerializer> arq_header_;
         AsyncSerialFrameHeaderSerializer header_;
-        net::frame::AsyncFrameBufferReaderSerializer reader_;
+        AsyncPayloadSerializer payload_;
+
+        static etl::optional<util::Crc16> initial_crc(
+            FrameFormat format,
+            const etl::optional<ArqHeader> &arq_header,
+            const SerialFrameHeader &header
+        ) {
+            if (!has_crc(format)) {
+                return etl::nullopt;
+            }
+            util::Crc16 crc;
+            if (arq_header.has_value()) {
+                update_crc(crc, *arq_header);
+            }
+            update_crc(crc, header);
+            return crc;
+        }
 
-      public:
         explicit AsyncFrameSerializer(
+            FrameFormat format,
+            const etl::optional<ArqHeader> &arq_header,
             const SerialFrameHeader &header,
             net::frame::FrameBufferReader &&reader
         )
-            : header_{header},
-              reader_{etl::move(reader)} {}
+            : preamble_{format},
+              arq_header_{arq_header ? etl::optional{AsyncArqHeaderSerializer{*arq_header}}
+                                     : etl::nullopt},
+              header_{header},
+              payload_{etl::move(reader), initial_crc(format, arq_header, header)} {}
+
+      public:
+        explicit AsyncFrameSerializer(
+            const SerialFrameHeader &header,
+            net::frame::FrameBufferReader &&reader,
+            FrameFormat format
+        )
+            : AsyncFrameSerializer{format, etl::nullopt, header, etl::move(reader)} {
+            FASSERT(format != FrameFormat::Arq);
+        }
+
+        explicit AsyncFrameSerializer(
+            const SerialFrameHeader &header,
+            net::frame::FrameBufferReader &&reader,
+            const ArqHeader &arq_header
+        )
+            : AsyncFrameSerializer{FrameFormat::Arq, arq_header, header, etl::move(reader)} {}
 
         template <nb::AsyncWritable W>
         inline nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
             SERDE_SERIALIZE_OR_RETURN(preamble_.serialize(writable));
+            if (arq_header_.has_value()) {
+                SERDE_SERIALIZE_OR_RETURN(arq_header_->serialize(writable));
+            }
             SERDE_SERIALIZE_OR_RETURN(header_.serialize(writable));
-            return reader_.serialize(writable);
+            return payload_.serialize(writable);
         }
     };
 
     class FrameSender {
         memory::Static<net::link::FrameBroker> &broker_;
         etl::optional<AsyncFrameSerializer> frame_serializer_;
+        etl::optional<uint8_t> sending_sequence_; // 送信中のARQのデータフレームのシーケンス番号
+
+        nb::Poll<net::link::LinkFrame> poll_requested_frame() {
+            while (true) {
+                auto &&frame = POLL_MOVE_UNWRAP_OR_RETURN(
+                    broker_->poll_get_send_requested_frame(net::link::AddressType::Serial)
+                );
+                if (SerialAddress::is_convertible_address(frame.remote)) {
+                    return etl::move(frame);
+                }
+            }
+        }
+
+        static inline SerialFrameHeader
+        make_header(const SerialAddress &self_address, const net::link::LinkFrame &frame) {
+            return SerialFrameHeader{
+                .protocol_number = frame.protocol_number,
+                .source = self_address,
+                .destination = SerialAddress{frame.remote},
+                .length = frame.reader.buffer_length(),
+            };
+        }
+
+        void start_arq_data_frame(ArqOutgoingFrame &&frame, Arq &arq) {
+            auto arq_header = arq.receive.make_header(ARQ_FLAG_DATA, frame.sequence);
+            frame_serializer_.emplace(frame.header, etl::move(frame.reader), arq_header);
+            sending_sequence_ = frame.sequence;
+        }
+
+        // 再送，新しいフレーム，確認応答のみのフレームの順に送る
+        void start_arq_frame(
+            const SerialAddress &self_address,
+            etl::optional<SerialAddress> remote_address,
+            Arq &arq,
+            util::Time &time
+        ) {
+            auto retransmission = arq.send.poll_retransmission(time);
+            if (retransmission.has_value()) {
+                start_arq_data_frame(etl::move(*retransmission), arq);
+                return;
+            }
+
+            if (!arq.send.full()) {
+                auto poll_frame = poll_requested_frame();
+                if (poll_frame.is_ready()) {
+                    auto &frame = poll_frame.unwrap();
+                    auto header = make_header(self_address, frame);
+                    start_arq_data_frame(arq.send.push(header, etl::move(frame.reader)), arq);
+                    return;
+                }
+            }
+
+            if (remote_address.has_value() && arq.receive.poll_ack_due(time)) {
+                SerialFrameHeader header{
+                    .protocol_number = net::frame::ProtocolNumber::NoProtocol,
+                    .source = self_address,
+                    .destination = *remote_address,
+                    .length = 0,
+                };
+                frame_serializer_.emplace(
+                    header, net::frame::FrameBufferWriter::empty().create_reader(),
+                    arq.receive.make_header(0, 0)
+                );
+            }
+        }
 
       public:
         explicit FrameSender(memory::Static<net::link::FrameBroker> &broker) : broker_{broker} {}
 
+        inline bool is_idle() const {
+            return !frame_serializer_.has_value();
+        }
+
+        // 制御フレームは，誤りのある内容で速度を切り替えないようCRC付きで送る
+        bool try_start_control_frame(
+            net::frame::FrameService &fs,
+            const SerialAddress &self_address,
+            const SerialAddress &remote_address,
+            const BaudRateControl &control
+        ) {
+            FASSERT(is_idle());
+            AsyncBaudRateControlSerializer serializer{control};
+            auto poll_writer = fs.request_frame_writer(serializer.serialized_length());
+            if (poll_writer.is_pending()) {
+                return false;
+            }
+
+            auto &writer = poll_writer.unwrap();
+            writer.serialize_all_at_once(serializer);
+            SerialFrameHeader header{
+                .protocol_number = net::frame::ProtocolNumber::NoProtocol,
+                .source = self_address,
+                .destination = remote_address,
+                .length = serializer.serialized_length(),
+            };
+            frame_serializer_.emplace(header, writer.create_reader(), FrameFormat::Crc);
+            return true;
+        }
+
         template <nb::AsyncWritable W>
         inline void execute(
             W &writable,
             SerialAddress &self_address,
-            etl::optional<SerialAddress> remote_address
+            etl::optional<SerialAddress> remote_address,
+            FrameFormat format,
+            Arq &arq,
+            util::Time &time
         ) {
-            while (!frame_serializer_) {
-                auto poll_frame =
-                    broker_->poll_get_send_requested_frame(net::link::AddressType::Serial);
-                if (poll_frame.is_pending()) {
-                    return;
+            if (!frame_serializer_) {
+                if (format == FrameFormat::Arq) {
+                    start_arq_frame(self_address, remote_address, arq, time);
+                } else {
+                    auto poll_frame = poll_requested_frame();
+                    if (poll_frame.is_ready()) {
+                        auto &frame = poll_frame.unwrap();
+                        auto header = make_header(self_address, frame);
+                        frame_serializer_.emplace(header, etl::move(frame.reader), format);
+                    }
                 }
 
-                auto &&frame = poll_frame.unwrap();
-                if (!SerialAddress::is_convertible_address(frame.remote)) {
-                    continue;
+                if (!frame_serializer_) {
+                    return;
                 }
-
-                const auto &header = SerialFrameHeader{
-                    .protocol_number = frame.protocol_number,
-                    .source = self_address,
-                    .destination = SerialAddress{frame.remote},
-                    .length = frame.reader.buffer_length(),
-                };
-                frame_serializer_.emplace(header, etl::move(frame.reader));
             }
 
             if (frame_serializer_->serialize(writable).is_ready()) {
                 frame_serializer_.reset();
+                if (sending_sequence_.has_value()) {
+                    arq.send.on_sent(*sending_sequence_, time);
+                    sending_sequence_ = etl::nullopt;
+                }
             }
         }
     };
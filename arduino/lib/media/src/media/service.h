@@ -71,6 +71,18 @@ namespace media {
             }
         }
 
+        // キャリアセンスを行う全てのポートの合計
+        net::link::ChannelStatistics get_channel_statistics() const {
+            net::link::ChannelStatistics statistics{};
+            for (const MediaPortType &port : ports_) {
+                auto opt_statistics = port.get_channel_statistics();
+                if (opt_statistics.has_value()) {
+                    statistics += *opt_statistics;
+                }
+            }
+            return statistics;
+        }
+
         inline etl::optional<net::link::Address> get_broadcast_address(net::link::AddressType type
         ) const {
             for (const MediaPortType &port : ports_) {
@@ -3,8 +3,25 @@
 #include "../../address/modem_id.h"
 #include <net/frame.h>
 #include <net/link.h>
+#include <tl/vec.h>
 
 namespace media::uhf {
+    // @DTコマンドで送れるデータ長の上限
+    constexpr uint8_t MAX_DATA_LENGTH = 0xFF;
+
+    // # 集約フレームのデータ部
+    //
+    // 1. 上位プロトコルの代わりに`AGGREGATED_FRAME_MARKER`(1byte)
+    // 2. サブフレームの列．各サブフレームは次の通り
+    //    1. 上位プロトコル(1byte)
+    //    2. データ長(1byte)
+    //    3. データ
+    constexpr uint8_t AGGREGATED_FRAME_MARKER = 0xFF;
+    constexpr uint8_t AGGREGATED_FRAME_MARKER_LENGTH = 1;
+    constexpr uint8_t SUB_FRAME_HEADER_LENGTH = net::frame::PROTOCOL_SIZE + 1;
+    constexpr uint8_t MAX_AGGREGATED_FRAMES = 8;
+    static_assert(!net::frame::is_valid_protocol_number(AGGREGATED_FRAME_MARKER));
+
     struct UhfFrame {
         net::frame::ProtocolNumber protocol_number;
         ModemId remote;
@@ -26,4 +43,70 @@ namespace media::uhf {
             };
         }
     };
+
+    /**
+     * 1回の@DTコマンドで送るフレームの集まり．
+     * 宛先が同じで，集約したデータ部が`MAX_DATA_LENGTH`に収まるフレームだけをまとめる．
+     */
+    class UhfFrameBatch {
+        tl::Vec<UhfFrame, MAX_AGGREGATED_FRAMES> frames_{};
+
+        // 集約した場合のデータ部の長さ
+        uint16_t aggregated_data_length() const {
+            uint16_t length = AGGREGATED_FRAME_MARKER_LENGTH;
+            for (const auto &frame : frames_) {
+                length += SUB_FRAME_HEADER_LENGTH + frame.reader.origin_length();
+            }
+            return length;
+        }
+
+        UhfFrameBatch() = default;
+
+      public:
+        explicit UhfFrameBatch(UhfFrame &&frame) {
+            frames_.push_back(etl::move(frame));
+        }
+
+        inline const ModemId &remote() const {
+            return frames_.front().remote;
+        }
+
+        inline bool is_aggregated() const {
+            return frames_.size() > 1;
+        }
+
+        // @DTコマンドのデータ長
+        inline uint8_t data_length() const {
+            if (is_aggregated()) {
+                return static_cast<uint8_t>(aggregated_data_length());
+            }
+            return frames_.front().reader.origin_length() + net::frame::PROTOCOL_SIZE;
+        }
+
+        bool can_append(const UhfFrame &frame) const {
+            if (frames_.full() || frame.remote != remote()) {
+                return false;
+            }
+            uint16_t length =
+                aggregated_data_length() + SUB_FRAME_HEADER_LENGTH + frame.reader.origin_length();
+            return length <= MAX_DATA_LENGTH;
+        }
+
+        inline void append(UhfFrame &&frame) {
+            FASSERT(can_append(frame));
+            frames_.push_back(etl::move(frame));
+        }
+
+        UhfFrameBatch clone() const {
+            UhfFrameBatch batch;
+            for (const auto &frame : frames_) {
+                batch.frames_.push_back(frame.clone());
+            }
+            return batch;
+        }
+
+        inline tl::Vec<UhfFrame, MAX_AGGREGATED_FRAMES> &&take_frames() && {
+            return etl::move(frames_);
+        }
+    };
 } // namespace media::uhf
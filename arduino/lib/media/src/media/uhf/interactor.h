@@ -20,9 +20,18 @@ namespace media::uhf {
         UhfInteractor &operator=(const UhfInteractor &) = delete;
         UhfInteractor &operator=(UhfInteractor &&) = delete;
 
-        inline UhfInteractor(RW &rw, memory::Static<net::link::FrameBroker> &broker)
+        /**
+         * @param enable_aggregation 宛先が同じ小さなフレームを1回の@DTコマンドにまとめるか．
+         * 集約フレームを解釈できない相手は受信できなくなるため，
+         * 通信する全てのノードが対応している場合のみ有効にする
+         */
+        inline UhfInteractor(
+            RW &rw,
+            memory::Static<net::link::FrameBroker> &broker,
+            bool enable_aggregation = false
+        )
             : rw_{etl::ref(rw)},
-              executor_{broker} {}
+              executor_{broker, enable_aggregation} {}
 
         inline constexpr net::link::AddressTypeSet supported_address_types() const {
             return net::link::AddressTypeSet{net::link::AddressType::UHF};
@@ -39,6 +48,10 @@ namespace media::uhf {
             };
         }
 
+        inline net::link::ChannelStatistics get_channel_statistics() const {
+            return executor_.carrier_sense_backoff().statistics();
+        }
+
         void execute(net::frame::FrameService &frame_service, util::Time &time, util::Rand &rand) {
             if (initializer_.has_value()) {
                 auto poll_self_id = initializer_->execute(frame_service, executor_, time, rand);
@@ -8,11 +8,16 @@
 #include "./task/set_equipment_id.h"
 
 namespace media::uhf {
+    // モデムが応答しない場合に備えたタイムアウト．キャリアセンス前のバックオフ中は数えない
     static constexpr auto TASK_TIMEOUT = util::Duration::from_seconds(5);
 
+    // バックオフを含めてタスクにかけられる時間の上限．混雑したチャネルでも有限時間で諦める
+    static constexpr auto TASK_DEADLINE = util::Duration::from_seconds(20);
+
     template <nb::AsyncReadableWritable RW>
     class InterruptibleTask {
         etl::optional<nb::Delay> timeout_;
+        etl::optional<nb::Delay> deadline_;
         etl::variant<
             etl::monostate,
             SendDataTask<RW>,
@@ -25,12 +30,20 @@ namespace media::uhf {
         inline void clear() {
             task_.template emplace<etl::monostate>();
             timeout_.reset();
+            deadline_.reset();
         }
 
         inline void clear_if_timeout(util::Time &time) {
             if (timeout_.has_value() && timeout_->poll(time).is_ready()) {
                 LOG_INFO(FLASH_STRING("UHF task timeout: "), task_.index());
                 clear();
+                return;
+            }
+
+            // 受信による中断中も数えるため，`timeout_`とは異なりresumeで再設定しない
+            if (deadline_.has_value() && deadline_->poll(time).is_ready()) {
+                LOG_INFO(FLASH_STRING("UHF task deadline exceeded: "), task_.index());
+                clear();
             }
         }
 
@@ -64,13 +77,14 @@ namespace media::uhf {
             nb::Lock<etl::reference_wrapper<RW>> &rw,
             net::link::FrameBroker &broker,
             util::Time &time,
-            util::Rand &rand
+            util::Rand &rand,
+            CarrierSenseBackoff &backoff
         ) {
             nb::Poll<void> poll = etl::visit(
                 util::Visitor{
                     [&](etl::monostate &) -> nb::Poll<void> { return nb::pending; },
                     [&](ReceiveDataTask<RW> &task) { return task.execute(fs, broker, time); },
-                    [&](SendDataTask<RW> &task) { return task.execute(rw, time, rand); },
+                    [&](SendDataTask<RW> &task) { return task.execute(rw, time, rand, backoff); },
                     [&](GetSerialNumberTask<RW> &task) { return task.execute(rw); },
                     [&](SetEquipmentIdTask<RW> &task) { return task.execute(rw); },
                     [&](IncludeRouteInformationTask<RW> &task) { return task.execute(rw); },
@@ -79,6 +93,20 @@ namespace media::uhf {
             );
             if (poll.is_ready()) {
                 clear();
+                return;
+            }
+
+            // 混雑したチャネルではバックオフが長くなり，再試行の途中でタイムアウトしてしまうため，
+            // バックオフ中はタイムアウトを延ばす．バックオフの合計は`deadline_`で制限する
+            bool is_backing_off = etl::visit(
+                util::Visitor{
+                    [](const SendDataTask<RW> &task) { return task.is_backing_off(); },
+                    [](const auto &) { return false; },
+                },
+                task_
+            );
+            if (is_backing_off) {
+                timeout_.emplace(time, TASK_TIMEOUT);
             }
         }
 
@@ -89,6 +117,7 @@ namespace media::uhf {
             FASSERT(poll_task_addable().is_ready());
             task_.template emplace<T>(etl::forward<Args>(args)...);
             timeout_.emplace(time, TASK_TIMEOUT);
+            deadline_.emplace(time, TASK_DEADLINE);
         }
 
         template <typename F>
@@ -162,14 +191,71 @@ namespace media::uhf {
         memory::Static<net::link::FrameBroker> &broker_;
         InterruptibleTask<RW> interruptible_task_{};
         etl::optional<ExclusiveTask<RW>> exclusive_task_{};
+        etl::optional<UhfFrame> pending_frame_{}; // 前回の集約に入らなかったフレーム
+        CarrierSenseBackoff backoff_{};
+        bool enable_aggregation_;
+
+        nb::Poll<UhfFrame> poll_send_frame() {
+            if (pending_frame_.has_value()) {
+                UhfFrame frame = etl::move(*pending_frame_);
+                pending_frame_.reset();
+                return etl::move(frame);
+            }
+
+            while (true) {
+                auto &&poll_frame =
+                    broker_->poll_get_send_requested_frame(net::link::AddressType::UHF);
+                if (poll_frame.is_pending()) {
+                    return nb::pending;
+                }
+
+                auto &&frame = poll_frame.unwrap();
+                if (ModemId::is_convertible_address(frame.remote)) {
+                    return UhfFrame::from_link_frame(etl::move(frame));
+                }
+            }
+        }
+
+        // 同じ宛先へのフレームを，1回の@DTコマンドに収まるだけまとめる
+        nb::Poll<UhfFrameBatch> poll_send_batch() {
+            auto &&poll_frame = poll_send_frame();
+            if (poll_frame.is_pending()) {
+                return nb::pending;
+            }
+
+            UhfFrameBatch batch{etl::move(poll_frame.unwrap())};
+            while (enable_aggregation_) {
+                auto &&poll_next = poll_send_frame();
+                if (poll_next.is_pending()) {
+                    break;
+                }
+
+                auto &&next = poll_next.unwrap();
+                if (!batch.can_append(next)) {
+                    pending_frame_.emplace(etl::move(next));
+                    break;
+                }
+                batch.append(etl::move(next));
+            }
+            return etl::move(batch);
+        }
 
       public:
-        TaskExecutor(memory::Static<net::link::FrameBroker> &broker) : broker_{broker} {}
+        explicit TaskExecutor(
+            memory::Static<net::link::FrameBroker> &broker,
+            bool enable_aggregation = false
+        )
+            : broker_{broker},
+              enable_aggregation_{enable_aggregation} {}
 
         inline nb::Poll<void> poll_task_addable() {
             return interruptible_task_.poll_task_addable();
         }
 
+        inline const CarrierSenseBackoff &carrier_sense_backoff() const {
+            return backoff_;
+        }
+
         template <typename T, typename... Args>
         inline void emplace(util::Time &time, Args &&...args) {
             return interruptible_task_.template emplace<T, Args...>(
@@ -194,24 +280,16 @@ namespace media::uhf {
             }
 
             interruptible_task_.clear_if_timeout(time);
-            while (interruptible_task_.poll_task_addable().is_ready()) {
-                auto &&poll_frame =
-                    broker_->poll_get_send_requested_frame(net::link::AddressType::UHF);
-                if (poll_frame.is_pending()) {
-                    break;
+            if (interruptible_task_.poll_task_addable().is_ready()) {
+                auto &&poll_batch = poll_send_batch();
+                if (poll_batch.is_ready()) {
+                    interruptible_task_.template emplace<SendDataTask<RW>>(
+                        time, etl::move(poll_batch.unwrap())
+                    );
                 }
-
-                auto &&frame = poll_frame.unwrap();
-                if (!ModemId::is_convertible_address(frame.remote)) {
-                    continue;
-                }
-
-                interruptible_task_.template emplace<SendDataTask<RW>>(
-                    time, UhfFrame::from_link_frame(etl::move(frame)), time, rand
-                );
             }
 
-            interruptible_task_.execute(fs, rw, *broker_, time, rand);
+            interruptible_task_.execute(fs, rw, *broker_, time, rand, backoff_);
         }
 
         void handle_response(util::Time &time, UhfResponse<RW> &&res) {
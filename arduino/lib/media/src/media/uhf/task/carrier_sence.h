@@ -2,9 +2,11 @@
 
 #include "../response.h"
 #include "./fixed.h"
+#include <etl/algorithm.h>
 #include <nb/serde.h>
 #include <nb/time.h>
 #include <net/frame.h>
+#include <net/link.h>
 
 namespace media::uhf {
     enum class CarrierSenseResult : uint8_t {
@@ -12,31 +14,73 @@ namespace media::uhf {
         Error,
     };
 
-    template <nb::AsyncReadableWritable RW>
-    class CarrierSenseTask {
-        // 300byte(256byteデータ+適当な制御用byte) / 4.8kbps = 62.5ms
-        // 62.5msの前後でランダムにバックオフする
-        static constexpr util::TimeInt BACKOFF_RANGE_MS = 100;
-        static constexpr util::TimeInt BACKOFF_OFFSET_MS = 50;
+    // バックオフ時間を選ぶ範囲(ms)の下限，初期値，上限
+    constexpr uint16_t MIN_CONTENTION_WINDOW_MS = 25;
+    constexpr uint16_t INITIAL_CONTENTION_WINDOW_MS = 100;
+    constexpr uint16_t MAX_CONTENTION_WINDOW_MS = 1600;
+
+    /**
+     * チャネルの混雑具合に合わせて，キャリアセンス前のバックオフ時間の範囲を調整する．
+     *
+     * チャネルが使用中だった場合や送信に失敗した場合は範囲を倍に広げ，
+     * チャネルが空いていた場合は半分に狭める．
+     */
+    class CarrierSenseBackoff {
+        uint16_t contention_window_ms_{INITIAL_CONTENTION_WINDOW_MS};
+        net::link::ChannelStatistics statistics_{};
+
+        inline void widen() {
+            contention_window_ms_ = etl::min<uint16_t>(
+                contention_window_ms_ * 2, MAX_CONTENTION_WINDOW_MS
+            );
+        }
 
-        struct Backoff {
-            nb::Delay delay_;
+        inline void narrow() {
+            contention_window_ms_ = etl::max<uint16_t>(
+                contention_window_ms_ / 2, MIN_CONTENTION_WINDOW_MS
+            );
+        }
 
-          private:
-            explicit Backoff(util::Time &time, util::Rand &rand, util::TimeInt offset_ms)
-                : delay_{([&]() -> nb::Delay {
-                      auto backoff = rand.gen_uint8_t(offset_ms, BACKOFF_RANGE_MS + offset_ms);
-                      return nb::Delay{time, util::Duration::from_millis(backoff)};
-                  })()} {}
+      public:
+        inline uint16_t contention_window_ms() const {
+            return contention_window_ms_;
+        }
 
-          public:
-            static Backoff WithoutOffset(util::Time &time, util::Rand &rand) {
-                return Backoff{time, rand, 0};
-            }
+        inline const net::link::ChannelStatistics &statistics() const {
+            return statistics_;
+        }
 
-            static Backoff WithOffset(util::Time &time, util::Rand &rand) {
-                return Backoff{time, rand, BACKOFF_OFFSET_MS};
-            }
+        inline util::Duration initial_backoff(util::Rand &rand) const {
+            return util::Duration::from_millis(rand.gen_uint16_t(0, contention_window_ms_));
+        }
+
+        // 直前にチャネルが使用中だったため，範囲の後半から選ぶ
+        inline util::Duration retry_backoff(util::Rand &rand) const {
+            uint16_t min = contention_window_ms_ / 2;
+            return util::Duration::from_millis(rand.gen_uint16_t(min, contention_window_ms_));
+        }
+
+        inline void on_channel_idle() {
+            statistics_.carrier_sense_count++;
+            narrow();
+        }
+
+        inline void on_channel_busy() {
+            statistics_.carrier_sense_count++;
+            statistics_.busy_count++;
+            widen();
+        }
+
+        // キャリアセンスの応答が得られなかった場合や，送信したデータが届かなかった場合
+        inline void on_failure() {
+            widen();
+        }
+    };
+
+    template <nb::AsyncReadableWritable RW>
+    class CarrierSenseTask {
+        struct Backoff {
+            nb::Delay delay_;
         };
 
         static inline constexpr uint8_t MAX_RETRY_COUNT = 15;
@@ -48,26 +92,36 @@ namespace media::uhf {
         uint8_t remaining_retry_count_{MAX_RETRY_COUNT};
         etl::variant<SendCommand, Backoff> state_{SendCommand{CS_COMMAND}};
 
-        nb::Poll<CarrierSenseResult> backoff(util::Time &time, util::Rand &rand) {
+        nb::Poll<CarrierSenseResult>
+        retry(util::Time &time, util::Rand &rand, const CarrierSenseBackoff &backoff) {
             if (remaining_retry_count_ == 0) {
                 return CarrierSenseResult::Error;
             }
 
             remaining_retry_count_--;
-            state_.template emplace<Backoff>(Backoff::WithOffset(time, rand));
+            state_.template emplace<Backoff>(nb::Delay{time, backoff.retry_backoff(rand)});
             return nb::pending;
         }
 
       public:
-        constexpr CarrierSenseTask(util::Time &time, util::Rand &rand)
+        CarrierSenseTask(util::Time &time, util::Rand &rand, const CarrierSenseBackoff &backoff)
             // ブロードキャストされたフレームを中継する際，
             // 複数のノードの送信タイミングがぴったりになっている場合がよくあり，
             // CS=ENを得た場合でも，すぐに送信を開始すると衝突する可能性がある．
             // そのため，最初にランダムなバックオフを行う．
-            : state_{Backoff::WithoutOffset(time, rand)} {}
+            : state_{Backoff{nb::Delay{time, backoff.initial_backoff(rand)}}} {}
 
-        nb::Poll<CarrierSenseResult>
-        execute(nb::Lock<etl::reference_wrapper<RW>> &rw, util::Time &time, util::Rand &rand) {
+        // キャリアセンスの前に待機しているか
+        inline bool is_backing_off() const {
+            return etl::holds_alternative<Backoff>(state_);
+        }
+
+        nb::Poll<CarrierSenseResult> execute(
+            nb::Lock<etl::reference_wrapper<RW>> &rw,
+            util::Time &time,
+            util::Rand &rand,
+            CarrierSenseBackoff &backoff
+        ) {
             if (etl::holds_alternative<Backoff>(state_)) {
                 POLL_UNWRAP_OR_RETURN(etl::get<Backoff>(state_).delay_.poll(time));
                 state_.template emplace<SendCommand>(CS_COMMAND);
@@ -76,13 +130,16 @@ namespace media::uhf {
             if (etl::holds_alternative<SendCommand>(state_)) {
                 auto &state = etl::get<SendCommand>(state_);
                 if (POLL_UNWRAP_OR_RETURN(state.execute(rw)) != FixedTaskResult::Ok) {
-                    return backoff(time, rand);
+                    backoff.on_failure();
+                    return retry(time, rand, backoff);
                 }
 
                 if (state.result() != "EN") {
-                    return backoff(time, rand);
+                    backoff.on_channel_busy();
+                    return retry(time, rand, backoff);
                 }
 
+                backoff.on_channel_idle();
                 return CarrierSenseResult::Ok;
             }
 
@@ -6,12 +6,18 @@
 #include <net/frame.h>
 #include <net/link.h>
 #include <stdint.h>
+#include <tl/vec.h>
 
 namespace media::uhf {
     struct DRParameter {
         uint8_t length;
-        net::frame::ProtocolNumber protocol;
+        etl::optional<net::frame::ProtocolNumber> protocol; // 集約フレームの場合は無効
+
+        inline bool is_aggregated() const {
+            return !protocol.has_value();
+        }
 
+        // 上位プロトコル，または集約フレームのマーカーを除いた長さ
         inline uint8_t payload_length() const {
             return length - net::frame::PROTOCOL_SIZE;
         }
@@ -19,24 +25,144 @@ namespace media::uhf {
 
     class AsyncDRParameterDeserializer {
         nb::de::Hex<uint8_t> length_;
-        net::frame::AsyncProtocolNumberDeserializer protocol_;
+        nb::de::Bin<uint8_t> protocol_;
 
       public:
         template <nb::AsyncReadable R>
         nb::Poll<nb::de::DeserializeResult> deserialize(R &readable) {
             SERDE_DESERIALIZE_OR_RETURN(length_.deserialize(readable));
             SERDE_DESERIALIZE_OR_RETURN(protocol_.deserialize(readable));
-            return nb::de::DeserializeResult::Ok;
+            if (length_.result() < net::frame::PROTOCOL_SIZE) {
+                return nb::de::DeserializeResult::Invalid;
+            }
+
+            uint8_t protocol = protocol_.result();
+            return net::frame::is_valid_protocol_number(protocol) ||
+                    protocol == AGGREGATED_FRAME_MARKER
+                ? nb::de::DeserializeResult::Ok
+                : nb::de::DeserializeResult::Invalid;
         }
 
         inline DRParameter result() const {
             return DRParameter{
                 .length = length_.result(),
-                .protocol = protocol_.result(),
+                .protocol = net::frame::byte_to_protocol_number(protocol_.result()),
             };
         }
     };
 
+    struct ReceivedFrame {
+        net::frame::ProtocolNumber protocol;
+        net::frame::FrameBufferReader reader;
+    };
+
+    using ReceivedFrames = tl::Vec<ReceivedFrame, MAX_AGGREGATED_FRAMES>;
+
+    struct SubFrameHeader {
+        uint8_t protocol;
+        uint8_t length;
+    };
+
+    class AsyncSubFrameHeaderDeserializer {
+        nb::de::Bin<uint8_t> protocol_;
+        nb::de::Bin<uint8_t> length_;
+
+      public:
+        template <nb::AsyncReadable R>
+        nb::Poll<nb::de::DeserializeResult> deserialize(R &readable) {
+            SERDE_DESERIALIZE_OR_RETURN(protocol_.deserialize(readable));
+            return length_.deserialize(readable);
+        }
+
+        inline SubFrameHeader result() const {
+            return SubFrameHeader{.protocol = protocol_.result(), .length = length_.result()};
+        }
+    };
+
+    /**
+     * 集約フレームのデータ部を読み，サブフレームごとにフレームバッファへ書き込む．
+     *
+     * バッファを確保できなかったサブフレームは読み捨てる．
+     * 不正なサブフレームを読んだ場合は，データ部の残りを全て読み捨てる．
+     */
+    class ReceiveSubFrames {
+        uint8_t remaining_;
+        etl::variant<
+            AsyncSubFrameHeaderDeserializer,
+            net::frame::AsyncFrameBufferWriterDeserializer,
+            nb::de::SkipNBytes>
+            state_{};
+
+        void on_header_received(
+            const SubFrameHeader &header,
+            net::frame::FrameService &fs,
+            ReceivedFrames &frames
+        ) {
+            if (header.length > remaining_ ||
+                !net::frame::is_valid_protocol_number(header.protocol)) {
+                LOG_INFO(FLASH_STRING("Uhf: invalid sub frame"));
+                state_.emplace<nb::de::SkipNBytes>(remaining_);
+                remaining_ = 0;
+                return;
+            }
+
+            remaining_ -= header.length;
+            if (frames.full()) {
+                state_.emplace<nb::de::SkipNBytes>(header.length);
+                return;
+            }
+
+            auto poll_writer = fs.request_frame_writer(header.length);
+            if (poll_writer.is_pending()) {
+                LOG_INFO(FLASH_STRING("Uhf: no writer, discard sub frame"));
+                state_.emplace<nb::de::SkipNBytes>(header.length);
+                return;
+            }
+
+            auto &writer = poll_writer.unwrap();
+            frames.push_back(ReceivedFrame{
+                .protocol = static_cast<net::frame::ProtocolNumber>(header.protocol),
+                .reader = writer.create_reader(),
+            });
+            state_.emplace<net::frame::AsyncFrameBufferWriterDeserializer>(etl::move(writer));
+        }
+
+      public:
+        explicit ReceiveSubFrames(uint8_t payload_length) : remaining_{payload_length} {}
+
+        template <nb::AsyncReadable R>
+        nb::Poll<nb::de::DeserializeResult>
+        deserialize(R &readable, net::frame::FrameService &fs, ReceivedFrames &frames) {
+            while (true) {
+                if (etl::holds_alternative<AsyncSubFrameHeaderDeserializer>(state_)) {
+                    if (remaining_ == 0) {
+                        return nb::de::DeserializeResult::Ok;
+                    }
+                    if (remaining_ < SUB_FRAME_HEADER_LENGTH) {
+                        state_.emplace<nb::de::SkipNBytes>(remaining_);
+                        remaining_ = 0;
+                        continue;
+                    }
+
+                    auto &state = etl::get<AsyncSubFrameHeaderDeserializer>(state_);
+                    SERDE_DESERIALIZE_OR_RETURN(state.deserialize(readable));
+                    remaining_ -= SUB_FRAME_HEADER_LENGTH;
+                    on_header_received(state.result(), fs, frames);
+                }
+
+                if (etl::holds_alternative<net::frame::AsyncFrameBufferWriterDeserializer>(state_)
+                ) {
+                    auto &state = etl::get<net::frame::AsyncFrameBufferWriterDeserializer>(state_);
+                    SERDE_DESERIALIZE_OR_RETURN(state.deserialize(readable));
+                } else if (etl::holds_alternative<nb::de::SkipNBytes>(state_)) {
+                    auto &state = etl::get<nb::de::SkipNBytes>(state_);
+                    SERDE_DESERIALIZE_OR_RETURN(state.deserialize(readable));
+                }
+                state_.emplace<AsyncSubFrameHeaderDeserializer>();
+            }
+        }
+    };
+
     class AsyncDRTrailerDeserializer {
         nb::de::SkipNBytes route_prefix_{2};
         AsyncModemIdDeserializer source_;
@@ -82,16 +208,12 @@ namespace media::uhf {
         etl::variant<
             AsyncDRParameterDeserializer,
             net::frame::AsyncFrameBufferWriterDeserializer,
+            ReceiveSubFrames,
             AsyncDRTrailerDeserializer,
             DiscardFrame>
             state_{};
 
-        struct ReceivedFrame {
-            net::frame::ProtocolNumber protocol;
-            net::frame::FrameBufferReader reader;
-        };
-
-        tl::Optional<ReceivedFrame> frame_;
+        ReceivedFrames frames_{};
 
       public:
         ReceiveDataTask(const ReceiveDataTask &) = delete;
@@ -114,15 +236,24 @@ namespace media::uhf {
                     };
                 }
 
-                const auto &param = state.result();
-                auto &&poll_writer = fs.request_frame_writer(param.payload_length());
-                if (poll_writer.is_pending()) {
-                    LOG_INFO(FLASH_STRING("Uhf: no writer, discard frame"));
-                    state_.emplace<DiscardFrame>(param);
+                const auto param = state.result();
+                if (param.is_aggregated()) {
+                    state_.emplace<ReceiveSubFrames>(param.payload_length());
                 } else {
-                    auto &&w = poll_writer.unwrap();
-                    frame_.emplace(param.protocol, w.create_reader());
-                    state_.emplace<net::frame::AsyncFrameBufferWriterDeserializer>(etl::move(w));
+                    auto &&poll_writer = fs.request_frame_writer(param.payload_length());
+                    if (poll_writer.is_pending()) {
+                        LOG_INFO(FLASH_STRING("Uhf: no writer, discard frame"));
+                        state_.emplace<DiscardFrame>(param);
+                    } else {
+                        auto &&w = poll_writer.unwrap();
+                        frames_.push_back(ReceivedFrame{
+                            .protocol = *param.protocol,
+                            .reader = w.create_reader(),
+                        });
+                        state_.emplace<net::frame::AsyncFrameBufferWriterDeserializer>(
+                            etl::move(w)
+                        );
+                    }
                 }
             }
 
@@ -136,6 +267,17 @@ namespace media::uhf {
                 state_.emplace<AsyncDRTrailerDeserializer>();
             }
 
+            if (etl::holds_alternative<ReceiveSubFrames>(state_)) {
+                auto &state = etl::get<ReceiveSubFrames>(state_);
+                auto result = POLL_UNWRAP_OR_RETURN(state.deserialize(rw, fs, frames_));
+                if (result != nb::de::DeserializeResult::Ok) {
+                    return etl::expected<void, ReceiveDataAborted<R>>{
+                        etl::unexpected<ReceiveDataAborted<R>>{ReceiveDataAborted{etl::move(rw_)}}
+                    };
+                }
+                state_.emplace<AsyncDRTrailerDeserializer>();
+            }
+
             if (etl::holds_alternative<AsyncDRTrailerDeserializer>(state_)) {
                 auto &state = etl::get<AsyncDRTrailerDeserializer>(state_);
                 if (POLL_UNWRAP_OR_RETURN(state.deserialize(rw)) != nb::de::DeserializeResult::Ok) {
@@ -145,10 +287,11 @@ namespace media::uhf {
                 }
 
                 auto source_id = state.result();
-                auto &frame = frame_.value();
-                broker.poll_dispatch_received_frame(
-                    frame.protocol, net::link::Address(source_id), etl::move(frame.reader), time
-                );
+                for (auto &frame : frames_) {
+                    broker.poll_dispatch_received_frame(
+                        frame.protocol, net::link::Address(source_id), etl::move(frame.reader), time
+                    );
+                }
 
                 return etl::expected<void, ReceiveDataAborted<R>>{};
             }
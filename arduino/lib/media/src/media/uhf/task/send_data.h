@@ -10,39 +10,89 @@
 #include <net/frame.h>
 
 namespace media::uhf {
+    class AsyncSubFrameSerializer {
+        net::frame::AsyncProtocolNumberSerializer protocol_;
+        etl::optional<nb::ser::Bin<uint8_t>> length_; // 集約しない場合は書き込まない
+        net::frame::AsyncFrameBufferReaderSerializer payload_;
+
+      public:
+        explicit AsyncSubFrameSerializer(UhfFrame &&frame, bool aggregated)
+            : protocol_{frame.protocol_number},
+              length_{
+                  aggregated ? etl::optional{nb::ser::Bin<uint8_t>{frame.reader.origin_length()}}
+                             : etl::nullopt
+              },
+              payload_{frame.reader.origin()} {}
+
+        template <nb::AsyncWritable W>
+        inline nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
+            SERDE_SERIALIZE_OR_RETURN(protocol_.serialize(writable));
+            if (length_.has_value()) {
+                SERDE_SERIALIZE_OR_RETURN(length_->serialize(writable));
+            }
+            return payload_.serialize(writable);
+        }
+    };
+
+    // フレームが1つであれば上位プロトコルとデータを，複数であれば集約フレームを書き込む
+    class AsyncDataBodySerializer {
+        using MarkerSerializer = nb::ser::Bin<uint8_t>;
+
+        etl::optional<MarkerSerializer> marker_;
+        tl::Vec<UhfFrame, MAX_AGGREGATED_FRAMES> frames_;
+        uint8_t index_{0};
+        etl::optional<AsyncSubFrameSerializer> sub_frame_{};
+
+      public:
+        explicit AsyncDataBodySerializer(UhfFrameBatch &&batch)
+            : marker_{
+                  batch.is_aggregated() ? etl::optional{MarkerSerializer{AGGREGATED_FRAME_MARKER}}
+                                        : etl::nullopt
+              },
+              frames_{etl::move(batch).take_frames()} {}
+
+        template <nb::AsyncWritable W>
+        nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
+            if (marker_.has_value()) {
+                SERDE_SERIALIZE_OR_RETURN(marker_->serialize(writable));
+            }
+
+            while (true) {
+                if (!sub_frame_.has_value()) {
+                    if (index_ == frames_.size()) {
+                        return nb::ser::SerializeResult::Ok;
+                    }
+                    sub_frame_.emplace(etl::move(frames_[index_++]), marker_.has_value());
+                }
+                SERDE_SERIALIZE_OR_RETURN(sub_frame_->serialize(writable));
+                sub_frame_.reset();
+            }
+        }
+    };
+
     class AsyncSendDataCommandSerializer {
         nb::ser::AsyncStaticSpanSerializer prefix_{"@DT"};
         nb::ser::Hex<uint8_t> length_;
-        net::frame::AsyncProtocolNumberSerializer protocol_;
-        net::frame::AsyncFrameBufferReaderSerializer payload_;
         nb::ser::AsyncStaticSpanSerializer route_prefix_{"/R"};
         AsyncModemIdSerializer destination_;
         nb::ser::AsyncStaticSpanSerializer suffix_{"\r\n"};
+        AsyncDataBodySerializer body_; // `batch`をムーブするため，最後に初期化する
 
       public:
-        explicit AsyncSendDataCommandSerializer(UhfFrame &&frame)
-            : length_{static_cast<uint8_t>(frame.reader.origin_length() + net::frame::PROTOCOL_SIZE)},
-              protocol_{frame.protocol_number},
-              payload_{frame.reader.origin()},
-              destination_{frame.remote} {}
+        explicit AsyncSendDataCommandSerializer(UhfFrameBatch &&batch)
+            : length_{batch.data_length()},
+              destination_{batch.remote()},
+              body_{etl::move(batch)} {}
 
         template <nb::AsyncWritable W>
         inline nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
             POLL_UNWRAP_OR_RETURN(prefix_.serialize(writable));
             POLL_UNWRAP_OR_RETURN(length_.serialize(writable));
-            POLL_UNWRAP_OR_RETURN(protocol_.serialize(writable));
-            POLL_UNWRAP_OR_RETURN(payload_.serialize(writable));
+            POLL_UNWRAP_OR_RETURN(body_.serialize(writable));
             POLL_UNWRAP_OR_RETURN(route_prefix_.serialize(writable));
             POLL_UNWRAP_OR_RETURN(destination_.serialize(writable));
             return suffix_.serialize(writable);
         }
-
-        uint8_t serialized_length() const {
-            return prefix_.serialized_length() + length_.serialized_length() +
-                protocol_.serialized_length() + payload_.serialized_length() +
-                route_prefix_.serialized_length() + destination_.serialized_length() +
-                suffix_.serialized_length();
-        }
     };
 
     enum class InformationResponseResult : uint8_t {
@@ -114,26 +164,28 @@ namespace media::uhf {
         using SendData = FixedTask<RW, AsyncSendDataCommandSerializer, UhfResponseType::DT, 2>;
         static constexpr auto MAX_RETRY_COUNT = 10;
 
-        UhfFrame frame_;
+        UhfFrameBatch batch_;
         uint8_t remaining_retry_count_{MAX_RETRY_COUNT};
         etl::variant<Initial, CarrierSenseTask<RW>, SendData, ReceiveInformationResponseTask<RW>>
             task_;
 
       public:
-        explicit SendDataTask(UhfFrame &&frame, util::Time &time, util::Rand &rand)
-            : frame_{etl::move(frame)},
-              task_{CarrierSenseTask<RW>{time, rand}} {}
-
-        nb::Poll<void>
-        execute(nb::Lock<etl::reference_wrapper<RW>> &rw, util::Time &time, util::Rand &rand) {
+        explicit SendDataTask(UhfFrameBatch &&batch) : batch_{etl::move(batch)}, task_{Initial{}} {}
+
+        nb::Poll<void> execute(
+            nb::Lock<etl::reference_wrapper<RW>> &rw,
+            util::Time &time,
+            util::Rand &rand,
+            CarrierSenseBackoff &backoff
+        ) {
             if (etl::holds_alternative<Initial>(task_)) {
-                task_.template emplace<CarrierSenseTask<RW>>(time, rand);
+                task_.template emplace<CarrierSenseTask<RW>>(time, rand, backoff);
             }
 
             if (etl::holds_alternative<CarrierSenseTask<RW>>(task_)) {
                 auto &task = etl::get<CarrierSenseTask<RW>>(task_);
-                auto result = POLL_UNWRAP_OR_RETURN(task.execute(rw, time, rand));
-                task_.template emplace<SendData>(frame_.clone());
+                auto result = POLL_UNWRAP_OR_RETURN(task.execute(rw, time, rand, backoff));
+                task_.template emplace<SendData>(batch_.clone());
                 if (result == CarrierSenseResult::Error) {
                     return nb::ready();
                 }
@@ -156,12 +208,18 @@ namespace media::uhf {
                 }
 
                 remaining_retry_count_--;
-                task_.template emplace<CarrierSenseTask<RW>>(time, rand);
+                backoff.on_failure();
+                task_.template emplace<CarrierSenseTask<RW>>(time, rand, backoff);
             }
 
             return nb::pending;
         }
 
+        inline bool is_backing_off() const {
+            return etl::holds_alternative<CarrierSenseTask<RW>>(task_) &&
+                etl::get<CarrierSenseTask<RW>>(task_).is_backing_off();
+        }
+
         inline UhfHandleResponseResult handle_response(UhfResponse<RW> &&res) {
             return etl::visit(
                 util::Visitor{
@@ -1,21 +1,28 @@
 #pragma once
 
-#include <etl/list.h>
+#include <etl/array.h>
 #include <etl/optional.h>
+#include <etl/type_traits.h>
 #include <etl/utility.h>
 #include <memory/lifetime.h>
 #include <stdint.h>
 
 namespace memory {
+    class RcPoolFreeList;
+
     class RcPoolCounter {
+        friend class RcPoolFreeList;
+
         uint8_t count_ = 0;
+        RcPoolFreeList *free_list_ = nullptr;
+        RcPoolCounter *next_free_ = nullptr;
 
       public:
         RcPoolCounter() = default;
         RcPoolCounter(const RcPoolCounter &) = delete;
-        RcPoolCounter(RcPoolCounter &&) = default;
+        RcPoolCounter(RcPoolCounter &&) = delete;
         RcPoolCounter &operator=(const RcPoolCounter &) = delete;
-        RcPoolCounter &operator=(RcPoolCounter &&) = default;
+        RcPoolCounter &operator=(RcPoolCounter &&) = delete;
 
         RcPoolCounter(uint8_t count) : count_{count} {}
 
@@ -27,15 +34,70 @@ namespace memory {
             ++count_;
         }
 
-        void decrement() {
-            --count_;
-        }
+        // カウントが0になった時点で，所属するプールのフリーリストに自身を返却する
+        inline void decrement();
 
         bool is_zero() const {
             return count_ == 0;
         }
     };
 
+    /**
+     * `RcPoolCounter`を連結した侵入型のフリーリスト．
+     *
+     * 確保・解放ともにO(1)で行える．
+     */
+    class RcPoolFreeList {
+        RcPoolCounter *head_ = nullptr;
+        uint8_t length_ = 0;
+
+      public:
+        RcPoolFreeList() = default;
+        RcPoolFreeList(const RcPoolFreeList &) = delete;
+        RcPoolFreeList(RcPoolFreeList &&) = delete;
+        RcPoolFreeList &operator=(const RcPoolFreeList &) = delete;
+        RcPoolFreeList &operator=(RcPoolFreeList &&) = delete;
+
+        inline void attach(RcPoolCounter &counter) {
+            FASSERT(counter.free_list_ == nullptr);
+            counter.free_list_ = this;
+            push(counter);
+        }
+
+        inline void push(RcPoolCounter &counter) {
+            counter.next_free_ = head_;
+            head_ = &counter;
+            ++length_;
+        }
+
+        inline RcPoolCounter *pop() {
+            if (head_ == nullptr) {
+                return nullptr;
+            }
+
+            RcPoolCounter *counter = head_;
+            head_ = counter->next_free_;
+            counter->next_free_ = nullptr;
+            --length_;
+            return counter;
+        }
+
+        inline bool empty() const {
+            return head_ == nullptr;
+        }
+
+        inline uint8_t length() const {
+            return length_;
+        }
+    };
+
+    inline void RcPoolCounter::decrement() {
+        FASSERT(count_ > 0);
+        if (--count_ == 0 && free_list_ != nullptr) {
+            free_list_->push(*this);
+        }
+    }
+
     template <typename T>
     union DeferredInit {
       private:
@@ -49,14 +111,14 @@ namespace memory {
             return &value;
         }
 
-        ~DeferredInit() {
-            value.~T();
-        }
+        ~DeferredInit() {}
     };
 
     template <typename T>
-    class RcPoolEntry {
-        RcPoolCounter counter_;
+    class RcPoolEntry : public RcPoolCounter {
+        // 解放時にデストラクタを呼ばないため，`T`はトリビアルに破棄可能である必要がある
+        static_assert(etl::is_trivially_destructible_v<T>);
+
         DeferredInit<T> value_;
 
       public:
@@ -71,7 +133,7 @@ namespace memory {
         }
 
         RcPoolCounter *counter() {
-            return &counter_;
+            return this;
         }
     };
 
@@ -81,19 +143,35 @@ namespace memory {
     template <typename T, uint8_t N>
     class RcPool {
         friend class RcPoolRef<T>;
-        etl::list<RcPoolEntry<T>, N> entries_;
+        etl::array<RcPoolEntry<T>, N> entries_;
+        RcPoolFreeList free_list_;
 
       public:
-        RcPool() = default;
+        RcPool() {
+            // 先頭のエントリから順に確保されるように，末尾から追加する
+            for (uint8_t i = N; i > 0; i--) {
+                free_list_.attach(*entries_[i - 1].counter());
+            }
+        }
+
         RcPool(const RcPool &) = delete;
         RcPool(RcPool &&) = delete;
         RcPool &operator=(const RcPool &) = delete;
         RcPool &operator=(RcPool &&) = delete;
+
+        static constexpr uint8_t capacity() {
+            return N;
+        }
+
+        inline uint8_t free_count() const {
+            return free_list_.length();
+        }
     };
 
     template <typename T>
     class RcPoolRef {
-        etl::ilist<RcPoolEntry<T>> &entries_;
+        RcPoolFreeList *free_list_;
+        uint8_t capacity_;
 
       public:
         RcPoolRef() = delete;
@@ -105,27 +183,35 @@ namespace memory {
         ~RcPoolRef() {}
 
         template <uint8_t N>
-        RcPoolRef(Static<RcPool<T, N>> &pool) : entries_{pool.get().entries_} {}
+        RcPoolRef(Static<RcPool<T, N>> &pool)
+            : free_list_{&pool.get().free_list_},
+              capacity_{N} {}
 
-      private:
-        inline void remove_zero_count_entries() {
-            entries_.remove_if([&](RcPoolEntry<T> &entry) { return entry.counter()->is_zero(); });
-            if (entries_.full()) {
-                LOG_WARNING(FLASH_STRING("Pool full"));
-            }
+        inline uint8_t capacity() const {
+            return capacity_;
         }
 
-      public:
+        inline uint8_t free_count() const {
+            return free_list_->length();
+        }
+
+        inline uint8_t in_use_count() const {
+            return capacity_ - free_list_->length();
+        }
+
+        /**
+         * 空きエントリを1つ取り出す．
+         *
+         * 返されるカウンタは0のままなので，呼び出し側は直ちに`increment`すること．
+         */
         etl::optional<etl::pair<RcPoolCounter *, T *>> allocate() {
-            if (entries_.full()) {
-                remove_zero_count_entries();
-                if (entries_.full()) {
-                    return etl::nullopt;
-                }
+            RcPoolCounter *counter = free_list_->pop();
+            if (counter == nullptr) {
+                return etl::nullopt;
             }
 
-            auto &entry = entries_.emplace_back();
-            return etl::make_pair(entry.counter(), entry.value());
+            auto *entry = static_cast<RcPoolEntry<T> *>(counter);
+            return etl::make_pair(counter, entry->value());
         }
     };
 } // namespace memory
@@ -16,6 +16,9 @@ namespace nb {
     using de::AsyncReadable;
     using ser::AsyncWritable;
 
+    using de::AsyncBulkReadable;
+    using ser::AsyncBulkWritable;
+
     using de::AsyncDeserializable;
     using ser::AsyncSerializable;
 
@@ -40,6 +40,17 @@ namespace nb::de {
             { readable.seek(index) } -> util::same_as<void>;
         };
 
+    /**
+     * 読み込み可能なバイト列をまとめて読み込めるReadable．
+     * `read_into`は`dest`と`readable_length()`の短い方の長さだけ読み込み，読み込んだ長さを返す．
+     */
+    template <typename T>
+    concept AsyncBulkReadable =
+        AsyncReadable<T> && requires(T &readable, etl::span<uint8_t> dest) {
+            { readable.readable_length() } -> util::same_as<uint8_t>;
+            { readable.read_into(dest) } -> util::same_as<uint8_t>;
+        };
+
     template <typename T, typename Readable>
     concept AsyncDeserializable = AsyncReadable<Readable> && requires(T &de, Readable &readable) {
         { T{} } -> util::same_as<T>;
@@ -31,6 +31,17 @@ namespace nb::ser {
         { writable.write_unchecked(byte) } -> util::same_as<void>;
     };
 
+    /**
+     * バイト列をまとめて書き込めるWritable．
+     * `write_from`は`src`と`writable_length()`の短い方の長さだけ書き込み，書き込んだ長さを返す．
+     */
+    template <typename T>
+    concept AsyncBulkWritable =
+        AsyncWritable<T> && requires(T &writable, etl::span<const uint8_t> src) {
+            { writable.writable_length() } -> util::same_as<uint8_t>;
+            { writable.write_from(src) } -> util::same_as<uint8_t>;
+        };
+
     template <typename T, typename Writable>
     concept AsyncSerializable = AsyncWritable<Writable> && requires(T &ser, Writable &writable) {
         { ser.serialize(writable) } -> util::same_as<nb::Poll<SerializeResult>>;
@@ -2,6 +2,7 @@
 
 #include "./de.h"
 #include "./ser.h"
+#include <etl/algorithm.h>
 
 namespace nb {
     class AsyncSpanWritable {
@@ -23,6 +24,17 @@ namespace nb {
             span_ = span_.subspan(1);
         }
 
+        inline uint8_t writable_length() const {
+            return static_cast<uint8_t>(span_.size());
+        }
+
+        inline uint8_t write_from(etl::span<const uint8_t> src) {
+            uint8_t length = etl::min(static_cast<uint8_t>(src.size()), writable_length());
+            etl::copy_n(src.begin(), length, span_.begin());
+            span_ = span_.subspan(length);
+            return length;
+        }
+
         inline nb::Poll<ser::SerializeResult> write(uint8_t src) {
             SERDE_SERIALIZE_OR_RETURN(poll_writable(1));
             write_unchecked(src);
@@ -81,6 +93,17 @@ namespace nb {
             return de::DeserializeResult::Ok;
         }
 
+        inline uint8_t readable_length() const {
+            return readable_count();
+        }
+
+        inline uint8_t read_into(etl::span<uint8_t> dest) {
+            uint8_t length = etl::min(static_cast<uint8_t>(dest.size()), readable_count());
+            etl::copy_n(span_.begin() + read_count_, length, dest.begin());
+            read_count_ += length;
+            return length;
+        }
+
         inline etl::span<const uint8_t> read_span_unchecked(uint8_t count) {
             uint8_t prev_read_count = read_count_;
             read_count_ += count;
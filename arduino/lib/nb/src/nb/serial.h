@@ -1,5 +1,6 @@
 #pragma once
 
+#include <etl/algorithm.h>
 #include <etl/optional.h>
 #include <memory/lifetime.h>
 #include <nb/serde.h>
@@ -19,6 +20,12 @@ namespace nb {
 
         explicit AsyncReadableWritableSerial(RawSerial &raw) : raw_{raw} {}
 
+        // 送信バッファを送り切ってから速度を変更する．受信バッファは破棄される
+        inline void set_baud_rate(uint32_t baud_rate) {
+            raw_.end();
+            raw_.begin(baud_rate);
+        }
+
         inline nb::Poll<nb::DeserializeResult> poll_readable(uint8_t read_count) {
             return raw_.available() >= read_count ? nb::ready(nb::DeserializeResult::Ok)
                                                   : nb::pending;
@@ -28,6 +35,16 @@ namespace nb {
             return static_cast<uint8_t>(raw_.read());
         }
 
+        inline uint8_t readable_length() const {
+            int length = raw_.available();
+            return length > 0xFF ? 0xFF : static_cast<uint8_t>(length);
+        }
+
+        inline uint8_t read_into(etl::span<uint8_t> dest) {
+            uint8_t length = etl::min(static_cast<uint8_t>(dest.size()), readable_length());
+            return static_cast<uint8_t>(raw_.readBytes(dest.data(), length));
+        }
+
         inline nb::Poll<nb::DeserializeResult> read(uint8_t &dest) {
             SERDE_DESERIALIZE_OR_RETURN(poll_readable(1));
             dest = read_unchecked();
@@ -43,6 +60,16 @@ namespace nb {
             raw_.write(data);
         }
 
+        inline uint8_t writable_length() const {
+            int length = raw_.availableForWrite();
+            return length > 0xFF ? 0xFF : static_cast<uint8_t>(length);
+        }
+
+        inline uint8_t write_from(etl::span<const uint8_t> src) {
+            uint8_t length = etl::min(static_cast<uint8_t>(src.size()), writable_length());
+            return static_cast<uint8_t>(raw_.write(src.data(), length));
+        }
+
         inline nb::Poll<nb::SerializeResult> write(uint8_t data) {
             SERDE_SERIALIZE_OR_RETURN(poll_writable(1));
             write_unchecked(data);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <etl/utility.h>
+#include <logger.h>
+#include <nb/poll.h>
+#include <stdint.h>
+#include <tl/vec.h>
+
+namespace nb {
+    /**
+     * 固定数のタスクを保持し，それぞれを独立に実行するプール．
+     *
+     * 完了していないタスクがあっても後続のタスクは実行されるため，
+     * 1つのタスクが長時間待機していても他のタスクは進行する．
+     */
+    template <typename T, uint8_t CAPACITY>
+    class TaskPool {
+        static_assert(CAPACITY > 0);
+
+        tl::Vec<T, CAPACITY> tasks_{};
+
+      public:
+        TaskPool() = default;
+        TaskPool(const TaskPool &) = delete;
+        TaskPool(TaskPool &&) = default;
+        TaskPool &operator=(const TaskPool &) = delete;
+        TaskPool &operator=(TaskPool &&) = default;
+
+        inline uint8_t size() const {
+            return tasks_.size();
+        }
+
+        inline bool empty() const {
+            return tasks_.empty();
+        }
+
+        inline bool full() const {
+            return tasks_.full();
+        }
+
+        template <typename... Args>
+        inline void emplace(Args &&...args) {
+            FASSERT(!full());
+            tasks_.emplace_back(etl::forward<Args>(args)...);
+        }
+
+        /**
+         * 全てのタスクを追加された順に実行し，完了したタスクを取り除く．
+         * `f`はタスクを受け取り，完了した場合に`nb::ready()`を返す．
+         */
+        template <typename F>
+        void execute(F &&f) {
+            uint8_t i = 0;
+            while (i < tasks_.size()) {
+                nb::Poll<void> poll = f(tasks_[i]);
+                if (poll.is_ready()) {
+                    tasks_.remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+    };
+} // namespace nb
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <etl/array.h>
+#include <etl/optional.h>
+#include <logger.h>
+#include <nb/poll.h>
+#include <stdint.h>
+#include <util/time.h>
+
+namespace nb {
+    template <typename T, uint8_t CAPACITY, uint8_t SLOT_BITS, uint8_t LEVEL_COUNT>
+    class TimerWheel;
+
+    class TimerHandle {
+        template <typename T, uint8_t CAPACITY, uint8_t SLOT_BITS, uint8_t LEVEL_COUNT>
+        friend class TimerWheel;
+
+        uint8_t index_;
+
+        explicit constexpr TimerHandle(uint8_t index) : index_{index} {}
+
+      public:
+        inline constexpr bool operator==(const TimerHandle &other) const {
+            return index_ == other.index_;
+        }
+
+        inline constexpr bool operator!=(const TimerHandle &other) const {
+            return index_ != other.index_;
+        }
+    };
+
+    /**
+     * 階層型タイマーホイール．
+     *
+     * 登録されたタイマーを期限に応じたスロットに振り分け，期限を迎えたスロットのタイマーのみを処理する．
+     * そのため，1回の`poll_pop_expired`にかかる時間は登録数ではなく，期限切れのタイマー数に比例する．
+     *
+     * 期限は`tick`単位に切り上げられるため，タイマーは期限より早く発火することはないが，
+     * 最大で`tick`だけ遅れて発火する．
+     *
+     * 発火したタイマーのハンドルは`cancel`されるまで有効であり，`reschedule`で再登録できる．
+     */
+    template <typename T, uint8_t CAPACITY, uint8_t SLOT_BITS = 3, uint8_t LEVEL_COUNT = 3>
+    class TimerWheel {
+        static_assert(CAPACITY > 0 && CAPACITY < 0xFF);
+        static_assert(SLOT_BITS > 0 && SLOT_BITS * LEVEL_COUNT < 32);
+
+        static constexpr uint8_t NIL = 0xFF;
+        static constexpr uint8_t SLOT_COUNT = 1 << SLOT_BITS;
+        static constexpr uint8_t SLOT_MASK = SLOT_COUNT - 1;
+        static constexpr uint32_t MAX_TICK_DELTA = (uint32_t{1} << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+        // ホイールのスロットの後ろに，発火済みタイマーを保持するリストを置く
+        static constexpr uint8_t LIST_COUNT = SLOT_COUNT * LEVEL_COUNT + 1;
+        static constexpr uint8_t EXPIRED_LIST = LIST_COUNT - 1;
+
+        enum class State : uint8_t {
+            Free,
+            Scheduled,
+            Fired,
+        };
+
+        struct Timer {
+            etl::optional<T> value;
+            uint32_t deadline_tick;
+            uint8_t prev;
+            uint8_t next;
+            uint8_t list;
+            State state;
+        };
+
+        etl::array<Timer, CAPACITY> timers_;
+        etl::array<uint8_t, LIST_COUNT> heads_;
+        uint8_t free_head_{0};
+        uint8_t size_{0};
+        uint8_t scheduled_count_{0};
+
+        util::Duration tick_;
+        uint32_t current_tick_{0};
+        util::Instant next_tick_at_;
+
+        void link(uint8_t index, uint8_t list) {
+            Timer &timer = timers_[index];
+            timer.list = list;
+            timer.prev = NIL;
+            timer.next = heads_[list];
+            if (timer.next != NIL) {
+                timers_[timer.next].prev = index;
+            }
+            heads_[list] = index;
+        }
+
+        void unlink(uint8_t index) {
+            Timer &timer = timers_[index];
+            if (timer.prev == NIL) {
+                heads_[timer.list] = timer.next;
+            } else {
+                timers_[timer.prev].next = timer.next;
+            }
+            if (timer.next != NIL) {
+                timers_[timer.next].prev = timer.prev;
+            }
+        }
+
+        void place(uint8_t index) {
+            Timer &timer = timers_[index];
+            int32_t delta = static_cast<int32_t>(timer.deadline_tick - current_tick_);
+            if (delta <= 0) {
+                timer.state = State::Fired;
+                scheduled_count_--;
+                link(index, EXPIRED_LIST);
+                return;
+            }
+
+            // 範囲外の期限は最上位レベルの最も遠いスロットに置き，カスケード時に再配置する
+            uint32_t tick = static_cast<uint32_t>(delta) > MAX_TICK_DELTA
+                ? current_tick_ + MAX_TICK_DELTA
+                : timer.deadline_tick;
+            uint32_t distance = tick - current_tick_;
+
+            uint8_t level = 0;
+            while (level + 1 < LEVEL_COUNT && (distance >> (SLOT_BITS * (level + 1))) != 0) {
+                level++;
+            }
+            uint8_t slot = (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+            link(index, level * SLOT_COUNT + slot);
+        }
+
+        void cascade(uint8_t list) {
+            uint8_t index = heads_[list];
+            heads_[list] = NIL;
+            while (index != NIL) {
+                uint8_t next = timers_[index].next;
+                place(index);
+                index = next;
+            }
+        }
+
+        void step() {
+            current_tick_++;
+
+            // 下位レベルが一周した場合，上位レベルのスロットを下位に降ろす
+            uint8_t level = 1;
+            while (level < LEVEL_COUNT &&
+                   (current_tick_ & ((uint32_t{1} << (SLOT_BITS * level)) - 1)) == 0) {
+                level++;
+            }
+            for (uint8_t l = level - 1; l > 0; l--) {
+                uint8_t slot = (current_tick_ >> (SLOT_BITS * l)) & SLOT_MASK;
+                cascade(l * SLOT_COUNT + slot);
+            }
+
+            cascade(current_tick_ & SLOT_MASK);
+        }
+
+        void advance(util::Instant now) {
+            while (now - next_tick_at_ >= util::Duration::zero()) {
+                if (scheduled_count_ == 0) {
+                    // 登録済みのタイマーが無い場合は，スロットを辿らずに読み飛ばす
+                    util::TimeDiff skip = (now - next_tick_at_).millis() / tick_.millis() + 1;
+                    current_tick_ += skip;
+                    next_tick_at_ += tick_ * skip;
+                    return;
+                }
+
+                step();
+                next_tick_at_ += tick_;
+            }
+        }
+
+        inline uint32_t to_deadline_tick(util::Instant deadline) const {
+            util::Instant current_tick_at = next_tick_at_ - tick_;
+            if (deadline - current_tick_at <= util::Duration::zero()) {
+                return current_tick_;
+            }
+
+            int32_t ms = (deadline - current_tick_at).millis();
+            return current_tick_ + (ms + tick_.millis() - 1) / tick_.millis();
+        }
+
+      public:
+        TimerWheel() = delete;
+        TimerWheel(const TimerWheel &) = delete;
+        TimerWheel(TimerWheel &&) = delete;
+        TimerWheel &operator=(const TimerWheel &) = delete;
+        TimerWheel &operator=(TimerWheel &&) = delete;
+
+        explicit TimerWheel(util::Time &time, util::Duration tick)
+            : tick_{tick},
+              next_tick_at_{time.now() + tick} {
+            FASSERT(tick > util::Duration::zero());
+            heads_.fill(NIL);
+            for (uint8_t i = 0; i < CAPACITY; i++) {
+                timers_[i].state = State::Free;
+                timers_[i].list = NIL;
+                timers_[i].next = i + 1 < CAPACITY ? i + 1 : NIL;
+            }
+        }
+
+        inline uint8_t size() const {
+            return size_;
+        }
+
+        inline bool full() const {
+            return size_ == CAPACITY;
+        }
+
+        etl::optional<TimerHandle> schedule(const T &value, util::Instant deadline) {
+            if (free_head_ == NIL) {
+                return etl::nullopt;
+            }
+
+            uint8_t index = free_head_;
+            Timer &timer = timers_[index];
+            free_head_ = timer.next;
+            size_++;
+
+            timer.value = value;
+            timer.deadline_tick = to_deadline_tick(deadline);
+            timer.state = State::Scheduled;
+            scheduled_count_++;
+            place(index);
+            return TimerHandle{index};
+        }
+
+        inline etl::optional<TimerHandle>
+        schedule(const T &value, util::Duration delay, util::Time &time) {
+            return schedule(value, time.now() + delay);
+        }
+
+        void reschedule(TimerHandle handle, util::Instant deadline) {
+            Timer &timer = timers_[handle.index_];
+            FASSERT(timer.state != State::Free);
+
+            if (timer.state == State::Scheduled) {
+                scheduled_count_--;
+            }
+            if (timer.list != NIL) {
+                unlink(handle.index_);
+            }
+
+            timer.deadline_tick = to_deadline_tick(deadline);
+            timer.state = State::Scheduled;
+            scheduled_count_++;
+            place(handle.index_);
+        }
+
+        inline void reschedule(TimerHandle handle, util::Duration delay, util::Time &time) {
+            reschedule(handle, time.now() + delay);
+        }
+
+        void cancel(TimerHandle handle) {
+            Timer &timer = timers_[handle.index_];
+            FASSERT(timer.state != State::Free);
+
+            if (timer.state == State::Scheduled) {
+                scheduled_count_--;
+            }
+            if (timer.list != NIL) {
+                unlink(handle.index_);
+            }
+
+            timer.value = etl::nullopt;
+            timer.state = State::Free;
+            timer.list = NIL;
+            timer.next = free_head_;
+            free_head_ = handle.index_;
+            size_--;
+        }
+
+        /**
+         * 期限を迎えたタイマーを1つ取り出し，その値を返す．
+         *
+         * 取り出したタイマーは再登録されるまで発火しない．
+         */
+        nb::Poll<T> poll_pop_expired(util::Time &time) {
+            advance(time.now());
+
+            uint8_t index = heads_[EXPIRED_LIST];
+            if (index == NIL) {
+                return nb::pending;
+            }
+
+            unlink(index);
+            // どのリストにも属さないことを示す
+            timers_[index].list = NIL;
+            return *timers_[index].value;
+        }
+    };
+} // namespace nb
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "./constants.h"
+#include "./route_table.h"
+#include <net/neighbor.h>
+
+namespace net::discovery {
+    class AsyncAdvertisedRouteDeserializer {
+        node::AsyncNodeIdDeserializer destination_;
+        node::AsyncNodeIdDeserializer gateway_id_;
+        node::AsyncCostDeserializer cost_;
+        nb::de::Bin<uint8_t> hop_count_;
+
+      public:
+        inline AdvertisedRoute result() const {
+            return AdvertisedRoute{
+                .destination = destination_.result(),
+                .gateway_id = gateway_id_.result(),
+                .cost = cost_.result(),
+                .hop_count = hop_count_.result(),
+            };
+        }
+
+        template <nb::de::AsyncReadable R>
+        nb::Poll<nb::de::DeserializeResult> deserialize(R &r) {
+            SERDE_DESERIALIZE_OR_RETURN(destination_.deserialize(r));
+            SERDE_DESERIALIZE_OR_RETURN(gateway_id_.deserialize(r));
+            SERDE_DESERIALIZE_OR_RETURN(cost_.deserialize(r));
+            return hop_count_.deserialize(r);
+        }
+    };
+
+    class AsyncAdvertisedRouteSerializer {
+        node::AsyncNodeIdSerializer destination_;
+        node::AsyncNodeIdSerializer gateway_id_;
+        node::AsyncCostSerializer cost_;
+        nb::ser::Bin<uint8_t> hop_count_;
+
+      public:
+        explicit AsyncAdvertisedRouteSerializer(const AdvertisedRoute &route)
+            : destination_{route.destination},
+              gateway_id_{route.gateway_id},
+              cost_{route.cost},
+              hop_count_{route.hop_count} {}
+
+        template <nb::ser::AsyncWritable W>
+        nb::Poll<nb::ser::SerializeResult> serialize(W &w) {
+            SERDE_SERIALIZE_OR_RETURN(destination_.serialize(w));
+            SERDE_SERIALIZE_OR_RETURN(gateway_id_.serialize(w));
+            SERDE_SERIALIZE_OR_RETURN(cost_.serialize(w));
+            return hop_count_.serialize(w);
+        }
+
+        inline uint8_t serialized_length() const {
+            return destination_.serialized_length() + gateway_id_.serialized_length() +
+                cost_.serialized_length() + hop_count_.serialized_length();
+        }
+    };
+
+    /**
+     * 経路広告フレームの受信処理．
+     * フレームは経路数と，それに続く経路の列からなる．経路は1つずつ読み出して経路表に反映する．
+     */
+    class ReceiveAdvertisementTask {
+        neighbor::ReceivedNeighborFrame frame_;
+        nb::de::Bin<uint8_t> route_count_{};
+        etl::optional<uint8_t> remaining_{};
+        AsyncAdvertisedRouteDeserializer route_{};
+
+      public:
+        explicit ReceiveAdvertisementTask(neighbor::ReceivedNeighborFrame &&frame)
+            : frame_{etl::move(frame)} {}
+
+        nb::Poll<void> execute(
+            neighbor::NeighborService &ns,
+            RouteTable &table,
+            const local::LocalNodeInfo &local,
+            util::Time &time
+        ) {
+            auto opt_link_cost = ns.get_link_cost(frame_.sender);
+            if (!opt_link_cost.has_value()) {
+                return nb::ready();
+            }
+            node::Cost gateway_cost = *opt_link_cost + local.cost;
+
+            if (!remaining_.has_value()) {
+                auto result = POLL_UNWRAP_OR_RETURN(frame_.reader.deserialize(route_count_));
+                if (result != nb::de::DeserializeResult::Ok) {
+                    return nb::ready();
+                }
+                remaining_ = route_count_.result();
+            }
+
+            while (*remaining_ > 0) {
+                auto result = POLL_UNWRAP_OR_RETURN(frame_.reader.deserialize(route_));
+                if (result != nb::de::DeserializeResult::Ok) {
+                    return nb::ready();
+                }
+
+                // 隣接ノードへの経路は経路表に載せない
+                const auto &route = route_.result();
+                if (!ns.has_neighbor(route.destination)) {
+                    table.on_route_advertised(
+                        local.source.node_id, frame_.sender, gateway_cost, route, time
+                    );
+                }
+                route_ = AsyncAdvertisedRouteDeserializer{};
+                (*remaining_)--;
+            }
+            return nb::ready();
+        }
+    };
+
+    /**
+     * 隣接ノードと経路表の経路を，`ROUTE_ADVERTISEMENT_INTERVAL`ごとにブロードキャストする．
+     * フレームに収まらない経路は広告しない．
+     * 受信側がポイズンリバースを行えるよう，各経路には次ホップを含める．
+     */
+    class RouteAdvertiser {
+        using RouteCountSerializer = nb::ser::Bin<uint8_t>;
+
+        struct Send {
+            frame::FrameBufferReader reader;
+        };
+
+        neighbor::NeighborSocket<ADVERTISEMENT_FRAME_DELAY_POOL_SIZE> socket_;
+        etl::variant<etl::monostate, ReceiveAdvertisementTask> receive_task_{};
+        etl::optional<Send> send_{};
+        nb::Debounce debounce_;
+
+        // 広告する経路を，フレームに収まる分だけ`f`に渡して経路数を返す
+        template <typename F>
+        uint8_t
+        for_each_route(const neighbor::NeighborService &ns, const RouteTable &table, F &&f) {
+            uint8_t length = RouteCountSerializer::serialized_length(0);
+            uint8_t count = 0;
+            auto visit = [&](const AdvertisedRoute &route) {
+                uint8_t route_length =
+                    AsyncAdvertisedRouteSerializer{route}.serialized_length();
+                if (length + route_length > socket_.max_payload_length() || count == 0xFF) {
+                    return;
+                }
+                length += route_length;
+                count++;
+                f(route);
+            };
+
+            ns.for_each_neighbor_node([&](const neighbor::NeighborNode &neighbor) {
+                visit(AdvertisedRoute{
+                    .destination = neighbor.id(),
+                    .gateway_id = neighbor.id(),
+                    .cost = neighbor.link_cost(),
+                    .hop_count = 1,
+                });
+            });
+            table.for_each([&](const RouteEntry &entry) {
+                visit(AdvertisedRoute{
+                    .destination = entry.destination,
+                    .gateway_id = entry.gateway_id,
+                    .cost = entry.cost,
+                    .hop_count = entry.hop_count,
+                });
+            });
+            return count;
+        }
+
+        nb::Poll<frame::FrameBufferReader> poll_write_frame(
+            frame::FrameService &fs,
+            const local::LocalNodeService &lns,
+            const neighbor::NeighborService &ns,
+            const RouteTable &table
+        ) {
+            uint8_t length = RouteCountSerializer::serialized_length(0);
+            uint8_t count = for_each_route(ns, table, [&](const AdvertisedRoute &route) {
+                length += AsyncAdvertisedRouteSerializer{route}.serialized_length();
+            });
+
+            auto &&writer = POLL_MOVE_UNWRAP_OR_RETURN(socket_.poll_frame_writer(fs, lns, length));
+            writer.serialize_all_at_once(RouteCountSerializer{count});
+            for_each_route(ns, table, [&](const AdvertisedRoute &route) {
+                writer.serialize_all_at_once(AsyncAdvertisedRouteSerializer{route});
+            });
+
+            FASSERT(writer.is_all_written());
+            return writer.create_reader();
+        }
+
+      public:
+        explicit RouteAdvertiser(link::LinkService &link_service, util::Time &time)
+            : socket_{link_service.open(frame::ProtocolNumber::RouteAdvertisement), SOCKET_CONFIG},
+              debounce_{time, ROUTE_ADVERTISEMENT_INTERVAL} {}
+
+        void execute(
+            frame::FrameService &fs,
+            link::MediaService auto &ms,
+            const local::LocalNodeService &lns,
+            neighbor::NeighborService &ns,
+            RouteTable &table,
+            const local::LocalNodeInfo &local,
+            util::Time &time
+        ) {
+            socket_.execute(ms, lns, ns, time);
+
+            if (etl::holds_alternative<etl::monostate>(receive_task_)) {
+                auto &&poll_frame = socket_.poll_receive_frame(time);
+                if (poll_frame.is_ready()) {
+                    receive_task_.emplace<ReceiveAdvertisementTask>(etl::move(poll_frame.unwrap())
+                    );
+                }
+            }
+
+            // 無効な場合も，受信キューに溜まらないよう受信したフレームは読み捨てる
+            if (etl::holds_alternative<ReceiveAdvertisementTask>(receive_task_)) {
+                auto &task = etl::get<ReceiveAdvertisementTask>(receive_task_);
+                if (!table.is_enabled() || task.execute(ns, table, local, time).is_ready()) {
+                    receive_task_.emplace<etl::monostate>();
+                }
+            }
+
+            if (!table.is_enabled()) {
+                return;
+            }
+
+            table.remove_expired(time.now());
+
+            if (!send_.has_value()) {
+                if (debounce_.poll(time).is_pending()) {
+                    return;
+                }
+
+                auto poll_reader = poll_write_frame(fs, lns, ns, table);
+                if (poll_reader.is_pending()) {
+                    return;
+                }
+                send_.emplace(Send{etl::move(poll_reader.unwrap())});
+            }
+
+            if (socket_.poll_send_broadcast_frame(ns, etl::move(send_->reader)).is_ready()) {
+                send_.reset();
+            }
+        }
+    };
+} // namespace net::discovery
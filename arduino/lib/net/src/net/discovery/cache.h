@@ -2,8 +2,11 @@
 
 #include "./constants.h"
 #include "./frame.h"
+#include <net/neighbor.h>
 #include <net/node.h>
-#include <tl/cache_set.h>
+#include <tl/index_list.h>
+#include <tl/index_table.h>
+#include <tl/vec.h>
 
 namespace net::discovery {
     struct CacheValue {
@@ -11,72 +14,299 @@ namespace net::discovery {
         TotalCost total_cost;
     };
 
+    struct GatewayCandidate {
+        CacheValue value;
+        int16_t current_weight;
+    };
+
+    /**
+     * 1つの宛先に対する，コストの小さい順に`MAX_GATEWAYS_PER_DESTINATION`個までのゲートウェイ．
+     *
+     * 最小コストから`MULTIPATH_COST_TOLERANCE_PERCENT`%以内のゲートウェイを，
+     * コストが小さいほど重くした重み付きラウンドロビン（smooth weighted round-robin）で選ぶ．
+     */
+    class GatewaySet {
+        tl::Vec<GatewayCandidate, MAX_GATEWAYS_PER_DESTINATION> candidates_{};
+
+        etl::optional<uint8_t> find(const node::NodeId &gateway_id) const {
+            for (uint8_t i = 0; i < candidates_.size(); i++) {
+                if (candidates_[i].value.gateway_id == gateway_id) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        uint8_t find_costliest() const {
+            uint8_t index = 0;
+            for (uint8_t i = 1; i < candidates_.size(); i++) {
+                if (candidates_[i].value.total_cost > candidates_[index].value.total_cost) {
+                    index = i;
+                }
+            }
+            return index;
+        }
+
+        uint16_t best_cost() const {
+            uint16_t best = candidates_[0].value.total_cost.get().value();
+            for (const auto &candidate : candidates_) {
+                best = etl::min(best, candidate.value.total_cost.get().value());
+            }
+            return best;
+        }
+
+      public:
+        inline bool empty() const {
+            return candidates_.empty();
+        }
+
+        void update(const node::NodeId &gateway_id, TotalCost total_cost) {
+            CacheValue value{.gateway_id = gateway_id, .total_cost = total_cost};
+
+            auto opt_index = find(gateway_id);
+            if (opt_index.has_value()) {
+                candidates_[*opt_index].value = value;
+                return;
+            }
+
+            if (!candidates_.full()) {
+                candidates_.push_back(GatewayCandidate{.value = value, .current_weight = 0});
+                return;
+            }
+
+            uint8_t costliest = find_costliest();
+            if (total_cost < candidates_[costliest].value.total_cost) {
+                candidates_[costliest] = GatewayCandidate{.value = value, .current_weight = 0};
+            }
+        }
+
+        template <typename F>
+        void remove_if(F &&f) {
+            uint8_t i = 0;
+            while (i < candidates_.size()) {
+                if (f(candidates_[i].value.gateway_id)) {
+                    candidates_.swap_remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        CacheValue select() {
+            FASSERT(!candidates_.empty());
+
+            uint32_t best = best_cost();
+            uint32_t threshold = best + best * MULTIPATH_COST_TOLERANCE_PERCENT / 100;
+
+            int16_t total_weight = 0;
+            etl::optional<uint8_t> selected;
+            for (uint8_t i = 0; i < candidates_.size(); i++) {
+                auto &candidate = candidates_[i];
+                uint32_t cost = candidate.value.total_cost.get().value();
+                if (cost > threshold) {
+                    candidate.current_weight = 0;
+                    continue;
+                }
+
+                // 1から8までの重み．最小コストのゲートウェイが最も重い
+                int16_t weight = (threshold - cost) * 7 / (threshold - best + 1) + 1;
+                candidate.current_weight += weight;
+                total_weight += weight;
+                if (!selected || candidate.current_weight > candidates_[*selected].current_weight) {
+                    selected = i;
+                }
+            }
+
+            auto &candidate = candidates_[*selected];
+            candidate.current_weight -= total_weight;
+            return candidate.value;
+        }
+    };
+
     template <typename T>
     struct CacheEntry {
         T destination;
         nb::Delay timeout;
-        CacheValue value;
+        GatewaySet gateways;
+        bool provisional; // 逆経路から推測しただけで，経路探索で確かめていない
     };
 
-    template <typename T>
+    /**
+     * 宛先をキーとするゲートウェイのキャッシュ．
+     *
+     * 宛先はハッシュ索引で検索し，参照された順（LRU）に追い出す．
+     * 有効期限は更新時に一律で設定されるため，更新順に並べておけば先頭から期限切れを取り除ける．
+     */
+    template <typename T, uint8_t CAPACITY>
     class DiscoveryCacheSet {
-        tl::CacheSet<CacheEntry<T>, MAX_DISCOVERY_CACHE_ENTRIES> entries_;
+        static constexpr uint8_t INDEX_SLOT_COUNT = tl::index_table_slot_count<CAPACITY>();
 
-      public:
-        inline void update(
+        etl::array<etl::optional<CacheEntry<T>>, CAPACITY> entries_{};
+        tl::IndexTable<INDEX_SLOT_COUNT> index_{};
+        tl::IndexList<CAPACITY> free_{};
+        tl::IndexList<CAPACITY> lru_{};    // 先頭が最も長く参照されていないエントリ
+        tl::IndexList<CAPACITY> expiry_{}; // 先頭が最も早く期限切れになるエントリ
+
+        inline etl::optional<uint8_t> find(const T &destination) const {
+            return index_.find(destination.hash(), [&](uint8_t index) {
+                return entries_[index]->destination == destination;
+            });
+        }
+
+        void remove_at(uint8_t index) {
+            entries_[index] = etl::nullopt;
+            lru_.remove(index);
+            expiry_.remove(index);
+            free_.push_back(index);
+
+            index_.clear();
+            lru_.for_each([&](uint8_t i) { index_.insert(entries_[i]->destination.hash(), i); });
+        }
+
+        void refresh(
+            uint8_t index,
+            const node::NodeId &gateway_id,
+            TotalCost total_cost,
+            util::Time &time
+        ) {
+            auto &entry = *entries_[index];
+            entry.timeout = nb::Delay{time, DISCOVERY_CACHE_EXPIRATION};
+            entry.gateways.update(gateway_id, total_cost);
+            lru_.move_to_back(index);
+            expiry_.move_to_back(index);
+        }
+
+        void insert(
             const T &destination,
             const node::NodeId &gateway_id,
             TotalCost total_cost,
+            bool provisional,
             util::Time &time
         ) {
-            entries_.remove_once_if([&](const CacheEntry<T> &entry) {
-                return entry.destination == destination;
-            });
+            if (free_.empty()) {
+                remove_at(*lru_.front());
+            }
 
-            entries_.push(CacheEntry<T>{
+            uint8_t index = *free_.pop_front();
+            entries_[index] = CacheEntry<T>{
                 .destination = destination,
                 .timeout = nb::Delay{time, DISCOVERY_CACHE_EXPIRATION},
-                .value =
-                    CacheValue{
-                        .gateway_id = gateway_id,
-                        .total_cost = total_cost,
-                    },
-            });
+                .gateways = GatewaySet{},
+                .provisional = provisional,
+            };
+            entries_[index]->gateways.update(gateway_id, total_cost);
+            lru_.push_back(index);
+            expiry_.push_back(index);
+            index_.insert(destination.hash(), index);
         }
 
-        inline void remove(const node::NodeId &gateway_id) {
-            entries_.remove_once_if([&](const CacheEntry<T> &entry) {
-                return entry.value.gateway_id == gateway_id;
-            });
+      public:
+        DiscoveryCacheSet() {
+            for (uint8_t i = 0; i < CAPACITY; i++) {
+                free_.push_back(i);
+            }
+        }
+
+        inline uint8_t size() const {
+            return lru_.size();
+        }
+
+        // 経路探索で得たゲートウェイを登録する．仮のエントリであれば，推測したゲートウェイごと置き換える
+        void update(
+            const T &destination,
+            const node::NodeId &gateway_id,
+            TotalCost total_cost,
+            util::Time &time
+        ) {
+            auto opt_index = find(destination);
+            if (!opt_index.has_value()) {
+                insert(destination, gateway_id, total_cost, false, time);
+                return;
+            }
+
+            auto &entry = *entries_[*opt_index];
+            if (entry.provisional) {
+                entry.gateways = GatewaySet{};
+                entry.provisional = false;
+            }
+            refresh(*opt_index, gateway_id, total_cost, time);
+        }
+
+        // 逆経路から推測したゲートウェイを，仮のエントリとして登録する．確かめたエントリは変更しない
+        void learn(
+            const T &destination,
+            const node::NodeId &gateway_id,
+            TotalCost total_cost,
+            util::Time &time
+        ) {
+            auto opt_index = find(destination);
+            if (!opt_index.has_value()) {
+                insert(destination, gateway_id, total_cost, true, time);
+            } else if (entries_[*opt_index]->provisional) {
+                refresh(*opt_index, gateway_id, total_cost, time);
+            }
         }
 
-        etl::optional<etl::reference_wrapper<const CacheValue>> get(const T &destination) const {
-            auto found = entries_.get_if([&](const CacheEntry<T> &e) {
-                return e.destination == destination;
+        // ゲートウェイを取り除き，他のゲートウェイが残っていればそちらに切り替える
+        void remove(const node::NodeId &gateway_id) {
+            tl::Vec<uint8_t, CAPACITY> emptied;
+            lru_.for_each([&](uint8_t i) {
+                auto &gateways = entries_[i]->gateways;
+                gateways.remove_if([&](const node::NodeId &id) { return id == gateway_id; });
+                if (gateways.empty()) {
+                    emptied.push_back(i);
+                }
             });
-            if (found.has_value()) {
-                return etl::optional(etl::cref(found->get().value));
-            } else {
+            for (uint8_t i : emptied) {
+                remove_at(i);
+            }
+        }
+
+        /**
+         * 宛先へのゲートウェイを選ぶ．参照したエントリは最近使われたものとして扱う．
+         * `is_reachable`を満たさないゲートウェイは，その場で取り除いて次の候補を使う．
+         */
+        template <typename F>
+        etl::optional<CacheValue> get(const T &destination, F &&is_reachable) {
+            auto opt_index = find(destination);
+            if (!opt_index.has_value()) {
                 return etl::nullopt;
             }
+
+            auto &gateways = entries_[*opt_index]->gateways;
+            gateways.remove_if([&](const node::NodeId &id) { return !is_reachable(id); });
+            if (gateways.empty()) {
+                remove_at(*opt_index);
+                return etl::nullopt;
+            }
+
+            lru_.move_to_back(*opt_index);
+            return gateways.select();
         }
 
         inline void remove_expired(util::Instant now) {
-            entries_.remove_all_if([&](const CacheEntry<T> &entry) {
-                return entry.timeout.poll(now).is_ready();
-            });
+            auto opt_index = expiry_.front();
+            while (opt_index && entries_[*opt_index]->timeout.poll(now).is_ready()) {
+                remove_at(*opt_index);
+                opt_index = expiry_.front();
+            }
         }
     };
 
     class DiscoveryCache {
         nb::Debounce remove_expired_debounce_;
-        DiscoveryCacheSet<node::NodeId> node_id_entries_;
-        DiscoveryCacheSet<node::ClusterId> cluster_id_entries_;
+        DiscoveryCacheSet<node::NodeId, MAX_DISCOVERY_CACHE_ENTRIES> node_id_entries_;
+        DiscoveryCacheSet<node::ClusterId, MAX_CLUSTER_DISCOVERY_CACHE_ENTRIES> cluster_id_entries_;
 
       public:
         explicit DiscoveryCache(util::Time &time)
             : remove_expired_debounce_{time, DISCOVERY_CACHE_EXPIRATION_CHECK_INTERVAL} {}
 
+        // 隣接ノードであるゲートウェイのみを使うための述語
+        static inline auto is_neighbor(const neighbor::NeighborService &ns) {
+            return [&ns](const node::NodeId &id) { return ns.has_neighbor(id); };
+        }
+
         void update(
             const node::Destination &destination,
             const node::NodeId &gateway_id,
@@ -102,34 +332,64 @@ namespace net::discovery {
             update(frame.start_node(), frame.previousHop, total_cost, time);
         }
 
+        /**
+         * 受信したフレームの送信元へは，そのフレームの前ホップを経由して到達できるとみなす．
+         * 送信元までのコストは前ホップまでのコストしか分からないため，仮のエントリとして登録する．
+         * 仮のエントリは経路探索で得たエントリを上書きせず，経路探索で更新されると置き換えられる．
+         */
+        void learn_reverse_path(
+            const node::Source &source,
+            const node::NodeId &previous_hop,
+            node::Cost link_cost,
+            node::Cost local_cost,
+            util::Time &time
+        ) {
+            TotalCost total_cost{link_cost + local_cost};
+            node_id_entries_.learn(source.node_id, previous_hop, total_cost, time);
+
+            const auto &cluster_id = source.cluster_id;
+            if (cluster_id.has_value()) {
+                cluster_id_entries_.learn(cluster_id.value(), previous_hop, total_cost, time);
+            }
+        }
+
         inline void remove(const node::NodeId &gateway_id) {
             node_id_entries_.remove(gateway_id);
             cluster_id_entries_.remove(gateway_id);
         }
 
-        // 宛先NodeIdの一致するキャッシュを探し，そのゲートウェイNodeIdを返す
-        etl::optional<etl::reference_wrapper<const CacheValue>>
-        get_by_node_id(const node::NodeId &destination) const {
-            return node_id_entries_.get(destination);
+        // 宛先NodeIdの一致するキャッシュを探し，`is_reachable`を満たすゲートウェイを1つ返す
+        template <typename F>
+        etl::optional<CacheValue>
+        get_by_node_id(const node::NodeId &destination, F &&is_reachable) {
+            return node_id_entries_.get(destination, is_reachable);
         }
 
-        // 宛先のClusterIdの一致するキャッシュを探し，そのゲートウェイNodeIdを返す
-        etl::optional<etl::reference_wrapper<const CacheValue>>
-        get_by_cluster_id(const node::OptionalClusterId &destination) const {
-            return destination.has_value() ? cluster_id_entries_.get(destination.value())
-                                           : etl::nullopt;
+        // 宛先のClusterIdの一致するキャッシュを探し，`is_reachable`を満たすゲートウェイを1つ返す
+        template <typename F>
+        etl::optional<CacheValue>
+        get_by_cluster_id(const node::OptionalClusterId &destination, F &&is_reachable) {
+            if (!destination.has_value()) {
+                return etl::nullopt;
+            }
+            return cluster_id_entries_.get(destination.value(), is_reachable);
         }
 
-        etl::optional<etl::reference_wrapper<const CacheValue>>
-        get_by_destination(const node::Destination &destination) const {
-            if (auto &&opt = get_by_node_id(destination.node_id)) {
+        template <typename F>
+        etl::optional<CacheValue>
+        get_by_destination(const node::Destination &destination, F &&is_reachable) {
+            if (auto &&opt = get_by_node_id(destination.node_id, is_reachable)) {
                 return opt;
             }
 
-            return get_by_cluster_id(destination.cluster_id);
+            return get_by_cluster_id(destination.cluster_id, is_reachable);
         }
 
         inline void execute(util::Time &time) {
+            if (remove_expired_debounce_.poll(time).is_pending()) {
+                return;
+            }
+
             auto now = time.now();
             node_id_entries_.remove_expired(now);
             cluster_id_entries_.remove_expired(now);
@@ -11,12 +11,35 @@ namespace net::discovery {
     constexpr inline util::Duration DISCOVER_INTERVAL = util::Duration::from_millis(25);
     constexpr inline uint8_t MAX_CONCURRENT_DISCOVERIES = 4;
 
-    constexpr inline uint8_t FRAME_ID_CACHE_SIZE = 8;
+    constexpr inline uint8_t DUPLICATE_DETECTOR_CAPACITY = 16;
+    constexpr inline auto DUPLICATE_DETECTION_WINDOW = DISCOVERY_FIRST_RESPONSE_TIMEOUT;
     constexpr inline uint8_t FRAME_DELAY_POOL_SIZE = 4;
     constexpr inline neighbor::NeighborSocketConfig SOCKET_CONFIG{.do_delay = false};
 
-    constexpr inline uint8_t MAX_DISCOVERY_CACHE_ENTRIES = 4;
+    constexpr inline uint8_t MAX_DISCOVERY_CACHE_ENTRIES = 8;
+    constexpr inline uint8_t MAX_CLUSTER_DISCOVERY_CACHE_ENTRIES = 4;
+    constexpr inline uint8_t MAX_GATEWAYS_PER_DESTINATION = 2;
+    constexpr inline uint8_t MULTIPATH_COST_TOLERANCE_PERCENT = 20;
     constexpr inline auto DISCOVERY_CACHE_EXPIRATION = util::Duration::from_seconds(10);
     constexpr inline auto DISCOVERY_CACHE_EXPIRATION_CHECK_INTERVAL =
         util::Duration::from_seconds(1);
+
+    constexpr inline uint8_t MAX_NEGATIVE_CACHE_ENTRIES = 4;
+    constexpr inline auto NEGATIVE_CACHE_BASE_BACKOFF = util::Duration::from_seconds(2);
+    constexpr inline auto NEGATIVE_CACHE_MAX_BACKOFF = util::Duration::from_seconds(64);
+
+    // 経路広告による経路表を，経路探索の前に参照するか
+    constexpr inline bool ENABLE_PROACTIVE_ROUTING = false;
+    // `DiscoveryService`ごとの設定．テストなどで既定値と異なる動作を選ぶために使う
+    struct DiscoveryConfig {
+        bool enable_proactive_routing;
+    };
+    constexpr inline DiscoveryConfig DEFAULT_DISCOVERY_CONFIG{
+        .enable_proactive_routing = ENABLE_PROACTIVE_ROUTING,
+    };
+    constexpr inline uint8_t MAX_ROUTE_TABLE_ENTRIES = 8;
+    constexpr inline auto ROUTE_ADVERTISEMENT_INTERVAL = util::Duration::from_seconds(5);
+    constexpr inline auto ROUTE_EXPIRATION = ROUTE_ADVERTISEMENT_INTERVAL * 3;
+    constexpr inline uint8_t MAX_ROUTE_HOP_COUNT = 15;
+    constexpr inline uint8_t ADVERTISEMENT_FRAME_DELAY_POOL_SIZE = 2;
 } // namespace net::discovery
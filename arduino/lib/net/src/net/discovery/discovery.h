@@ -2,6 +2,8 @@
 
 #include "./cache.h"
 #include "./constants.h"
+#include "./negative_cache.h"
+#include "./route_table.h"
 #include "./task.h"
 #include <nb/time.h>
 #include <net/neighbor.h>
@@ -119,6 +121,38 @@ namespace net::discovery {
         }
     };
 
+    /**
+     * 経路探索を行わずに分かる，`destination`へのゲートウェイを返す．
+     * 隣接ノード，経路探索のキャッシュ，経路表（有効な場合のみ）の順に参照する
+     */
+    inline etl::optional<node::NodeId> find_known_gateway(
+        const node::Destination &destination,
+        neighbor::NeighborService &ns,
+        DiscoveryCache &discover_cache,
+        const RouteTable &route_table
+    ) {
+        const auto &node_id = destination.node_id;
+        if (ns.has_neighbor(node_id)) {
+            return node_id;
+        }
+
+        auto is_neighbor = DiscoveryCache::is_neighbor(ns);
+        auto cache = discover_cache.get_by_destination(destination, is_neighbor);
+        if (cache) {
+            return cache->gateway_id;
+        }
+
+        // 経路表にあれば，経路探索を行わずにそのゲートウェイを使う
+        if (route_table.is_enabled()) {
+            auto opt_gateway_id = route_table.get_gateway(node_id);
+            if (opt_gateway_id && ns.has_neighbor(*opt_gateway_id)) {
+                return *opt_gateway_id;
+            }
+        }
+
+        return etl::nullopt;
+    }
+
     class DiscoveryHandler {
         enum class State : uint8_t {
             Initial,
@@ -138,23 +172,24 @@ namespace net::discovery {
             neighbor::NeighborService &ns,
             DiscoveryRequests &discovery,
             DiscoveryCache &discover_cache,
+            NegativeCache &negative_cache,
+            const RouteTable &route_table,
             TaskExecutor &task_executor,
             util::Time &time,
             util::Rand &rand
         ) {
+            auto is_neighbor = DiscoveryCache::is_neighbor(ns);
+
             if (state_ == State::Initial) {
                 if (destination_.is_broadcast()) {
                     return etl::optional(node::NodeId::broadcast());
                 }
 
-                const auto &node_id = destination_.node_id;
-                if (ns.has_neighbor(node_id)) {
-                    return etl::optional(node_id);
-                }
-
-                auto cache = discover_cache.get_by_destination(destination_);
-                if (cache) {
-                    return etl::optional(cache->get().gateway_id);
+                auto opt_gateway_id =
+                    find_known_gateway(destination_, ns, discover_cache, route_table);
+                if (opt_gateway_id) {
+                    negative_cache.on_reachable(destination_);
+                    return opt_gateway_id;
                 }
 
                 if (discovery.contains(destination_)) {
@@ -162,6 +197,11 @@ namespace net::discovery {
                     return nb::pending;
                 }
 
+                // 直前に経路探索に失敗した宛先であれば，ブロードキャストせずに失敗とする
+                if (negative_cache.poll_suppressed(destination_, time)) {
+                    return etl::optional<node::NodeId>();
+                }
+
                 state_ = State::RequestDiscovery;
             }
 
@@ -180,11 +220,13 @@ namespace net::discovery {
                     return nb::pending;
                 }
 
-                auto gateway_id = discover_cache.get_by_destination(destination_);
+                auto gateway_id = discover_cache.get_by_destination(destination_, is_neighbor);
                 if (gateway_id) {
-                    return etl::optional(gateway_id->get().gateway_id);
+                    negative_cache.on_reachable(destination_);
+                    return etl::optional(gateway_id->gateway_id);
                 } else {
                     LOG_INFO("Discovery failed: ", destination_);
+                    negative_cache.on_discovery_failed(destination_, time);
                     return etl::optional<node::NodeId>();
                 }
             }
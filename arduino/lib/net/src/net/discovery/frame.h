@@ -21,6 +21,8 @@ namespace net::discovery {
 
     class TotalCost {
         friend class ReceivedDiscoveryFrame;
+        friend class GatewaySet;
+        friend class DiscoveryCache;
 
         node::Cost cost;
 
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "./constants.h"
+#include <nb/time.h>
+#include <net/neighbor.h>
+#include <net/node.h>
+#include <tl/vec.h>
+
+namespace net::discovery {
+    struct NegativeCacheEntry {
+        node::Destination destination;
+        uint8_t failure_count;
+        nb::Delay backoff;
+    };
+
+    /**
+     * 経路探索に失敗した宛先を記録し，一定時間はその宛先への経路探索を抑制する．
+     *
+     * 抑制する時間は失敗するたびに2倍になり，`NEGATIVE_CACHE_MAX_BACKOFF`で頭打ちになる．
+     * 抑制が解除された後も`NEGATIVE_CACHE_MAX_BACKOFF`の間は失敗回数を覚えておく．
+     * 宛先に到達できることが分かった場合は，直ちに記録を消す．
+     */
+    class NegativeCache {
+        tl::Vec<NegativeCacheEntry, MAX_NEGATIVE_CACHE_ENTRIES> entries_{};
+        uint16_t suppressed_count_{0};
+
+        etl::optional<uint8_t> find(const node::Destination &destination) const {
+            for (uint8_t i = 0; i < entries_.size(); i++) {
+                if (entries_[i].destination == destination) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        static util::Duration backoff_of(uint8_t failure_count) {
+            util::Duration backoff = NEGATIVE_CACHE_BASE_BACKOFF;
+            for (uint8_t i = 1; i < failure_count && backoff < NEGATIVE_CACHE_MAX_BACKOFF; i++) {
+                backoff = backoff * 2;
+            }
+            return backoff < NEGATIVE_CACHE_MAX_BACKOFF ? backoff : NEGATIVE_CACHE_MAX_BACKOFF;
+        }
+
+        static inline util::Instant deadline_of(const NegativeCacheEntry &entry) {
+            return entry.backoff.start() + entry.backoff.duration();
+        }
+
+        static inline bool is_stale(const NegativeCacheEntry &entry, util::Instant now) {
+            return now - deadline_of(entry) >= NEGATIVE_CACHE_MAX_BACKOFF;
+        }
+
+      public:
+        /**
+         * 宛先への経路探索が抑制されているかを返す．
+         * 抑制されている場合は，抑制した回数を数える．
+         */
+        bool poll_suppressed(const node::Destination &destination, util::Time &time) {
+            auto opt_index = find(destination);
+            if (!opt_index.has_value()) {
+                return false;
+            }
+
+            if (entries_[*opt_index].backoff.poll(time).is_ready()) {
+                return false;
+            }
+
+            suppressed_count_++;
+            return true;
+        }
+
+        void on_discovery_failed(const node::Destination &destination, util::Time &time) {
+            auto opt_index = find(destination);
+            if (opt_index.has_value()) {
+                auto &entry = entries_[*opt_index];
+
+                // 同じ経路探索の失敗を待っていた複数のタスクからは，1回の失敗として数える
+                if (entry.backoff.poll(time).is_pending()) {
+                    return;
+                }
+
+                if (entry.failure_count < 0xFF) {
+                    entry.failure_count++;
+                }
+                entry.backoff = nb::Delay{time, backoff_of(entry.failure_count)};
+                return;
+            }
+
+            if (entries_.full()) {
+                // 最も早く抑制が解除されるものを置き換える
+                uint8_t oldest = 0;
+                for (uint8_t i = 1; i < entries_.size(); i++) {
+                    if (deadline_of(entries_[i]) < deadline_of(entries_[oldest])) {
+                        oldest = i;
+                    }
+                }
+                entries_.swap_remove(oldest);
+            }
+
+            entries_.push_back(NegativeCacheEntry{
+                .destination = destination,
+                .failure_count = 1,
+                .backoff = nb::Delay{time, backoff_of(1)},
+            });
+        }
+
+        inline void on_reachable(const node::Destination &destination) {
+            if (entries_.empty()) {
+                return;
+            }
+
+            auto opt_index = find(destination);
+            if (opt_index.has_value()) {
+                entries_.swap_remove(*opt_index);
+            }
+        }
+
+        // 宛先のノードからフレームを受信した場合，クラスタを問わず記録を消す
+        void on_reachable(const node::NodeId &node_id) {
+            uint8_t i = 0;
+            while (i < entries_.size()) {
+                if (entries_[i].destination.node_id == node_id) {
+                    entries_.swap_remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        // 隣接ノードになった宛先は，Helloを受信した時点で到達可能とみなす
+        void execute(const neighbor::NeighborService &ns, util::Time &time) {
+            util::Instant now = time.now();
+            uint8_t i = 0;
+            while (i < entries_.size()) {
+                const auto &entry = entries_[i];
+                if (is_stale(entry, now) || ns.has_neighbor(entry.destination.node_id)) {
+                    entries_.swap_remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        inline uint16_t suppressed_count() const {
+            return suppressed_count_;
+        }
+
+        inline void reset_suppressed_count() {
+            suppressed_count_ = 0;
+        }
+    };
+} // namespace net::discovery
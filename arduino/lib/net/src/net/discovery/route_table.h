@@ -0,0 +1,151 @@
+#pragma once
+
+#include "./constants.h"
+#include <nb/time.h>
+#include <net/node.h>
+#include <tl/vec.h>
+
+namespace net::discovery {
+    struct AdvertisedRoute {
+        node::NodeId destination;
+        // 広告元がこの経路で転送する次ホップ．隣接ノードへの経路では宛先自身
+        node::NodeId gateway_id;
+        node::Cost cost;
+        uint8_t hop_count;
+    };
+
+    struct RouteEntry {
+        node::NodeId destination;
+        node::NodeId gateway_id;
+        node::Cost cost;
+        uint8_t hop_count;
+        nb::Delay timeout;
+    };
+
+    /**
+     * 隣接ノードからの経路広告をもとにした距離ベクトル型の経路表．
+     *
+     * 同じゲートウェイからの広告は常に採用し，他のゲートウェイからの広告はコストが小さい場合のみ採用する．
+     * ホップ数が`MAX_ROUTE_HOP_COUNT`を超える経路は到達不能として扱う．
+     * 無効な経路表は経路広告を送受信せず，経路探索の前にも参照されない．
+     *
+     * 自ノードを次ホップとする経路の広告も到達不能として扱う（ポイズンリバース）．
+     * 広告はブロードキャストで宛先ごとに分けられないため，受信側で判定する．
+     * これにより，リンク切断後に2ノード間で経路を広告し合うループを防ぐ．
+     */
+    class RouteTable {
+        tl::Vec<RouteEntry, MAX_ROUTE_TABLE_ENTRIES> entries_{};
+        bool enabled_{ENABLE_PROACTIVE_ROUTING};
+
+        etl::optional<uint8_t> find(const node::NodeId &destination) const {
+            for (uint8_t i = 0; i < entries_.size(); i++) {
+                if (entries_[i].destination == destination) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        // 最もコストの大きい経路の位置を返す
+        uint8_t find_costliest() const {
+            uint8_t index = 0;
+            for (uint8_t i = 1; i < entries_.size(); i++) {
+                if (entries_[i].cost > entries_[index].cost) {
+                    index = i;
+                }
+            }
+            return index;
+        }
+
+      public:
+        RouteTable() = default;
+
+        explicit RouteTable(bool enabled) : enabled_{enabled} {}
+
+        inline bool is_enabled() const {
+            return enabled_;
+        }
+
+        inline uint8_t size() const {
+            return entries_.size();
+        }
+
+        /**
+         * `gateway_id`から広告された経路を反映する．
+         * `gateway_cost`は，自ノードから`gateway_id`までのコスト．
+         */
+        void on_route_advertised(
+            const node::NodeId &self_id,
+            const node::NodeId &gateway_id,
+            node::Cost gateway_cost,
+            const AdvertisedRoute &route,
+            util::Time &time
+        ) {
+            if (route.destination == self_id || route.destination == gateway_id) {
+                return;
+            }
+
+            auto opt_index = find(route.destination);
+            // ホップ数は，1を加えて桁あふれしないよう加える前に上限と比べる
+            if (route.gateway_id == self_id || route.hop_count >= MAX_ROUTE_HOP_COUNT) {
+                // 現在のゲートウェイが到達不能を広告した場合は経路を削除する
+                if (opt_index && entries_[*opt_index].gateway_id == gateway_id) {
+                    entries_.swap_remove(*opt_index);
+                }
+                return;
+            }
+
+            RouteEntry entry{
+                .destination = route.destination,
+                .gateway_id = gateway_id,
+                .cost = route.cost + gateway_cost,
+                .hop_count = static_cast<uint8_t>(route.hop_count + 1),
+                .timeout = nb::Delay{time, ROUTE_EXPIRATION},
+            };
+
+            if (opt_index.has_value()) {
+                auto &current = entries_[*opt_index];
+                if (current.gateway_id == gateway_id || entry.cost < current.cost) {
+                    current = entry;
+                }
+                return;
+            }
+
+            if (!entries_.full()) {
+                entries_.push_back(entry);
+                return;
+            }
+
+            uint8_t costliest = find_costliest();
+            if (entry.cost < entries_[costliest].cost) {
+                entries_[costliest] = entry;
+            }
+        }
+
+        etl::optional<node::NodeId> get_gateway(const node::NodeId &destination) const {
+            auto opt_index = find(destination);
+            if (opt_index.has_value()) {
+                return entries_[*opt_index].gateway_id;
+            }
+            return etl::nullopt;
+        }
+
+        template <typename F>
+        inline void for_each(F &&f) const {
+            for (const auto &entry : entries_) {
+                f(entry);
+            }
+        }
+
+        void remove_expired(util::Instant now) {
+            uint8_t i = 0;
+            while (i < entries_.size()) {
+                if (entries_[i].timeout.poll(now).is_ready()) {
+                    entries_.swap_remove(i);
+                } else {
+                    i++;
+                }
+            }
+        }
+    };
+} // namespace net::discovery
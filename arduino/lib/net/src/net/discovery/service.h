@@ -1,7 +1,10 @@
 #pragma once
 
+#include "./advertise.h"
 #include "./cache.h"
 #include "./discovery.h"
+#include "./negative_cache.h"
+#include "./route_table.h"
 #include "./task.h"
 #include <net/neighbor.h>
 
@@ -12,16 +15,25 @@ namespace net::discovery {
         TaskExecutor task_executor_;
         DiscoveryCache discover_cache_;
         DiscoveryRequests discovery_requests_;
+        NegativeCache negative_cache_;
+        RouteTable route_table_;
+        RouteAdvertiser route_advertiser_;
 
         void handle_received_frame(link::LinkFrame &&frame) {}
 
       public:
-        explicit DiscoveryService(link::LinkService &link_service, util::Time &time)
+        explicit DiscoveryService(
+            link::LinkService &link_service,
+            util::Time &time,
+            const DiscoveryConfig &config = DEFAULT_DISCOVERY_CONFIG
+        )
             : task_executor_{neighbor::NeighborSocket<FRAME_DELAY_POOL_SIZE>{
                   link_service.open(frame::ProtocolNumber::Discover), SOCKET_CONFIG
               }},
               discover_cache_{time},
-              discovery_requests_{time} {}
+              discovery_requests_{time},
+              route_table_{config.enable_proactive_routing},
+              route_advertiser_{link_service, time} {}
 
         void execute(
             frame::FrameService &fs,
@@ -32,6 +44,7 @@ namespace net::discovery {
             util::Rand &rand
         ) {
             discover_cache_.execute(time);
+            negative_cache_.execute(ns, time);
 
             auto &poll_info = lns.poll_info();
             if (poll_info.is_pending()) {
@@ -49,6 +62,51 @@ namespace net::discovery {
             }
 
             discovery_requests_.execute(time);
+
+            route_advertiser_.execute(fs, ms, lns, ns, route_table_, poll_info.unwrap(), time);
+        }
+
+        /**
+         * 中継・受信したフレームの送信元への逆経路を，経路探索のキャッシュに登録する．
+         * 応答は同じ経路を逆向きに辿れるため，応答のための経路探索を省ける．
+         */
+        void learn_reverse_path(
+            const neighbor::NeighborService &ns,
+            const local::LocalNodeInfo &local,
+            const node::Source &source,
+            const node::NodeId &previous_hop,
+            util::Time &time
+        ) {
+            if (source.node_id == local.source.node_id || source.node_id == previous_hop) {
+                return;
+            }
+
+            auto opt_link_cost = ns.get_link_cost(previous_hop);
+            if (opt_link_cost.has_value()) {
+                discover_cache_.learn_reverse_path(
+                    source, previous_hop, *opt_link_cost, local.cost, time
+                );
+            }
+        }
+
+        // 受信したフレームの送信元には到達できるため，送信元への経路探索の抑制を解除する
+        inline void on_reachable(const node::Source &source) {
+            negative_cache_.on_reachable(source.node_id);
+        }
+
+        // 経路探索を行わずに分かる，`destination`へのゲートウェイを返す
+        inline etl::optional<node::NodeId>
+        find_known_gateway(neighbor::NeighborService &ns, const node::Destination &destination) {
+            return discovery::find_known_gateway(destination, ns, discover_cache_, route_table_);
+        }
+
+        // 直前の失敗により抑制された経路探索の数
+        inline uint16_t suppressed_discovery_count() const {
+            return negative_cache_.suppressed_count();
+        }
+
+        inline void reset_suppressed_discovery_count() {
+            negative_cache_.reset_suppressed_count();
         }
     };
 
@@ -66,7 +124,8 @@ namespace net::discovery {
             util::Rand &rand
         ) {
             return handler_.execute(
-                lns, ns, ds.discovery_requests_, ds.discover_cache_, ds.task_executor_, time, rand
+                lns, ns, ds.discovery_requests_, ds.discover_cache_, ds.negative_cache_,
+                ds.route_table_, ds.task_executor_, time, rand
             );
         }
     };
@@ -21,19 +21,68 @@ namespace net::discovery {
 
     class TaskExecutor {
         neighbor::NeighborSocket<FRAME_DELAY_POOL_SIZE> socket_;
-        frame::FrameIdCache<FRAME_ID_CACHE_SIZE> frame_id_cache_{};
+        frame::DuplicateDetector<DUPLICATE_DETECTOR_CAPACITY> duplicate_detector_{
+            DUPLICATE_DETECTION_WINDOW
+        };
         etl::variant<etl::monostate, task::ReceiveFrameTask, task::SendFrameTask> task_{};
 
+        // 中継を取りやめるかを判定している間も受信を続けられるよう，`task_`とは別に待機させる
+        struct AssessingBroadcast {
+            task::SendFrameTask task;
+            neighbor::BroadcastSuppression suppression;
+        };
+
+        etl::optional<AssessingBroadcast> assessing_{};
+
+        void repeat_broadcast(
+            const local::LocalNodeService &lns,
+            const local::LocalNodeInfo &local,
+            const ReceivedDiscoveryFrame &frame,
+            TotalCost total_cost,
+            util::Time &time,
+            util::Rand &rand
+        ) {
+            auto task = task::SendFrameTask::repeat_broadcast(frame, local, total_cost);
+            if (!assessing_.has_value()) {
+                auto suppression = neighbor::BroadcastSuppression::start(
+                    lns.config(), frame.source.node_id.hash(), frame.frame_id, time, rand
+                );
+                if (suppression.has_value()) {
+                    assessing_.emplace(AssessingBroadcast{etl::move(task), *suppression});
+                    return;
+                }
+            }
+            task_ = etl::move(task);
+        }
+
+        void poll_assessing_broadcast(util::Time &time) {
+            if (!assessing_.has_value() || !etl::holds_alternative<etl::monostate>(task_)) {
+                return;
+            }
+
+            auto &[task, suppression] = *assessing_;
+            auto poll_suppressed = suppression.poll_suppressed(duplicate_detector_, time);
+            if (poll_suppressed.is_pending()) {
+                return;
+            }
+            if (!poll_suppressed.unwrap()) {
+                task_.emplace<task::SendFrameTask>(etl::move(task));
+            }
+            assessing_.reset();
+        }
+
       public:
         explicit TaskExecutor(neighbor::NeighborSocket<FRAME_DELAY_POOL_SIZE> &&socket)
             : socket_{etl::move(socket)} {}
 
         etl::optional<DiscoveryEvent> switch_task_by_received_frame(
+            const local::LocalNodeService &lns,
             neighbor::NeighborService &ns,
             DiscoveryCache &discovery_cache,
             const local::LocalNodeInfo &local,
             const ReceivedDiscoveryFrame &frame,
             TotalCost total_cost,
+            util::Time &time,
             util::Rand &rand
         ) {
             FASSERT(etl::holds_alternative<etl::monostate>(task_));
@@ -43,7 +92,7 @@ namespace net::discovery {
                 if (frame.type == DiscoveryFrameType::Request) {
                     // Requestであれば探索元に返信する
                     task_ = task::SendFrameTask::reply(
-                        frame, local, frame_id_cache_, node::Cost(0), rand
+                        frame, local, duplicate_detector_, node::Cost(0), rand
                     );
                     return etl::nullopt;
                 } else {
@@ -52,17 +101,19 @@ namespace net::discovery {
                 }
             }
 
-            auto opt_node_id_cache = discovery_cache.get_by_node_id(destination.node_id);
+            auto opt_node_id_cache = discovery_cache.get_by_node_id(
+                destination.node_id, DiscoveryCache::is_neighbor(ns)
+            );
             if (opt_node_id_cache.has_value()) {
                 if (frame.type == DiscoveryFrameType::Request) {
                     // キャッシュからゲートウェイを取得して返信する
                     task_ = task::SendFrameTask::reply_by_cache(
-                        frame, local, frame_id_cache_, opt_node_id_cache->get(), rand
+                        frame, local, duplicate_detector_, *opt_node_id_cache, rand
                     );
                 } else {
                     // Replyであれば中継する
                     task_ = task::SendFrameTask::repeat_unicast(
-                        frame, local, total_cost, opt_node_id_cache->get().gateway_id
+                        frame, local, total_cost, opt_node_id_cache->gateway_id
                     );
                 }
                 return etl::nullopt;
@@ -72,7 +123,9 @@ namespace net::discovery {
             if (opt_link_cost.has_value()) {
                 if (frame.type == DiscoveryFrameType::Request) {
                     auto cost = *opt_link_cost + local.cost;
-                    task_ = task::SendFrameTask::reply(frame, local, frame_id_cache_, cost, rand);
+                    task_ = task::SendFrameTask::reply(
+                        frame, local, duplicate_detector_, cost, rand
+                    );
                 } else {
                     task_ = task::SendFrameTask::repeat_unicast(
                         frame, local, total_cost, destination.node_id
@@ -81,23 +134,25 @@ namespace net::discovery {
                 return etl::nullopt;
             }
 
-            auto opt_cluster_id_cache = discovery_cache.get_by_cluster_id(destination.cluster_id);
+            auto opt_cluster_id_cache = discovery_cache.get_by_cluster_id(
+                destination.cluster_id, DiscoveryCache::is_neighbor(ns)
+            );
             if (opt_cluster_id_cache.has_value()) {
                 if (local.source.cluster_id.has_value() &&
                     local.source.cluster_id == destination.cluster_id) {
                     // 自ノードとクラスタIDが一致する場合，ブロードキャスト
-                    task_ = task::SendFrameTask::repeat_broadcast(frame, local, total_cost);
+                    repeat_broadcast(lns, local, frame, total_cost, time, rand);
                 } else {
                     // クラスタIDが異なる場合，キャッシュのゲートウェイに中継する
                     task_ = task::SendFrameTask::repeat_unicast(
-                        frame, local, total_cost, opt_cluster_id_cache->get().gateway_id
+                        frame, local, total_cost, opt_cluster_id_cache->gateway_id
                     );
                 }
                 return etl::nullopt;
             }
 
             // 探索対象がキャッシュにない場合，ブロードキャストする
-            task_ = task::SendFrameTask::repeat_broadcast(frame, local, total_cost);
+            repeat_broadcast(lns, local, frame, total_cost, time, rand);
             return etl::nullopt;
         }
 
@@ -112,6 +167,7 @@ namespace net::discovery {
             util::Rand &rand
         ) {
             socket_.execute(ms, lns, ns, time);
+            poll_assessing_broadcast(time);
 
             if (etl::holds_alternative<etl::monostate>(task_)) {
                 auto &&poll_frame = socket_.poll_receive_frame(time);
@@ -123,7 +179,7 @@ namespace net::discovery {
             if (etl::holds_alternative<task::ReceiveFrameTask>(task_)) {
                 nb::Poll<etl::optional<ReceivedDiscoveryFrame>> &&poll_opt_frame =
                     etl::get<task::ReceiveFrameTask>(task_).execute(
-                        ns, frame_id_cache_, local, time
+                        ns, duplicate_detector_, local, time
                     );
                 if (poll_opt_frame.is_pending()) {
                     return etl::nullopt;
@@ -144,7 +200,7 @@ namespace net::discovery {
                 discovery_cache.update_by_received_frame(frame, total_cost, time);
 
                 const auto &opt_event = switch_task_by_received_frame(
-                    ns, discovery_cache, local, frame, total_cost, rand
+                    lns, ns, discovery_cache, local, frame, total_cost, time, rand
                 );
                 if (opt_event.has_value()) {
                     return opt_event;
@@ -167,7 +223,7 @@ namespace net::discovery {
             util::Rand &rand
         ) {
             if (etl::holds_alternative<etl::monostate>(task_)) {
-                task_ = task::SendFrameTask::request(destination, local, frame_id_cache_, rand);
+                task_ = task::SendFrameTask::request(destination, local, duplicate_detector_, rand);
                 return nb::ready();
             } else {
                 return nb::pending;
@@ -14,7 +14,7 @@ namespace net::discovery::task {
         template <uint8_t N>
         inline nb::Poll<etl::optional<ReceivedDiscoveryFrame>> execute(
             neighbor::NeighborService &ns,
-            frame::FrameIdCache<N> &frame_id_cache,
+            frame::DuplicateDetector<N> &duplicate_detector,
             const local::LocalNodeInfo &local,
             util::Time &time
         ) {
@@ -24,7 +24,8 @@ namespace net::discovery::task {
             }
 
             auto &&frame = deserializer_.received_result(frame_);
-            if (frame_id_cache.insert_and_check_contains(frame.frame_id)) {
+            uint8_t source_hash = frame.source.node_id.hash();
+            if (duplicate_detector.insert_and_check_contains(source_hash, frame.frame_id, time)) {
                 return etl::optional<ReceivedDiscoveryFrame>{};
             }
 
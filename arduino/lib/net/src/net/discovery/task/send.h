@@ -32,46 +32,56 @@ namespace net::discovery::task {
               state_{CreateFrame{AsyncDiscoveryFrameSerializer{frame}}} {}
 
       public:
-        template <uint8_t FRAME_ID_CACHE_SIZE>
+        template <uint8_t N>
         static SendFrameTask request(
             const node::Destination &destination,
             const local::LocalNodeInfo &local,
-            frame::FrameIdCache<FRAME_ID_CACHE_SIZE> &frame_id_cache,
+            frame::DuplicateDetector<N> &duplicate_detector,
             util::Rand &rand
         ) {
             return SendFrameTask{
                 BroadcastDestination{etl::nullopt},
                 ReceivedDiscoveryFrame::request(
-                    frame_id_cache.generate(rand), local.source, destination
+                    duplicate_detector.generate(local.source.node_id.hash(), rand),
+                    local.source,
+                    destination
                 ),
             };
         }
 
-        template <uint8_t FRAME_ID_CACHE_SIZE>
+        // 応答は探索を開始したノードを送信元とするため，そのハッシュ値でフレームIDを記録する
+        template <uint8_t N>
         static SendFrameTask reply(
             const ReceivedDiscoveryFrame &received_frame,
             const local::LocalNodeInfo &local,
-            frame::FrameIdCache<FRAME_ID_CACHE_SIZE> &frame_id_cache,
+            frame::DuplicateDetector<N> &duplicate_detector,
             node::Cost total_cost,
             util::Rand &rand
         ) {
             return SendFrameTask{
                 UnicastDestination{received_frame.previousHop},
-                received_frame.reply(frame_id_cache.generate(rand), local.source, total_cost)
+                received_frame.reply(
+                    duplicate_detector.generate(received_frame.source.node_id.hash(), rand),
+                    local.source,
+                    total_cost
+                )
             };
         }
 
+        template <uint8_t N>
         static SendFrameTask reply_by_cache(
             const ReceivedDiscoveryFrame &received_frame,
             const local::LocalNodeInfo &local,
-            frame::FrameIdCache<FRAME_ID_CACHE_SIZE> &frame_id_cache,
+            frame::DuplicateDetector<N> &duplicate_detector,
             const CacheValue &cache,
             util::Rand &rand
         ) {
             return SendFrameTask{
                 UnicastDestination{received_frame.previousHop},
                 received_frame.reply_by_cache(
-                    frame_id_cache.generate(rand), local.source, cache.total_cost
+                    duplicate_detector.generate(received_frame.source.node_id.hash(), rand),
+                    local.source,
+                    cache.total_cost
                 )
             };
         }
@@ -43,6 +43,24 @@ namespace net::frame {
             return buffer_ref_.written_buffer().subspan(prev_read_index, length);
         }
 
+        // 読み込み位置を進めずに，未読の書き込み済み領域を返す
+        inline etl::span<const uint8_t> readable_buffer() const {
+            return buffer_ref_.written_buffer().subspan(read_index_);
+        }
+
+        // `readable_buffer`から取り出した分だけ読み込み位置を進める
+        inline void consume_unchecked(uint8_t length) {
+            FASSERT(length <= readable_length());
+            read_index_ += length;
+        }
+
+        inline uint8_t read_into(etl::span<uint8_t> dest) {
+            uint8_t length = etl::min(static_cast<uint8_t>(dest.size()), readable_length());
+            auto src = read_buffer_unchecked(length);
+            etl::copy(src.begin(), src.end(), dest.begin());
+            return length;
+        }
+
         inline nb::Poll<nb::de::DeserializeResult> read(uint8_t &dest) {
             SERDE_DESERIALIZE_OR_RETURN(poll_readable(1));
             dest = read_unchecked();
@@ -109,7 +127,17 @@ namespace net::frame {
             while (!reader_.is_all_read()) {
                 POLL_UNWRAP_OR_RETURN(reader_.poll_readable(1));
                 SERDE_SERIALIZE_OR_RETURN(writable.poll_writable(1));
-                writable.write_unchecked(reader_.read_unchecked());
+
+                // バッファの書き込み済み領域をまとめて渡し，実際に書き込まれた分だけ読み進める
+                if constexpr (nb::AsyncBulkWritable<Writable>) {
+                    uint8_t written = writable.write_from(reader_.readable_buffer());
+                    if (written == 0) {
+                        return nb::pending;
+                    }
+                    reader_.consume_unchecked(written);
+                } else {
+                    writable.write_unchecked(reader_.read_unchecked());
+                }
             }
             return nb::ser::SerializeResult::Ok;
         }
@@ -164,6 +192,24 @@ namespace net::frame {
             return buffer_ref_.write_buffer_unchecked(length);
         }
 
+        // 書き込み位置を進めずに，未書き込みの領域を返す
+        inline etl::span<uint8_t> writable_buffer() const {
+            return buffer_ref_.unwritten_buffer();
+        }
+
+        // `writable_buffer`へ直接書き込んだ分だけ書き込み位置を進める
+        inline void commit_unchecked(uint8_t length) {
+            FASSERT(length <= writable_length());
+            buffer_ref_.write_buffer_unchecked(length);
+        }
+
+        inline uint8_t write_from(etl::span<const uint8_t> src) {
+            uint8_t length = etl::min(static_cast<uint8_t>(src.size()), writable_length());
+            auto dest = write_buffer_unchecked(length);
+            etl::copy_n(src.begin(), length, dest.begin());
+            return length;
+        }
+
         template <nb::ser::AsyncSerializable<FrameBufferWriter> Serializable>
         nb::Poll<nb::ser::SerializeResult> serialize(Serializable &serializable) {
             return serializable.serialize(*this);
@@ -206,7 +252,16 @@ namespace net::frame {
         nb::Poll<nb::de::DeserializeResult> deserialize(Readable &readable) {
             while (!writer_.is_all_written()) {
                 SERDE_DESERIALIZE_OR_RETURN(readable.poll_readable(1));
-                writer_.write_unchecked(readable.read_unchecked());
+                // 実際に読み込まれた分だけ書き込み位置を進める
+                if constexpr (nb::AsyncBulkReadable<Readable>) {
+                    uint8_t read = readable.read_into(writer_.writable_buffer());
+                    if (read == 0) {
+                        return nb::pending;
+                    }
+                    writer_.commit_unchecked(read);
+                } else {
+                    writer_.write_unchecked(readable.read_unchecked());
+                }
             }
             return nb::de::DeserializeResult::Ok;
         }
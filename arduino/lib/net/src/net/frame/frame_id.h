@@ -1,14 +1,18 @@
 #pragma once
 
-#include <etl/circular_buffer.h>
+#include <etl/array.h>
+#include <etl/optional.h>
 #include <nb/serde.h>
 #include <stdint.h>
+#include <tl/index_table.h>
+#include <tl/vec.h>
 #include <util/rand.h>
+#include <util/time.h>
 
 namespace net::frame {
     class FrameId {
-        template <uint8_t MAX_CACHE_SIZE>
-        friend class FrameIdCache;
+        template <uint8_t CAPACITY>
+        friend class DuplicateDetector;
         friend class AsyncFrameIdDeserializer;
         friend class AsyncFrameIdSerializer;
 
@@ -66,34 +70,171 @@ namespace net::frame {
         }
     };
 
-    template <uint8_t MAX_CACHE_SIZE>
-    class FrameIdCache {
-        etl::circular_buffer<FrameId, MAX_CACHE_SIZE> cache_{};
+    /**
+     * 送信元とフレームIDの組をもとに，最近受信したフレームの重複を検出する．
+     *
+     * 記録は2つの世代に分けて保持する．現在の世代が`CAPACITY / 2`個で満杯になるか，
+     * 世代を始めてから`window / 2`が経過すると，古い世代を捨てて新しい世代を始める．
+     * そのため，直近の少なくとも`CAPACITY / 2`個のフレームを，おおよそ`window`の間記録する．
+     * 送信元はハッシュ値のみを保持するため，ハッシュ値とフレームIDの両方が衝突した場合は重複とみなす．
+     */
+    template <uint8_t CAPACITY>
+    class DuplicateDetector {
+        static_assert(CAPACITY >= 2 && CAPACITY % 2 == 0);
+
+        static constexpr uint8_t GENERATION_SIZE = CAPACITY / 2;
+
+        struct Key {
+            uint8_t source_hash;
+            FrameId id;
+
+            inline bool operator==(const Key &other) const {
+                return source_hash == other.source_hash && id == other.id;
+            }
+
+            inline uint8_t hash() const {
+                return source_hash ^ static_cast<uint8_t>(id.get()) ^
+                    static_cast<uint8_t>(id.get() >> 8);
+            }
+        };
+
+        struct Entry {
+            Key key;
+            uint8_t duplicate_count;
+        };
+
+        class Generation {
+            tl::Vec<Entry, GENERATION_SIZE> entries_{};
+            tl::IndexTable<tl::index_table_slot_count<GENERATION_SIZE>()> index_{};
+
+          public:
+            inline bool full() const {
+                return entries_.full();
+            }
+
+            inline etl::optional<uint8_t> find(const Key &key) const {
+                return index_.find(key.hash(), [&](uint8_t i) { return entries_[i].key == key; });
+            }
+
+            inline Entry &get(uint8_t index) {
+                return entries_[index];
+            }
+
+            inline const Entry &get(uint8_t index) const {
+                return entries_[index];
+            }
+
+            inline void insert(const Key &key) {
+                FASSERT(!entries_.full());
+                index_.insert(key.hash(), entries_.size());
+                entries_.push_back(Entry{.key = key, .duplicate_count = 0});
+            }
+
+            inline void clear() {
+                entries_.clear();
+                index_.clear();
+            }
+        };
 
-        inline bool contains(FrameId id) const {
-            return etl::any_of(cache_.begin(), cache_.end(), [id](FrameId other) {
-                return id == other;
-            });
+        etl::array<Generation, 2> generations_{};
+        uint8_t current_{0};
+        util::Duration window_;
+        etl::optional<util::Instant> generation_started_{};
+
+        inline void rotate() {
+            current_ ^= 1;
+            generations_[current_].clear();
+        }
+
+        void rotate_if_expired(util::Instant now) {
+            if (!generation_started_) {
+                generation_started_ = now;
+                return;
+            }
+
+            auto elapsed = now - *generation_started_;
+            if (elapsed * 2 < window_) {
+                return;
+            }
+
+            rotate();
+            if (elapsed >= window_) {
+                rotate();
+            }
+            generation_started_ = now;
+        }
+
+        struct Location {
+            uint8_t generation;
+            uint8_t index;
+        };
+
+        etl::optional<Location> locate(const Key &key) const {
+            for (uint8_t i = 0; i < generations_.size(); i++) {
+                auto opt_index = generations_[i].find(key);
+                if (opt_index.has_value()) {
+                    return Location{.generation = i, .index = *opt_index};
+                }
+            }
+            return etl::nullopt;
+        }
+
+        // 世代を入れ替えた場合は`true`を返す
+        inline bool insert(const Key &key) {
+            bool rotated = generations_[current_].full();
+            if (rotated) {
+                rotate();
+            }
+            generations_[current_].insert(key);
+            return rotated;
         }
 
       public:
-        FrameIdCache() = default;
+        explicit DuplicateDetector(util::Duration window) : window_{window} {}
+
+        /**
+         * フレームを記録し，既に記録されていたかを返す．
+         * `source_hash`はフレームの送信元ノードのハッシュ値．
+         */
+        bool insert_and_check_contains(uint8_t source_hash, FrameId id, util::Time &time) {
+            auto now = time.now();
+            rotate_if_expired(now);
+
+            Key key{.source_hash = source_hash, .id = id};
+            auto opt_location = locate(key);
+            if (opt_location.has_value()) {
+                auto &entry = generations_[opt_location->generation].get(opt_location->index);
+                if (entry.duplicate_count < 0xFF) {
+                    entry.duplicate_count++;
+                }
+                return true;
+            }
+            if (insert(key)) {
+                generation_started_ = now;
+            }
+            return false;
+        }
 
-        inline bool insert_and_check_contains(FrameId id) {
-            bool result = contains(id);
-            if (!result) {
-                cache_.push(id);
+        /**
+         * 記録されていないフレームIDを生成して記録し，自ノードが送信したフレームの再受信を防ぐ．
+         * 時刻を受け取らないため，世代の経過時間は次にフレームを受信したときに判定する．
+         */
+        FrameId generate(uint8_t source_hash, util::Rand &rand) {
+            Key key{.source_hash = source_hash, .id = FrameId::random(rand)};
+            while (locate(key).has_value()) {
+                key.id = FrameId::random(rand);
             }
-            return result;
+            insert(key);
+            return key.id;
         }
 
-        inline FrameId generate(util::Rand &rand) {
-            FrameId id = FrameId::random(rand);
-            while (contains(id)) {
-                id = FrameId::random(rand);
+        // 記録されているフレームを，最初の受信の後に重複して受信した回数
+        uint8_t duplicate_count(uint8_t source_hash, FrameId id) const {
+            auto opt_location = locate(Key{.source_hash = source_hash, .id = id});
+            if (!opt_location.has_value()) {
+                return 0;
             }
-            cache_.push(id);
-            return id;
+            return generations_[opt_location->generation].get(opt_location->index).duplicate_count;
         }
     };
 } // namespace net::frame
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <nb/serde.h>
+#include <stdint.h>
+
+namespace net::frame {
+    class FrameBufferPoolMeasurement {
+        uint8_t high_water_mark_{0};
+        uint16_t failed_count_{0};
+        uint16_t fallback_count_{0};
+        bool exhausted_{false};
+
+      public:
+        inline void on_allocated(uint8_t in_use) {
+            if (in_use > high_water_mark_) {
+                high_water_mark_ = in_use;
+            }
+            exhausted_ = false;
+        }
+
+        /**
+         * 確保に失敗したことを記録する．pendingを返すたびに呼ばれる．
+         *
+         * 待っている要求は確保できるまで毎回ポーリングするため，ポーリングの回数ではなく，
+         * 確保できていた状態から枯渇した回数を`failed_count`として数える．
+         *
+         * @return 直前まで確保できていた場合はtrue
+         */
+        inline bool on_allocation_failed() {
+            if (exhausted_) {
+                return false;
+            }
+
+            exhausted_ = true;
+            if (failed_count_ != UINT16_MAX) {
+                failed_count_++;
+            }
+            return true;
+        }
+
+        // 枯渇のため，より大きいサイズクラスから借りて確保した回数
+        inline void on_fallback() {
+            if (fallback_count_ != UINT16_MAX) {
+                fallback_count_++;
+            }
+            exhausted_ = false;
+        }
+
+        inline uint8_t high_water_mark() const {
+            return high_water_mark_;
+        }
+
+        inline uint16_t failed_count() const {
+            return failed_count_;
+        }
+
+        inline uint16_t fallback_count() const {
+            return fallback_count_;
+        }
+
+        inline void reset(uint8_t in_use) {
+            high_water_mark_ = in_use;
+            failed_count_ = 0;
+            fallback_count_ = 0;
+        }
+    };
+
+    struct FrameBufferPoolStats {
+        uint8_t buffer_length;
+        uint8_t capacity;
+        uint8_t in_use;
+        uint8_t high_water_mark;
+        uint16_t failed_count;
+        uint16_t fallback_count;
+    };
+
+    class AsyncFrameBufferPoolStatsSerializer {
+        nb::ser::Bin<uint8_t> buffer_length_;
+        nb::ser::Bin<uint8_t> capacity_;
+        nb::ser::Bin<uint8_t> in_use_;
+        nb::ser::Bin<uint8_t> high_water_mark_;
+        nb::ser::Bin<uint16_t> failed_count_;
+        nb::ser::Bin<uint16_t> fallback_count_;
+
+      public:
+        explicit AsyncFrameBufferPoolStatsSerializer(const FrameBufferPoolStats &stats)
+            : buffer_length_{stats.buffer_length},
+              capacity_{stats.capacity},
+              in_use_{stats.in_use},
+              high_water_mark_{stats.high_water_mark},
+              failed_count_{stats.failed_count},
+              fallback_count_{stats.fallback_count} {}
+
+        template <nb::ser::AsyncWritable W>
+        nb::Poll<nb::ser::SerializeResult> serialize(W &writable) {
+            SERDE_SERIALIZE_OR_RETURN(buffer_length_.serialize(writable));
+            SERDE_SERIALIZE_OR_RETURN(capacity_.serialize(writable));
+            SERDE_SERIALIZE_OR_RETURN(in_use_.serialize(writable));
+            SERDE_SERIALIZE_OR_RETURN(high_water_mark_.serialize(writable));
+            SERDE_SERIALIZE_OR_RETURN(failed_count_.serialize(writable));
+            return fallback_count_.serialize(writable);
+        }
+
+        inline constexpr uint8_t serialized_length() const {
+            return buffer_length_.serialized_length() + capacity_.serialized_length() +
+                in_use_.serialized_length() + high_water_mark_.serialized_length() +
+                failed_count_.serialized_length() + fallback_count_.serialized_length();
+        }
+    };
+} // namespace net::frame
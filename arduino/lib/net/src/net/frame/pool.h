@@ -1,6 +1,8 @@
 #pragma once
 
 #include "./fields.h"
+#include "./measurement.h"
+#include <etl/array.h>
 #include <etl/utility.h>
 #include <memory/rc_pool.h>
 #include <nb/serde.h>
@@ -12,7 +14,7 @@ namespace net::frame {
         uint8_t length;
         uint8_t written_index;
 
-        explicit inline FrameBuffer(uint8_t len) : length{len} {}
+        explicit inline FrameBuffer(uint8_t len) : length{len}, written_index{0} {}
     };
 
     class VariadicFrameBuffer {
@@ -136,6 +138,11 @@ namespace net::frame {
             *written_index_ += length;
             return etl::span<uint8_t>{begin, length};
         }
+
+        // 書き込み位置を進めずに，未書き込みの領域を返す
+        inline etl::span<uint8_t> unwritten_buffer() const {
+            return buffer_.subspan(begin_index_ + written_index(), length_ - written_index());
+        }
     };
 
     class FrameBufferReference {
@@ -145,7 +152,9 @@ namespace net::frame {
         FrameBufferReference(memory::RcPoolCounter *counter, VariadicFrameBuffer &&buffer)
             : counter_{counter},
               buffer_{etl::move(buffer)} {
-            counter_->increment();
+            if (counter_ != nullptr) {
+                counter_->increment();
+            }
         }
 
       public:
@@ -226,11 +235,32 @@ namespace net::frame {
         inline etl::span<uint8_t> write_buffer_unchecked(uint8_t length) {
             return buffer_.write_buffer_unchecked(length);
         }
+
+        inline etl::span<uint8_t> unwritten_buffer() const {
+            return buffer_.unwritten_buffer();
+        }
+    };
+
+    template <uint8_t BUFFER_LENGTH, uint8_t BUFFER_COUNT>
+    class FrameBufferPool {
+        template <uint8_t>
+        friend class FrameBufferPoolReference;
+
+        memory::Static<memory::RcPool<FrameBuffer<BUFFER_LENGTH>, BUFFER_COUNT>> pool_;
+        FrameBufferPoolMeasurement measurement_;
+
+      public:
+        FrameBufferPool() = default;
+        FrameBufferPool(const FrameBufferPool &) = delete;
+        FrameBufferPool(FrameBufferPool &&) = delete;
+        FrameBufferPool &operator=(const FrameBufferPool &) = delete;
+        FrameBufferPool &operator=(FrameBufferPool &&) = delete;
     };
 
     template <uint8_t BUFFER_LENGTH>
     class FrameBufferPoolReference {
         memory::RcPoolRef<FrameBuffer<BUFFER_LENGTH>> ipool_;
+        FrameBufferPoolMeasurement *measurement_;
 
       public:
         FrameBufferPoolReference() = delete;
@@ -240,12 +270,14 @@ namespace net::frame {
         FrameBufferPoolReference &operator=(FrameBufferPoolReference &&) = default;
 
         template <uint8_t BUFFER_COUNT>
-        explicit FrameBufferPoolReference(
-            memory::Static<memory::RcPool<FrameBuffer<BUFFER_LENGTH>, BUFFER_COUNT>> &pool
-        )
-            : ipool_{pool} {}
+        explicit FrameBufferPoolReference(FrameBufferPool<BUFFER_LENGTH, BUFFER_COUNT> &pool)
+            : ipool_{pool.pool_},
+              measurement_{&pool.measurement_} {}
 
+        // 失敗時の計測は，フォールバックを含めて判断する`FrameBufferAllocator`が行う
         nb::Poll<FrameBufferReference> allocate(uint8_t length) {
+            FASSERT(length <= BUFFER_LENGTH);
+
             auto result = ipool_.allocate();
             if (!result.has_value()) {
                 return nb::pending;
@@ -253,17 +285,85 @@ namespace net::frame {
 
             auto [counter, buffer] = result.value();
             new (buffer) FrameBuffer<BUFFER_LENGTH>{length};
-            return FrameBufferReference{counter, buffer};
+            FrameBufferReference ref{counter, buffer};
+            measurement_->on_allocated(ipool_.in_use_count());
+            return ref;
+        }
+
+        inline void on_fallback() {
+            measurement_->on_fallback();
+        }
+
+        inline bool on_allocation_failed() {
+            return measurement_->on_allocation_failed();
+        }
+
+        inline FrameBufferPoolStats stats() const {
+            return FrameBufferPoolStats{
+                .buffer_length = BUFFER_LENGTH,
+                .capacity = ipool_.capacity(),
+                .in_use = ipool_.in_use_count(),
+                .high_water_mark = measurement_->high_water_mark(),
+                .failed_count = measurement_->failed_count(),
+                .fallback_count = measurement_->fallback_count(),
+            };
+        }
+
+        inline void reset_stats() {
+            measurement_->reset(ipool_.in_use_count());
         }
     };
 
     static constexpr uint8_t SHORT_BUFFER_LENGTH = 32;
+    static constexpr uint8_t MEDIUM_BUFFER_LENGTH = 96;
     static constexpr uint8_t LARGE_BUFFER_LENGTH = MTU;
 
+    static constexpr uint8_t FRAME_BUFFER_POOL_COUNT = 3;
+    using FrameBufferPoolStatsArray = etl::array<FrameBufferPoolStats, FRAME_BUFFER_POOL_COUNT>;
+
+    /**
+     * 要求された長さを格納できる最小のサイズクラスから確保する．
+     *
+     * そのクラスが枯渇している場合は，より大きいクラスから借りて確保する．
+     * どのクラスからも確保できない場合のみpendingを返す．
+     */
     class FrameBufferAllocator {
         FrameBufferPoolReference<SHORT_BUFFER_LENGTH> short_pool_ref_;
+        FrameBufferPoolReference<MEDIUM_BUFFER_LENGTH> medium_pool_ref_;
         FrameBufferPoolReference<LARGE_BUFFER_LENGTH> large_pool_ref_;
 
+        static inline nb::Poll<FrameBufferReference> allocate_from_larger(uint8_t) {
+            return nb::pending;
+        }
+
+        template <typename Pool, typename... Pools>
+        static nb::Poll<FrameBufferReference>
+        allocate_from_larger(uint8_t length, Pool &pool, Pools &...pools) {
+            auto poll = pool.allocate(length);
+            if (poll.is_ready()) {
+                return poll;
+            }
+            return allocate_from_larger(length, pools...);
+        }
+
+        template <typename Pool, typename... LargerPools>
+        static nb::Poll<FrameBufferReference>
+        allocate_with_fallback(uint8_t length, Pool &pool, LargerPools &...larger_pools) {
+            auto poll = pool.allocate(length);
+            if (poll.is_ready()) {
+                return poll;
+            }
+
+            auto fallback_poll = allocate_from_larger(length, larger_pools...);
+            if (fallback_poll.is_ready()) {
+                pool.on_fallback();
+            } else if (pool.on_allocation_failed()) {
+                // pendingの間は毎回ポーリングされるため，枯渇した時点で一度だけ出力する
+                LOG_WARNING(FLASH_STRING("Pool full: "), length);
+            }
+            return fallback_poll;
+        }
+
       public:
         FrameBufferAllocator() = delete;
         FrameBufferAllocator(const FrameBufferAllocator &) = default;
@@ -271,14 +371,17 @@ namespace net::frame {
         FrameBufferAllocator &operator=(const FrameBufferAllocator &) = delete;
         FrameBufferAllocator &operator=(FrameBufferAllocator &&) = delete;
 
-        template <uint8_t SHORT_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
+        template <
+            uint8_t SHORT_BUFFER_COUNT,
+            uint8_t MEDIUM_BUFFER_COUNT,
+            uint8_t LARGE_BUFFER_COUNT>
         FrameBufferAllocator(
-            memory::Static<memory::RcPool<FrameBuffer<SHORT_BUFFER_LENGTH>, SHORT_BUFFER_COUNT>>
-                &short_pool,
-            memory::Static<memory::RcPool<FrameBuffer<LARGE_BUFFER_LENGTH>, LARGE_BUFFER_COUNT>>
-                &large_pool
+            FrameBufferPool<SHORT_BUFFER_LENGTH, SHORT_BUFFER_COUNT> &short_pool,
+            FrameBufferPool<MEDIUM_BUFFER_LENGTH, MEDIUM_BUFFER_COUNT> &medium_pool,
+            FrameBufferPool<LARGE_BUFFER_LENGTH, LARGE_BUFFER_COUNT> &large_pool
         )
             : short_pool_ref_{short_pool},
+              medium_pool_ref_{medium_pool},
               large_pool_ref_{large_pool} {}
 
         inline nb::Poll<FrameBufferReference> allocate(uint8_t length) {
@@ -286,25 +389,49 @@ namespace net::frame {
                 return FrameBufferReference::empty();
             }
             if (length <= SHORT_BUFFER_LENGTH) {
-                return short_pool_ref_.allocate(length);
+                return allocate_with_fallback(
+                    length, short_pool_ref_, medium_pool_ref_, large_pool_ref_
+                );
+            }
+            if (length <= MEDIUM_BUFFER_LENGTH) {
+                return allocate_with_fallback(length, medium_pool_ref_, large_pool_ref_);
             }
-            return large_pool_ref_.allocate(length);
+            return allocate_with_fallback(length, large_pool_ref_);
         }
 
         inline nb::Poll<FrameBufferReference> allocate_max_length() {
-            return large_pool_ref_.allocate(LARGE_BUFFER_LENGTH);
+            return allocate_with_fallback(LARGE_BUFFER_LENGTH, large_pool_ref_);
+        }
+
+        inline FrameBufferPoolStatsArray stats() const {
+            return FrameBufferPoolStatsArray{
+                short_pool_ref_.stats(),
+                medium_pool_ref_.stats(),
+                large_pool_ref_.stats(),
+            };
+        }
+
+        inline void reset_stats() {
+            short_pool_ref_.reset_stats();
+            medium_pool_ref_.reset_stats();
+            large_pool_ref_.reset_stats();
         }
     };
 
-    template <uint8_t SHORT_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
+    /**
+     * サイズクラスごとにバッファ数を指定できるフレームバッファプール．
+     *
+     * バッファ数に0を指定したクラスは常に枯渇しているものとして扱われ，より大きいクラスから確保される．
+     */
+    template <uint8_t SHORT_BUFFER_COUNT, uint8_t MEDIUM_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
     class MultiSizeFrameBufferPool {
-        memory::Static<memory::RcPool<FrameBuffer<SHORT_BUFFER_LENGTH>, SHORT_BUFFER_COUNT>>
-            short_pool_;
-        memory::Static<memory::RcPool<FrameBuffer<LARGE_BUFFER_LENGTH>, LARGE_BUFFER_COUNT>>
-            large_pool_;
+        FrameBufferPool<SHORT_BUFFER_LENGTH, SHORT_BUFFER_COUNT> short_pool_;
+        FrameBufferPool<MEDIUM_BUFFER_LENGTH, MEDIUM_BUFFER_COUNT> medium_pool_;
+        FrameBufferPool<LARGE_BUFFER_LENGTH, LARGE_BUFFER_COUNT> large_pool_;
 
       public:
-        static constexpr uint8_t MAX_FRAME_COUNT = SHORT_BUFFER_COUNT + LARGE_BUFFER_COUNT;
+        static constexpr uint8_t MAX_FRAME_COUNT =
+            SHORT_BUFFER_COUNT + MEDIUM_BUFFER_COUNT + LARGE_BUFFER_COUNT;
 
         MultiSizeFrameBufferPool() = default;
         MultiSizeFrameBufferPool(const MultiSizeFrameBufferPool &) = delete;
@@ -313,7 +440,7 @@ namespace net::frame {
         MultiSizeFrameBufferPool &operator=(MultiSizeFrameBufferPool &&) = delete;
 
         inline FrameBufferAllocator allocator() {
-            return FrameBufferAllocator{short_pool_, large_pool_};
+            return FrameBufferAllocator{short_pool_, medium_pool_, large_pool_};
         }
     };
 
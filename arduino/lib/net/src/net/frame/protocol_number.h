@@ -12,9 +12,10 @@ namespace net::frame {
         Rpc = 0x03,
         Observer = 0x04,
         Tunnel = 0x05,
+        RouteAdvertisement = 0x06,
     };
 
-    inline constexpr uint8_t NUM_PROTOCOLS = 6;
+    inline constexpr uint8_t NUM_PROTOCOLS = 7;
 
     inline constexpr bool is_valid_protocol_number(uint8_t protocol_number) {
         return protocol_number < NUM_PROTOCOLS;
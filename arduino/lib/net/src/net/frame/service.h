@@ -17,10 +17,14 @@ namespace net::frame {
         FrameService &operator=(const FrameService &) = delete;
         FrameService &operator=(FrameService &&) = delete;
 
-        template <uint8_t SHORT_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
-        FrameService(
-            memory::Static<MultiSizeFrameBufferPool<SHORT_BUFFER_COUNT, LARGE_BUFFER_COUNT>> &pool
-        )
+        template <
+            uint8_t SHORT_BUFFER_COUNT,
+            uint8_t MEDIUM_BUFFER_COUNT,
+            uint8_t LARGE_BUFFER_COUNT>
+        FrameService(memory::Static<MultiSizeFrameBufferPool<
+                         SHORT_BUFFER_COUNT,
+                         MEDIUM_BUFFER_COUNT,
+                         LARGE_BUFFER_COUNT>> &pool)
             : allocator_{pool->allocator()} {}
 
         nb::Poll<FrameBufferWriter> request_frame_writer(uint8_t length) {
@@ -32,5 +36,13 @@ namespace net::frame {
             auto buffer_ref = POLL_MOVE_UNWRAP_OR_RETURN(allocator_.allocate_max_length());
             return FrameBufferWriter{etl::move(buffer_ref)};
         }
+
+        inline FrameBufferPoolStatsArray pool_stats() const {
+            return allocator_.stats();
+        }
+
+        inline void reset_pool_stats() {
+            allocator_.reset_stats();
+        }
     };
 } // namespace net::frame
@@ -6,6 +6,7 @@
 #include <logger.h>
 #include <nb/poll.h>
 #include <nb/serde.h>
+#include <util/hash.h>
 
 namespace net::link {
     enum class AddressType : uint8_t {
@@ -122,6 +123,10 @@ namespace net::link {
             return 1 + get_address_body_length_of(type_);
         }
 
+        inline uint8_t hash() const {
+            return util::hash_bytes(static_cast<uint8_t>(type_), body());
+        }
+
         inline friend logger::log::Printer &
         operator<<(logger::log::Printer &printer, const Address &address) {
             printer << static_cast<uint8_t>(address.type()) << '(';
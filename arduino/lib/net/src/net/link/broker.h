@@ -1,12 +1,14 @@
 #pragma once
 
+#include "./codel.h"
 #include "./constants.h"
 #include "./measurement.h"
 #include "./media.h"
+#include "./priority.h"
 #include <memory/lifetime.h>
 #include <nb/time.h>
 #include <net/frame.h>
-#include <tl/vec.h>
+#include <tl/queue_set.h>
 
 namespace net::link {
     struct Entry {
@@ -15,10 +17,140 @@ namespace net::link {
     };
 
     class LinkFrameQueue {
-        tl::Vec<Entry, MAX_FRAME_BUFFER_SIZE> received_frame_;
-        tl::Vec<Entry, MAX_FRAME_BUFFER_SIZE> send_requested_frame_;
+        // 送信要求のキューは優先度毎に，単一ポート指定，アドレスタイプ指定（ポート未指定），
+        // 複数ポート指定の順に並ぶ
+        static constexpr uint8_t SEND_QUEUE_BY_ADDRESS_TYPE = MAX_MEDIA_PER_NODE;
+        static constexpr uint8_t SEND_QUEUE_MULTI_PORT =
+            SEND_QUEUE_BY_ADDRESS_TYPE + ADDRESS_TYPE_COUNT;
+        static constexpr uint8_t SEND_QUEUE_PER_PRIORITY = SEND_QUEUE_MULTI_PORT + 1;
+        static constexpr uint8_t SEND_QUEUE_COUNT = SEND_QUEUE_PER_PRIORITY * FRAME_PRIORITY_COUNT;
+
+        tl::QueueSet<Entry, MAX_FRAME_BUFFER_SIZE, frame::NUM_PROTOCOLS> received_frame_;
+        tl::QueueSet<Entry, MAX_FRAME_BUFFER_SIZE, SEND_QUEUE_COUNT> send_requested_frame_;
+        etl::array<uint16_t, FRAME_PRIORITY_COUNT> dropped_frame_count_{};
         nb::Debounce sweep_debounce_;
 
+        static inline uint8_t receive_queue_index(frame::ProtocolNumber protocol_number) {
+            return static_cast<uint8_t>(protocol_number);
+        }
+
+        static inline uint8_t address_type_queue_index(AddressType type) {
+            return SEND_QUEUE_BY_ADDRESS_TYPE + static_cast<uint8_t>(type) - 1;
+        }
+
+        static uint8_t send_queue_index(const LinkFrame &frame, FramePriority priority) {
+            uint8_t base = frame_priority_to_index(priority) * SEND_QUEUE_PER_PRIORITY;
+            if (frame.media_port_mask.is_unspecified()) {
+                return base + address_type_queue_index(frame.remote.type());
+            }
+
+            auto port = frame.media_port_mask.single_port();
+            if (port.has_value() && port->value() < MAX_MEDIA_PER_NODE) {
+                return base + port->value();
+            }
+            return base + SEND_QUEUE_MULTI_PORT;
+        }
+
+        static inline uint8_t send_queue_priority_index(uint8_t queue) {
+            return queue / SEND_QUEUE_PER_PRIORITY;
+        }
+
+        inline void on_send_frame_dropped(uint8_t priority_index) {
+            uint16_t &count = dropped_frame_count_[priority_index];
+            if (count != UINT16_MAX) {
+                count++;
+            }
+        }
+
+        // `priority`より優先度の低いフレームのうち，最も優先度が低く新しいものを1つ破棄する
+        bool evict_lower_priority_frame(FramePriority priority) {
+            uint8_t lowest = frame_priority_to_index(priority);
+            for (uint8_t p = FRAME_PRIORITY_COUNT - 1; p > lowest; p--) {
+                for (uint8_t i = 0; i < SEND_QUEUE_PER_PRIORITY; i++) {
+                    uint8_t queue = p * SEND_QUEUE_PER_PRIORITY + i;
+                    if (send_requested_frame_.empty(queue)) {
+                        continue;
+                    }
+
+                    auto entry = send_requested_frame_.pop_back(queue);
+                    LOG_INFO(FLASH_STRING("Evict send req frame: "), entry.frame.remote);
+                    on_send_frame_dropped(p);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        nb::Poll<LinkFrame> poll_get_send_requested_frame_of_priority(
+            uint8_t priority_index,
+            MediaPortNumber port,
+            link::AddressType address_type
+        ) {
+            // 送信可能なキューのうち，最も古いフレームを取り出す
+            uint8_t base = priority_index * SEND_QUEUE_PER_PRIORITY;
+            uint8_t candidate_queue = SEND_QUEUE_COUNT;
+            const Entry *candidate = nullptr;
+
+            uint8_t port_queue = base + port.value();
+            if (port.value() < MAX_MEDIA_PER_NODE && !send_requested_frame_.empty(port_queue)) {
+                candidate_queue = port_queue;
+                candidate = &send_requested_frame_.front(candidate_queue);
+            }
+
+            uint8_t type_queue = base + address_type_queue_index(address_type);
+            if (!send_requested_frame_.empty(type_queue)) {
+                const Entry *entry = &send_requested_frame_.front(type_queue);
+                if (is_older(entry, candidate)) {
+                    candidate_queue = type_queue;
+                    candidate = entry;
+                }
+            }
+
+            uint8_t multi_port_queue = base + SEND_QUEUE_MULTI_PORT;
+            auto is_for_port = [&](const Entry &entry) {
+                return entry.frame.media_port_mask.test(port);
+            };
+            const Entry *multi_port_entry =
+                send_requested_frame_.find_first_if(multi_port_queue, is_for_port);
+            if (is_older(multi_port_entry, candidate)) {
+                auto entry = send_requested_frame_.pop_first_if(multi_port_queue, is_for_port);
+                return etl::move(entry->frame);
+            }
+
+            if (candidate == nullptr) {
+                return nb::pending;
+            }
+            return send_requested_frame_.pop_front(candidate_queue).frame;
+        }
+
+        static inline bool is_older(const Entry *lhs, const Entry *rhs) {
+            if (lhs == nullptr) {
+                return false;
+            }
+            if (rhs == nullptr) {
+                return true;
+            }
+            return lhs->expiration.start() - rhs->expiration.start() <= util::Duration::zero();
+        }
+
+        template <uint8_t N, typename F>
+        static void drop_expired(
+            tl::QueueSet<Entry, MAX_FRAME_BUFFER_SIZE, N> &queues,
+            util::Time &time,
+            util::FlashStringType message,
+            F &&on_dropped
+        ) {
+            // 有効期限は全て同じ長さなので，期限切れのフレームは各キューの先頭に集まる
+            for (uint8_t queue = 0; queue < N; queue++) {
+                while (!queues.empty(queue) &&
+                       queues.front(queue).expiration.poll(time).is_ready()) {
+                    LOG_INFO(message, queues.front(queue).frame.remote);
+                    queues.pop_front(queue);
+                    on_dropped(queue);
+                }
+            }
+        }
+
       public:
         LinkFrameQueue() = delete;
         LinkFrameQueue(const LinkFrameQueue &) = delete;
@@ -33,21 +165,11 @@ namespace net::link {
                 return;
             }
 
-            for (uint8_t i = 0; i < received_frame_.size(); i++) {
-                auto &entry = received_frame_[i];
-                if (entry.expiration.poll(time).is_ready()) {
-                    LOG_INFO(FLASH_STRING("Drop recv frame: "), entry.frame.remote);
-                    received_frame_.remove(i);
-                }
-            }
-
-            for (uint8_t i = 0; i < send_requested_frame_.size(); i++) {
-                auto &entry = send_requested_frame_[i];
-                if (entry.expiration.poll(time).is_ready()) {
-                    LOG_INFO(FLASH_STRING("Drop send req frame: "), entry.frame.remote);
-                    send_requested_frame_.remove(i);
-                }
-            }
+            drop_expired(received_frame_, time, FLASH_STRING("Drop recv frame: "), [](uint8_t) {});
+            drop_expired(
+                send_requested_frame_, time, FLASH_STRING("Drop send req frame: "),
+                [&](uint8_t queue) { on_send_frame_dropped(send_queue_priority_index(queue)); }
+            );
         }
 
         nb::Poll<void> poll_dispatch_received_frame(
@@ -61,6 +183,7 @@ namespace net::link {
                 return nb::pending;
             } else {
                 received_frame_.emplace_back(
+                    receive_queue_index(protocol_number),
                     LinkFrame{
                         .media_port_mask = MediaPortMask::from_port_number(media_port),
                         .protocol_number = protocol_number,
@@ -73,13 +196,37 @@ namespace net::link {
             }
         }
 
-        nb::Poll<Entry> poll_receive_frame(frame::ProtocolNumber protocol_number) {
-            for (uint8_t i = 0; i < received_frame_.size(); i++) {
-                if (received_frame_[i].frame.protocol_number == protocol_number) {
-                    return received_frame_.remove(i);
+        inline bool is_received_frame_full() const {
+            return received_frame_.full();
+        }
+
+        // 各キューの先頭のうち最も古いフレームが`age`以上滞留している場合，それを取り出す
+        etl::optional<Entry> pop_received_frame_older_than(util::Duration age, util::Time &time) {
+            etl::optional<uint8_t> oldest_queue;
+            const Entry *oldest = nullptr;
+            for (uint8_t queue = 0; queue < frame::NUM_PROTOCOLS; queue++) {
+                if (received_frame_.empty(queue)) {
+                    continue;
+                }
+                const Entry *entry = &received_frame_.front(queue);
+                if (is_older(entry, oldest)) {
+                    oldest_queue = queue;
+                    oldest = entry;
                 }
             }
-            return nb::pending;
+
+            if (oldest == nullptr || time.now() - oldest->expiration.start() < age) {
+                return etl::nullopt;
+            }
+            return received_frame_.pop_front(*oldest_queue);
+        }
+
+        nb::Poll<Entry> poll_receive_frame(frame::ProtocolNumber protocol_number) {
+            uint8_t queue = receive_queue_index(protocol_number);
+            if (received_frame_.empty(queue)) {
+                return nb::pending;
+            }
+            return received_frame_.pop_front(queue);
         }
 
         nb::Poll<void> poll_request_send_frame(
@@ -87,48 +234,52 @@ namespace net::link {
             frame::ProtocolNumber protocol_number,
             const Address &remote,
             frame::FrameBufferReader &&reader,
+            FramePriority priority,
             util::Time &time
         ) {
-            if (send_requested_frame_.full()) {
+            if (send_requested_frame_.full() && !evict_lower_priority_frame(priority)) {
                 return nb::pending;
             }
 
+            LinkFrame frame{
+                .media_port_mask = media_port_mask,
+                .protocol_number = protocol_number,
+                .remote = remote,
+                .reader = reader.origin(),
+            };
+            uint8_t queue = send_queue_index(frame, priority);
             send_requested_frame_.emplace_back(
-                LinkFrame{
-                    .media_port_mask = media_port_mask,
-                    .protocol_number = protocol_number,
-                    .remote = remote,
-                    .reader = reader.origin(),
-                },
-                nb::Delay{time, FRAME_EXPIRATION}
+                queue, etl::move(frame), nb::Delay{time, FRAME_EXPIRATION}
             );
             return nb::ready();
         }
 
+        // 優先度の高いキューから順に取り出す
         nb::Poll<LinkFrame>
         poll_get_send_requested_frame(MediaPortNumber port, link::AddressType address_type) {
-            for (uint8_t i = 0; i < send_requested_frame_.size(); i++) {
-                auto &entry = send_requested_frame_[i];
-
-                if (entry.frame.media_port_mask.is_unspecified()) {
-                    if (entry.frame.remote.type() == address_type) {
-                        return send_requested_frame_.remove(i).frame;
-                    } else {
-                        continue;
-                    }
-                }
-
-                if (entry.frame.media_port_mask.test(port)) {
-                    return send_requested_frame_.remove(i).frame;
+            for (uint8_t p = 0; p < FRAME_PRIORITY_COUNT; p++) {
+                auto poll = poll_get_send_requested_frame_of_priority(p, port, address_type);
+                if (poll.is_ready()) {
+                    return poll;
                 }
             }
             return nb::pending;
         }
+
+        // 期限切れ，またはより優先度の高いフレームに場所を譲るために破棄された送信フレームの数
+        inline uint16_t dropped_frame_count(FramePriority priority) const {
+            return dropped_frame_count_[frame_priority_to_index(priority)];
+        }
+
+        inline void reset_dropped_frame_count() {
+            dropped_frame_count_.fill(0);
+        }
     };
 
     class MeasuredLinkFrameQueue {
         Measurement measurement_;
         LinkFrameQueue queue_;
+        etl::array<CoDel, frame::NUM_PROTOCOLS> codel_{};
 
       public:
         MeasuredLinkFrameQueue() = delete;
@@ -150,6 +301,15 @@ namespace net::link {
             frame::FrameBufferReader &&reader,
             util::Time &time
         ) {
+            // キューが満杯でも，十分に長く滞留したフレームがあればそれを破棄して受け入れる
+            if (queue_.is_received_frame_full()) {
+                auto dropped = queue_.pop_received_frame_older_than(CODEL_TARGET, time);
+                if (dropped.has_value()) {
+                    LOG_INFO(FLASH_STRING("Drop stale recv frame: "), dropped->frame.remote);
+                    measurement_.on_frame_dropped(dropped->expiration, time);
+                }
+            }
+
             auto poll = queue_.poll_dispatch_received_frame(
                 media_port, protocol_number, remote, etl::move(reader), time
             );
@@ -159,15 +319,26 @@ namespace net::link {
             return poll;
         }
 
-        inline nb::Poll<LinkFrame>
+        nb::Poll<LinkFrame>
         poll_receive_frame(frame::ProtocolNumber protocol_number, util::Time &time) {
-            auto &&poll = queue_.poll_receive_frame(protocol_number);
-            if (poll.is_ready()) {
+            auto &codel = codel_[static_cast<uint8_t>(protocol_number)];
+            while (true) {
+                auto &&poll = queue_.poll_receive_frame(protocol_number);
+                if (poll.is_pending()) {
+                    codel.on_queue_empty();
+                    return nb::pending;
+                }
+
                 auto &&entry = poll.unwrap();
+                util::Instant now = time.now();
+                if (codel.should_drop(now - entry.expiration.start(), now)) {
+                    LOG_INFO(FLASH_STRING("Drop delayed recv frame: "), entry.frame.remote);
+                    measurement_.on_frame_dropped(entry.expiration, time);
+                    continue;
+                }
+
                 measurement_.on_frame_accepted(entry.expiration, time);
                 return etl::move(entry.frame);
-            } else {
-                return nb::pending;
             }
         }
 
@@ -176,10 +347,11 @@ namespace net::link {
             frame::ProtocolNumber protocol_number,
             const Address &remote,
             frame::FrameBufferReader &&reader,
+            FramePriority priority,
             util::Time &time
         ) {
             return queue_.poll_request_send_frame(
-                media_port_mask, protocol_number, remote, etl::move(reader), time
+                media_port_mask, protocol_number, remote, etl::move(reader), priority, time
             );
         }
 
@@ -191,6 +363,14 @@ namespace net::link {
         inline Measurement &measurement() {
             return measurement_;
         }
+
+        inline uint16_t dropped_frame_count(FramePriority priority) const {
+            return queue_.dropped_frame_count(priority);
+        }
+
+        inline void reset_dropped_frame_count() {
+            queue_.reset_dropped_frame_count();
+        }
     };
 
     class FrameBroker {
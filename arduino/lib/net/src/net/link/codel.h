@@ -0,0 +1,100 @@
+#pragma once
+
+#include "./constants.h"
+#include <etl/optional.h>
+#include <stdint.h>
+#include <util/time.h>
+
+namespace net::link {
+    /**
+     * CoDel（Controlled Delay）による能動的キュー管理．
+     *
+     * キューからフレームを取り出すたびに，そのフレームの滞留時間を渡して破棄すべきかを判定する．
+     * 滞留時間が`CODEL_TARGET`を`CODEL_INTERVAL`以上続けて超えた場合に破棄を始め，
+     * 破棄を続ける間は破棄の間隔を`CODEL_INTERVAL / sqrt(count)`に縮めていく．
+     */
+    class CoDel {
+        etl::optional<util::Instant> first_above_time_;
+        etl::optional<util::Instant> drop_next_;
+        uint16_t count_{0};
+        uint16_t last_count_{0};
+        bool dropping_{false};
+
+        static inline uint16_t isqrt(uint32_t value) {
+            uint32_t result = 0;
+            uint32_t bit = uint32_t{1} << 30;
+            while (bit > value) {
+                bit >>= 2;
+            }
+            while (bit != 0) {
+                if (value >= result + bit) {
+                    value -= result + bit;
+                    result = (result >> 1) + bit;
+                } else {
+                    result >>= 1;
+                }
+                bit >>= 2;
+            }
+            return result;
+        }
+
+        inline util::Instant control_law(util::Instant t) const {
+            // 精度を保つため，sqrt(count)を64倍した値で割る
+            uint16_t sqrt_count_x64 = isqrt(static_cast<uint32_t>(count_) << 12);
+            return t + util::Duration::from_millis(CODEL_INTERVAL.millis() * 64 / sqrt_count_x64);
+        }
+
+        static inline bool is_reached(util::Instant now, util::Instant deadline) {
+            return now - deadline >= util::Duration::zero();
+        }
+
+      public:
+        inline bool is_dropping() const {
+            return dropping_;
+        }
+
+        // キューが空になった場合に呼び出す
+        inline void on_queue_empty() {
+            first_above_time_ = etl::nullopt;
+            dropping_ = false;
+        }
+
+        bool should_drop(util::Duration sojourn_time, util::Instant now) {
+            bool ok_to_drop = false;
+            if (sojourn_time < CODEL_TARGET) {
+                first_above_time_ = etl::nullopt;
+            } else if (!first_above_time_.has_value()) {
+                first_above_time_ = now + CODEL_INTERVAL;
+            } else if (is_reached(now, *first_above_time_)) {
+                ok_to_drop = true;
+            }
+
+            if (dropping_) {
+                if (!ok_to_drop) {
+                    dropping_ = false;
+                    return false;
+                }
+                if (is_reached(now, *drop_next_)) {
+                    count_++;
+                    drop_next_ = control_law(*drop_next_);
+                    return true;
+                }
+                return false;
+            }
+
+            if (!ok_to_drop) {
+                return false;
+            }
+
+            // 直前の破棄状態から間もない場合は，破棄間隔を引き継ぐ
+            dropping_ = true;
+            uint16_t delta = count_ - last_count_;
+            bool recently_dropped =
+                drop_next_.has_value() && now - *drop_next_ < CODEL_INTERVAL * 16;
+            count_ = delta > 1 && recently_dropped ? delta : 1;
+            last_count_ = count_;
+            drop_next_ = control_law(now);
+            return true;
+        }
+    };
+} // namespace net::link
@@ -7,6 +7,8 @@ namespace net::link {
     constexpr uint8_t MAX_FRAME_BUFFER_SIZE = 8;
     constexpr util::Duration FRAME_DROP_INTERVAL = util::Duration::from_seconds(1);
     constexpr util::Duration FRAME_EXPIRATION = util::Duration::from_seconds(5);
+    constexpr util::Duration CODEL_TARGET = util::Duration::from_millis(100);
+    constexpr util::Duration CODEL_INTERVAL = util::Duration::from_seconds(1);
 
     constexpr uint8_t MAX_MEDIA_PER_NODE = 4;
 } // namespace net::link
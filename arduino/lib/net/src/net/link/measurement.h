@@ -8,6 +8,7 @@ namespace net::link {
     class Measurement {
         uint16_t received_frame_count_{0};
         uint16_t accepted_frame_count_{0};
+        uint16_t dropped_frame_count_{0};
         util::Duration sum_of_received_frame_wait_time_{util::Duration::zero()};
 
       public:
@@ -20,6 +21,12 @@ namespace net::link {
             sum_of_received_frame_wait_time_ += time.now() - expiration.start();
         }
 
+        // 破棄されたフレームも，待ち時間の標本として扱う
+        inline void on_frame_dropped(nb::Delay expiration, util::Time &time) {
+            dropped_frame_count_++;
+            sum_of_received_frame_wait_time_ += time.now() - expiration.start();
+        }
+
         inline uint16_t received_frame_count() const {
             return received_frame_count_;
         }
@@ -32,9 +39,19 @@ namespace net::link {
             return accepted_frame_count_;
         }
 
+        inline uint16_t dropped_frame_count() const {
+            return dropped_frame_count_;
+        }
+
+        // 待ち時間を計測したフレームの数
+        inline uint16_t dequeued_frame_count() const {
+            return accepted_frame_count_ + dropped_frame_count_;
+        }
+
         inline void reset() {
             received_frame_count_ = 0;
             accepted_frame_count_ = 0;
+            dropped_frame_count_ = 0;
             sum_of_received_frame_wait_time_ = util::Duration::zero();
         }
     };
@@ -125,6 +125,19 @@ namespace net::link {
         inline constexpr bool test(MediaPortNumber number) const {
             return (mask_ & (number_to_mask(number))) != 0;
         }
+
+        // ポートが1つだけ指定されている場合，そのポート番号を返す
+        inline constexpr etl::optional<MediaPortNumber> single_port() const {
+            if (mask_ == UNSPECIFIED || mask_ == 0 || (mask_ & (mask_ - 1)) != 0) {
+                return etl::nullopt;
+            }
+
+            uint8_t number = 0;
+            while ((mask_ >> number) != 1) {
+                number++;
+            }
+            return MediaPortNumber{number};
+        }
     };
 
     struct MediaInfo {
@@ -171,6 +184,30 @@ namespace net::link {
         }
     };
 
+    /**
+     * キャリアセンスを行う媒体の，チャネルの混雑具合．
+     * 各カウンタは起動時からの累計で，オーバーフローした場合は0に戻る．
+     */
+    struct ChannelStatistics {
+        uint16_t carrier_sense_count{0};
+        uint16_t busy_count{0}; // チャネルが使用中だったキャリアセンスの回数
+
+        inline ChannelStatistics &operator+=(const ChannelStatistics &other) {
+            carrier_sense_count += other.carrier_sense_count;
+            busy_count += other.busy_count;
+            return *this;
+        }
+
+        // `previous`以降の差分
+        inline ChannelStatistics since(const ChannelStatistics &previous) const {
+            return ChannelStatistics{
+                .carrier_sense_count =
+                    static_cast<uint16_t>(carrier_sense_count - previous.carrier_sense_count),
+                .busy_count = static_cast<uint16_t>(busy_count - previous.busy_count),
+            };
+        }
+    };
+
     enum class MediaPortOperationResult {
         Success,
         Failure,
@@ -180,11 +217,15 @@ namespace net::link {
     struct MediaPortUnsupportedOperation {};
 
     template <typename T>
-    concept SerialMediaPort = requires(T t, const Address &address) {
-        {
-            t.serial_try_initialize_local_address(address)
-        } -> util::same_as<MediaPortOperationResult>;
-    };
+    concept SerialMediaPort =
+        requires(T t, const Address &address, uint32_t baud_rate, util::Time &time) {
+            {
+                t.serial_try_initialize_local_address(address)
+            } -> util::same_as<MediaPortOperationResult>;
+            {
+                t.serial_try_negotiate_baud_rate(baud_rate, time)
+            } -> util::same_as<MediaPortOperationResult>;
+        };
 
     template <typename T>
     concept WiFiSerialMediaPort = requires(
@@ -219,6 +260,7 @@ namespace net::link {
     concept MediaPort =
         SerialMediaPort<T> && WiFiSerialMediaPort<T> && EthernetMediaPort<T> && requires(T t) {
             { t.get_media_info() } -> util::same_as<MediaInfo>;
+            { t.get_channel_statistics() } -> util::same_as<etl::optional<ChannelStatistics>>;
         };
 
     template <typename T>
@@ -235,6 +277,7 @@ namespace net::link {
             { t.get_media_addresses(addresses) } -> util::same_as<void>;
             { t.get_media_info(media_info) } -> util::same_as<void>;
             { t.get_broadcast_address(type) } -> util::same_as<etl::optional<Address>>;
+            { t.get_channel_statistics() } -> util::same_as<ChannelStatistics>;
         };
 
     struct LinkFrame {
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <net/frame.h>
+#include <stdint.h>
+
+namespace net::link {
+    /**
+     * 送信フレームの優先度．値が小さいほど優先される．
+     */
+    enum class FramePriority : uint8_t {
+        Control = 0,
+        Discovery = 1,
+        Rpc = 2,
+        Observer = 3,
+        Bulk = 4,
+    };
+
+    constexpr inline uint8_t FRAME_PRIORITY_COUNT = 5;
+
+    inline constexpr uint8_t frame_priority_to_index(FramePriority priority) {
+        return static_cast<uint8_t>(priority);
+    }
+
+    inline constexpr FramePriority default_frame_priority(frame::ProtocolNumber protocol_number) {
+        switch (protocol_number) {
+        case frame::ProtocolNumber::RoutingNeighbor:
+            return FramePriority::Control;
+        case frame::ProtocolNumber::Discover:
+        case frame::ProtocolNumber::RouteAdvertisement:
+            return FramePriority::Discovery;
+        case frame::ProtocolNumber::Rpc:
+            return FramePriority::Rpc;
+        case frame::ProtocolNumber::Observer:
+            return FramePriority::Observer;
+        default:
+            return FramePriority::Bulk;
+        }
+    }
+} // namespace net::link
@@ -53,13 +53,25 @@ namespace net::link {
             MediaPortMask media_port_mask,
             const Address &remote,
             frame::FrameBufferReader &&reader,
+            FramePriority priority,
             util::Time &time
         ) {
             return queue_.get().poll_request_send_frame(
-                media_port_mask, protocol_number_, remote, etl::move(reader), time
+                media_port_mask, protocol_number_, remote, etl::move(reader), priority, time
             );
         }
 
+        // 優先度はプロトコル番号から決定する
+        inline etl::expected<nb::Poll<void>, SendFrameError> poll_send_frame(
+            MediaPortMask media_port_mask,
+            const Address &remote,
+            frame::FrameBufferReader &&reader,
+            util::Time &time
+        ) {
+            auto priority = default_frame_priority(protocol_number_);
+            return poll_send_frame(media_port_mask, remote, etl::move(reader), priority, time);
+        }
+
         inline constexpr uint8_t max_payload_length() const {
             return frame::MTU;
         }
@@ -97,5 +109,9 @@ namespace net::link {
         inline Measurement &measurement() {
             return queue_.get().measurement();
         }
+
+        inline uint16_t dropped_frame_count(FramePriority priority) const {
+            return queue_.get().dropped_frame_count(priority);
+        }
     };
 }; // namespace net::link
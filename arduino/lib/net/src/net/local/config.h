@@ -12,18 +12,27 @@ namespace net::local {
         bool enable_dynamic_cost_update : 1 = false;
         bool enable_frame_delay : 1 = true;
 
+        // ブロードキャストの中継を取りやめる，待機中に重複して受信した回数．0の場合は抑制しない
+        uint8_t broadcast_suppression_threshold : 3 = 0;
+
+        // 中継の待機時間の上限．`BROADCAST_ASSESSMENT_DELAY_UNIT << broadcast_assessment_delay`
+        uint8_t broadcast_assessment_delay : 2 = 1;
+
       private:
         static inline LocalNodeConfig from_byte(uint8_t byte) {
             return LocalNodeConfig{
                 .enable_auto_neighbor_discovery = (byte & 0b00000001) != 0,
                 .enable_dynamic_cost_update = (byte & 0b00000010) != 0,
                 .enable_frame_delay = (byte & 0b00000100) != 0,
+                .broadcast_suppression_threshold = static_cast<uint8_t>((byte >> 3) & 0b111),
+                .broadcast_assessment_delay = static_cast<uint8_t>((byte >> 6) & 0b11),
             };
         }
 
         inline uint8_t to_byte() const {
             return (enable_auto_neighbor_discovery ? 1 : 0) |
-                (enable_dynamic_cost_update ? 1 : 0) << 1 | (enable_frame_delay ? 1 : 0) << 2;
+                (enable_dynamic_cost_update ? 1 : 0) << 1 | (enable_frame_delay ? 1 : 0) << 2 |
+                broadcast_suppression_threshold << 3 | broadcast_assessment_delay << 6;
         }
     };
 
@@ -4,4 +4,6 @@
 
 namespace net::local {
     inline constexpr util::Duration DYNAMIC_COST_UPDATE_INTERVAL = util::Duration::from_seconds(30);
+    // コスト計算に用いるチャネル使用率の上限
+    inline constexpr float MAX_CHANNEL_BUSY_RATIO = 0.9;
 } // namespace net::local
@@ -3,18 +3,35 @@
 #include "./config.h"
 #include "./constants.h"
 #include "./info.h"
+#include <etl/algorithm.h>
 #include <nb/time.h>
 #include <net/node.h>
 
 namespace net::local {
     class DynamicCostUpdator {
         nb::Debounce update_debounce_;
+        link::ChannelStatistics previous_channel_statistics_{};
+
+        // 前回の更新以降に，キャリアセンスでチャネルが使用中だった割合
+        float channel_busy_ratio(link::MediaService auto &ms) {
+            auto current = ms.get_channel_statistics();
+            auto statistics = current.since(previous_channel_statistics_);
+            previous_channel_statistics_ = current;
+
+            if (statistics.carrier_sense_count == 0) {
+                return 0;
+            }
+            float ratio = static_cast<float>(statistics.busy_count) /
+                statistics.carrier_sense_count;
+            return etl::min(ratio, MAX_CHANNEL_BUSY_RATIO);
+        }
 
       public:
         explicit DynamicCostUpdator(util::Time &time)
             : update_debounce_{time, DYNAMIC_COST_UPDATE_INTERVAL} {}
 
         inline void execute(
+            link::MediaService auto &ms,
             link::LinkService &ls,
             notification::NotificationService &nts,
             LocalNodeInfoStorage &info,
@@ -26,6 +43,7 @@ namespace net::local {
             }
 
             auto &measurements = ls.measurement();
+            float busy_ratio = channel_busy_ratio(ms);
 
             if (!config.enable_dynamic_cost_update) {
                 measurements.reset();
@@ -36,9 +54,9 @@ namespace net::local {
             float lambda = static_cast<float>(measurements.received_frame_count()) /
                 DYNAMIC_COST_UPDATE_INTERVAL.millis();
             float ts = static_cast<float>(measurements.sum_of_received_frame_wait_time().millis()) /
-                measurements.accepted_frame_count();
+                measurements.dequeued_frame_count();
 
-            if (measurements.accepted_frame_count() == 0) {
+            if (measurements.dequeued_frame_count() == 0) {
                 // まだフレームを受信していない
                 measurements.reset();
                 return;
@@ -48,6 +66,8 @@ namespace net::local {
             // このままだと小さすぎるので桁を増やす
             constexpr float alpha = 10000;
             float tw = alpha * rho / (1 - rho) * ts;
+            // チャネルが混雑しているほど，送信できるまでの待ち時間が延びる
+            tw /= 1 - busy_ratio;
             auto cost = util::Duration::from_millis(static_cast<util::TimeDiff>(tw));
             info.set_cost(nts, static_cast<node::Cost>(cost));
         }
@@ -3,4 +3,5 @@
 // IWYU pragma: begin_exports
 #include "./neighbor/service.h"
 #include "./neighbor/socket.h"
+#include "./neighbor/suppression.h"
 // IWYU pragma: end_exports
@@ -8,7 +8,9 @@ namespace net::neighbor {
     constexpr uint8_t MAX_NEIGHBOR_NODE_COUNT = 10;
     constexpr uint8_t MAX_NEIGHBOR_LIST_CURSOR_COUNT = 5;
     constexpr uint8_t MAX_NEIGNBOR_FRAME_DELAY_POOL_SIZE = 4;
+    constexpr util::Duration BROADCAST_ASSESSMENT_DELAY_UNIT = util::Duration::from_millis(25);
     constexpr util::Duration SEND_HELLO_INTERVAL = util::Duration::from_seconds(10);
     constexpr util::Duration NEIGHBOR_EXPIRATION_TIMEOUT = SEND_HELLO_INTERVAL * 4;
-    constexpr util::Duration CHECK_NEIGHBOR_EXPIRATION_INTERVAL = SEND_HELLO_INTERVAL * 2;
+    // タイマーの精度．期限切れやHelloの送信は最大でこの時間だけ遅れる
+    constexpr util::Duration NEIGHBOR_TIMER_TICK = util::Duration::from_seconds(1);
 } // namespace net::neighbor
@@ -18,16 +18,11 @@ namespace net::neighbor::service {
             link::AddressTypeSet broadcast_sent_types_{};
         };
 
-        struct UnicastPollCursor {
-            link::AddressTypeSet broadcast_sent_types_;
-        };
-
         struct Unicast {
-            link::AddressTypeSet broadcast_sent_types_;
-            NeighborListCursor cursor_;
+            etl::optional<node::NodeId> target_{};
         };
 
-        etl::variant<Interval, Broadcast, UnicastPollCursor, Unicast> state_;
+        etl::variant<Interval, Broadcast, Unicast> state_;
 
       public:
         explicit SendHelloWorker(util::Time &time) : state_{Interval{time}} {}
@@ -55,7 +50,7 @@ namespace net::neighbor::service {
                 if (config.enable_auto_neighbor_discovery) {
                     state_.emplace<Broadcast>();
                 } else {
-                    state_.emplace<UnicastPollCursor>(link::AddressTypeSet{});
+                    state_.emplace<Unicast>();
                 }
             }
 
@@ -81,38 +76,33 @@ namespace net::neighbor::service {
                     ++send_type;
                 }
 
-                state_.emplace<UnicastPollCursor>(sent_types);
-            }
-
-            if (etl::holds_alternative<UnicastPollCursor>(state_)) {
-                auto &&poll_cursor = list.poll_cursor();
-                if (poll_cursor.is_pending()) {
-                    return;
-                }
-
-                auto sent_ = etl::get<UnicastPollCursor>(state_).broadcast_sent_types_;
-                state_.emplace<Unicast>(sent_, etl::move(poll_cursor.unwrap()));
+                state_.emplace<Unicast>();
             }
 
+            // Hello送信間隔が経過した隣接ノードのみを対象とする
             if (etl::holds_alternative<Unicast>(state_)) {
                 while (true) {
                     auto &state = etl::get<Unicast>(state_);
-                    etl::optional<etl::reference_wrapper<const NeighborNode>> opt_neighbor =
-                        list.get_neighbor_node(state.cursor_);
-                    if (!opt_neighbor.has_value()) {
-                        state_.emplace<Interval>(Interval{time});
-                        return;
+                    if (!state.target_.has_value()) {
+                        auto poll_target = list.poll_send_hello_target(time);
+                        if (poll_target.is_pending()) {
+                            state_.emplace<Interval>(Interval{time});
+                            return;
+                        }
+                        state.target_ = poll_target.unwrap();
                     }
 
-                    const auto &neighbor = opt_neighbor.value().get();
-                    if (!neighbor.should_send_hello(time)) {
-                        state.cursor_.advance();
+                    etl::optional<etl::reference_wrapper<const NeighborNode>> opt_neighbor =
+                        list.get_neighbor_node(*state.target_);
+                    if (!opt_neighbor.has_value()) {
+                        state.target_ = etl::nullopt;
                         continue;
                     }
 
+                    const auto &neighbor = opt_neighbor.value().get();
                     auto addresses = neighbor.addresses();
                     if (addresses.empty()) {
-                        state.cursor_.advance();
+                        state.target_ = etl::nullopt;
                         continue;
                     }
 
@@ -125,10 +115,8 @@ namespace net::neighbor::service {
                         return;
                     }
 
-                    state.cursor_.advance();
+                    state.target_ = etl::nullopt;
                 }
-
-                state_.emplace<Interval>(Interval{time});
             }
         }
     };
@@ -2,9 +2,11 @@
 
 #include "../constants.h"
 #include <memory/pair_shared.h>
+#include <nb/timer_wheel.h>
 #include <net/link.h>
 #include <net/node.h>
 #include <net/notification.h>
+#include <tl/index_table.h>
 #include <tl/vec.h>
 
 namespace net::neighbor {
@@ -31,16 +33,18 @@ namespace net::neighbor {
         }
 
       private:
-        void update(const link::Address &address, link::MediaPortMask gateway_port_mask) {
+        // 新しいアドレスが追加された場合はtrueを返す
+        bool update(const link::Address &address, link::MediaPortMask gateway_port_mask) {
             for (auto &addr : addresses) {
                 if (addr.address == address) {
                     addr.gateway_port_mask |= gateway_port_mask;
-                    return;
+                    return false;
                 }
             }
 
             addresses.emplace_back(address, gateway_port_mask);
             address_types.set(address.type());
+            return true;
         }
 
         inline bool overlap_addresses_type(const link::AddressTypeSet &types) const {
@@ -52,33 +56,17 @@ namespace net::neighbor {
         }
     };
 
-    struct NeighborNodeTimer {
-        nb::Delay expiration_timeout;
-        nb::Delay send_hello_interval;
-
-        explicit NeighborNodeTimer(util::Time &time)
-            : expiration_timeout{time, NEIGHBOR_EXPIRATION_TIMEOUT},
-              send_hello_interval{time, SEND_HELLO_INTERVAL} {}
-
-        inline bool is_expired(util::Time &time) const {
-            return expiration_timeout.poll(time).is_ready();
-        }
-
-        inline bool should_send_hello(util::Time &time) const {
-            return send_hello_interval.poll(time).is_ready();
-        }
+    using NeighborTimerWheel = nb::TimerWheel<node::NodeId, MAX_NEIGHBOR_NODE_COUNT>;
 
-        inline void reset_expiration(util::Time &time) {
-            expiration_timeout = nb::Delay{time, NEIGHBOR_EXPIRATION_TIMEOUT};
-        }
-
-        inline void reset_send_hello_interval(util::Time &time) {
-            send_hello_interval = nb::Delay{time, SEND_HELLO_INTERVAL};
-        }
+    struct NeighborNodeTimer {
+        nb::TimerHandle expiration_timeout;
+        nb::TimerHandle send_hello_interval;
     };
 
     class NeighborNode {
         friend class NeighborList;
+        template <uint8_t>
+        friend class PointableNeighbors;
 
         node::NodeId id_;
         node::Cost link_cost_;
@@ -91,12 +79,12 @@ namespace net::neighbor {
             node::Cost link_cost,
             link::Address address,
             link::MediaPortMask gateway_port_mask,
-            util::Time &time
+            const NeighborNodeTimer &timer
         )
             : id_{id},
               link_cost_{link_cost},
               addresses_{},
-              timer_{time} {
+              timer_{timer} {
             addresses_.update(address, gateway_port_mask);
         }
 
@@ -122,30 +110,20 @@ namespace net::neighbor {
             return addresses_.has_address(address);
         }
 
-        inline void
+      private:
+        inline bool
         update_address(const link::Address &address, link::MediaPortMask gateway_port_mask) {
-            addresses_.update(address, gateway_port_mask);
+            return addresses_.update(address, gateway_port_mask);
         }
 
+      public:
         inline bool overlap_addresses_type(link::AddressTypeSet types) const {
             return addresses_.overlap_addresses_type(types);
         }
 
-        inline bool is_expired(util::Time &time) const {
-            return timer_.is_expired(time);
-        }
-
-        inline bool should_send_hello(util::Time &time) const {
-            return timer_.should_send_hello(time);
-        }
-
       private:
-        inline void delay_expiration(util::Time &time) {
-            timer_.reset_expiration(time);
-        }
-
-        inline void delay_hello_interval(util::Time &time) {
-            timer_.reset_send_hello_interval(time);
+        inline const NeighborNodeTimer &timer() const {
+            return timer_;
         }
     };
 
@@ -239,24 +217,79 @@ namespace net::neighbor {
         }
     };
 
+    /**
+     * アドレスの索引に格納するアドレス数の上限．
+     * 多くのノードは1~2個のアドレスしか持たないため，全アドレス分の領域は確保しない．
+     * 索引のスロット数には上限があるため，隣接ノードが多い場合はさらに制限する
+     */
+    template <uint8_t MAX_COUNT>
+    inline constexpr uint8_t neighbor_address_index_capacity() {
+        constexpr uint16_t budget = static_cast<uint16_t>(MAX_COUNT) * 2;
+        return budget < tl::MAX_INDEX_TABLE_ELEMENT_COUNT ? budget
+                                                          : tl::MAX_INDEX_TABLE_ELEMENT_COUNT;
+    }
+
+    template <uint8_t MAX_COUNT>
     class PointableNeighbors {
-        tl::Vec<NeighborNode, MAX_NEIGHBOR_NODE_COUNT> neighbors_{};
+        static constexpr uint8_t ADDRESS_INDEX_CAPACITY =
+            neighbor_address_index_capacity<MAX_COUNT>();
+
+        tl::Vec<NeighborNode, MAX_COUNT> neighbors_{};
         NeighborListCursotStorage cursors_{};
+        tl::IndexTable<tl::index_table_slot_count<MAX_COUNT>()> id_index_{};
+        tl::IndexTable<tl::index_table_slot_count<ADDRESS_INDEX_CAPACITY>()> address_index_{};
+        bool address_index_overflowed_{false};
 
-      public:
-        bool full() const {
-            return neighbors_.full();
+        inline void index_address(uint8_t index, const link::Address &address) {
+            if (address_index_.size() >= ADDRESS_INDEX_CAPACITY) {
+                address_index_overflowed_ = true;
+                return;
+            }
+            address_index_.insert(address.hash(), index);
         }
 
-        inline etl::optional<uint8_t> find_index(const node::NodeId &node_id) const {
+        void rebuild_indexes() {
+            id_index_.clear();
+            address_index_.clear();
+            address_index_overflowed_ = false;
+
             for (uint8_t i = 0; i < neighbors_.size(); i++) {
-                if (neighbors_[i].id() == node_id) {
+                const auto &neighbor = neighbors_[i];
+                id_index_.insert(neighbor.id().hash(), i);
+                for (const auto &addr : neighbor.addresses()) {
+                    index_address(i, addr.address);
+                }
+            }
+        }
+
+        inline etl::optional<uint8_t> find_index_by_address(const link::Address &address) const {
+            auto opt_index = address_index_.find(address.hash(), [&](uint8_t index) {
+                return neighbors_[index].has_address(address);
+            });
+            if (opt_index.has_value() || !address_index_overflowed_) {
+                return opt_index;
+            }
+
+            // 索引に収まらなかったアドレスは線形探索で探す
+            for (uint8_t i = 0; i < neighbors_.size(); i++) {
+                if (neighbors_[i].has_address(address)) {
                     return i;
                 }
             }
             return etl::nullopt;
         }
 
+      public:
+        bool full() const {
+            return neighbors_.full();
+        }
+
+        inline etl::optional<uint8_t> find_index(const node::NodeId &node_id) const {
+            return id_index_.find(node_id.hash(), [&](uint8_t index) {
+                return neighbors_[index].id() == node_id;
+            });
+        }
+
         inline etl::optional<etl::reference_wrapper<NeighborNode>> find(const node::NodeId &node_id
         ) {
             auto opt_index = find_index(node_id);
@@ -272,12 +305,8 @@ namespace net::neighbor {
 
         inline etl::optional<etl::reference_wrapper<const NeighborNode>>
         find_by_address(const link::Address &address) const {
-            for (uint8_t i = 0; i < neighbors_.size(); i++) {
-                if (neighbors_[i].has_address(address)) {
-                    return etl::cref(neighbors_[i]);
-                }
-            }
-            return etl::nullopt;
+            auto opt_index = find_index_by_address(address);
+            return opt_index ? etl::optional(etl::cref(neighbors_[*opt_index])) : etl::nullopt;
         }
 
         inline NeighborNode &emplace_back_neighbor(
@@ -285,16 +314,31 @@ namespace net::neighbor {
             node::Cost link_cost,
             link::Address address,
             link::MediaPortMask gateway_port_mask,
-            util::Time &time
+            const NeighborNodeTimer &timer
         ) {
             FASSERT(!full());
-            neighbors_.emplace_back(node_id, link_cost, address, gateway_port_mask, time);
+            uint8_t index = neighbors_.size();
+            neighbors_.emplace_back(node_id, link_cost, address, gateway_port_mask, timer);
+            id_index_.insert(node_id.hash(), index);
+            index_address(index, address);
             return neighbors_.back();
         }
 
+        inline void update_neighbor_address(
+            uint8_t index,
+            const link::Address &address,
+            link::MediaPortMask gateway_port_mask
+        ) {
+            FASSERT(index < neighbors_.size());
+            if (neighbors_[index].update_address(address, gateway_port_mask)) {
+                index_address(index, address);
+            }
+        }
+
         inline void remove_neighbor(uint8_t index) {
             neighbors_.remove(index);
             cursors_.sync_index_on_element_removed(index);
+            rebuild_indexes();
         }
 
         inline nb::Poll<NeighborListCursor> poll_cursor() {
@@ -333,12 +377,22 @@ namespace net::neighbor {
     };
 
     class NeighborList {
-        PointableNeighbors neighbors_{};
-        nb::Debounce check_expired_debounce_;
+        PointableNeighbors<MAX_NEIGHBOR_NODE_COUNT> neighbors_{};
+        NeighborTimerWheel expiration_timers_;
+        NeighborTimerWheel send_hello_timers_;
+
+        inline NeighborNodeTimer schedule_timers(const node::NodeId &node_id, util::Time &time) {
+            auto expiration =
+                expiration_timers_.schedule(node_id, NEIGHBOR_EXPIRATION_TIMEOUT, time);
+            auto send_hello = send_hello_timers_.schedule(node_id, SEND_HELLO_INTERVAL, time);
+            FASSERT(expiration.has_value() && send_hello.has_value());
+            return NeighborNodeTimer{*expiration, *send_hello};
+        }
 
       public:
         explicit NeighborList(util::Time &time)
-            : check_expired_debounce_{time, CHECK_NEIGHBOR_EXPIRATION_INTERVAL} {}
+            : expiration_timers_{time, NEIGHBOR_TIMER_TICK},
+              send_hello_timers_{time, NEIGHBOR_TIMER_TICK} {}
 
         AddNeighborResult add_neighbor(
             const node::NodeId &node_id,
@@ -351,17 +405,17 @@ namespace net::neighbor {
                 return AddNeighborResult::Full;
             }
 
-            auto opt_neighbor = neighbors_.find(node_id);
-            if (!opt_neighbor.has_value()) {
+            auto opt_index = neighbors_.find_index(node_id);
+            if (!opt_index.has_value()) {
                 neighbors_.emplace_back_neighbor(
-                    node_id, link_cost, address, gateway_port_mask, time
+                    node_id, link_cost, address, gateway_port_mask, schedule_timers(node_id, time)
                 );
                 LOG_INFO(FLASH_STRING("new neigh: "), node_id);
                 return AddNeighborResult::Updated;
             }
 
-            auto &node = opt_neighbor.value().get();
-            node.update_address(address, gateway_port_mask);
+            neighbors_.update_neighbor_address(*opt_index, address, gateway_port_mask);
+            auto &node = neighbors_.get_by_index(*opt_index);
             if (node.link_cost() == link_cost) {
                 return AddNeighborResult::NoChange;
             }
@@ -418,7 +472,9 @@ namespace net::neighbor {
         inline void delay_hello_interval(link::AddressTypeSet types, util::Time &time) {
             for (auto &neighbor : neighbors_.as_span()) {
                 if (neighbor.overlap_addresses_type(types)) {
-                    neighbor.delay_hello_interval(time);
+                    send_hello_timers_.reschedule(
+                        neighbor.timer().send_hello_interval, SEND_HELLO_INTERVAL, time
+                    );
                 }
             }
         }
@@ -430,14 +486,19 @@ namespace net::neighbor {
         inline void delay_hello_interval(const node::NodeId &node_id, util::Time &time) {
             auto opt_neighbor = neighbors_.find(node_id);
             if (opt_neighbor) {
-                opt_neighbor->get().delay_hello_interval(time);
+                send_hello_timers_.reschedule(
+                    opt_neighbor->get().timer().send_hello_interval, SEND_HELLO_INTERVAL, time
+                );
             }
         }
 
         inline void delay_expiration(const node::NodeId &node_id, util::Time &time) {
             auto opt_neighbor = neighbors_.find(node_id);
             if (opt_neighbor) {
-                opt_neighbor->get().delay_expiration(time);
+                expiration_timers_.reschedule(
+                    opt_neighbor->get().timer().expiration_timeout, NEIGHBOR_EXPIRATION_TIMEOUT,
+                    time
+                );
             }
         }
 
@@ -446,20 +507,44 @@ namespace net::neighbor {
             return neighbors_.find_by_address(address);
         }
 
-        void execute(notification::NotificationService &nts, util::Time &time) {
-            if (check_expired_debounce_.poll(time).is_pending()) {
-                return;
+        /**
+         * Helloを送信すべき隣接ノードを1つ取り出す．
+         *
+         * 取り出したノードのHello送信間隔はリセットされる．
+         */
+        inline nb::Poll<node::NodeId> poll_send_hello_target(util::Time &time) {
+            while (true) {
+                node::NodeId node_id =
+                    POLL_UNWRAP_OR_RETURN(send_hello_timers_.poll_pop_expired(time));
+                auto opt_neighbor = neighbors_.find(node_id);
+                if (!opt_neighbor.has_value()) {
+                    continue;
+                }
+
+                send_hello_timers_.reschedule(
+                    opt_neighbor->get().timer().send_hello_interval, SEND_HELLO_INTERVAL, time
+                );
+                return node_id;
             }
+        }
 
-            uint8_t index = 0;
-            while (index < neighbors_.size()) {
-                auto &neighbor = neighbors_.get_by_index(index);
-                if (neighbor.is_expired(time)) {
-                    nts.notify(notification::NeighborRemoved{neighbor.id()});
-                    neighbors_.remove_neighbor(index);
-                } else {
-                    ++index;
+        void execute(notification::NotificationService &nts, util::Time &time) {
+            while (true) {
+                auto poll_expired = expiration_timers_.poll_pop_expired(time);
+                if (poll_expired.is_pending()) {
+                    return;
+                }
+
+                auto opt_index = neighbors_.find_index(poll_expired.unwrap());
+                if (!opt_index.has_value()) {
+                    continue;
                 }
+
+                auto &neighbor = neighbors_.get_by_index(*opt_index);
+                nts.notify(notification::NeighborRemoved{neighbor.id()});
+                expiration_timers_.cancel(neighbor.timer().expiration_timeout);
+                send_hello_timers_.cancel(neighbor.timer().send_hello_interval);
+                neighbors_.remove_neighbor(*opt_index);
             }
         }
     };
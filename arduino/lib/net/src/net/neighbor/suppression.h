@@ -0,0 +1,66 @@
+#pragma once
+
+#include "./constants.h"
+#include <nb/time.h>
+#include <net/frame.h>
+#include <net/local.h>
+#include <util/rand.h>
+
+namespace net::neighbor {
+    /**
+     * カウンタ方式によるブロードキャストの中継の抑制．
+     *
+     * 中継するフレームをランダムな時間だけ待機させ，待機を終えるまでに同じフレームを
+     * `LocalNodeConfig::broadcast_suppression_threshold`回以上重複して受信していれば，
+     * 周囲のノードが既に中継したとみなして中継を取りやめる．
+     */
+    class BroadcastSuppression {
+        uint8_t source_hash_;
+        frame::FrameId frame_id_;
+        uint8_t threshold_;
+        nb::Delay delay_;
+
+        explicit BroadcastSuppression(
+            uint8_t source_hash,
+            frame::FrameId frame_id,
+            uint8_t threshold,
+            nb::Delay delay
+        )
+            : source_hash_{source_hash},
+              frame_id_{frame_id},
+              threshold_{threshold},
+              delay_{delay} {}
+
+      public:
+        // 抑制が無効な場合は`etl::nullopt`を返す
+        static etl::optional<BroadcastSuppression> start(
+            const local::LocalNodeConfig &config,
+            uint8_t source_hash,
+            frame::FrameId frame_id,
+            util::Time &time,
+            util::Rand &rand
+        ) {
+            if (config.broadcast_suppression_threshold == 0) {
+                return etl::nullopt;
+            }
+
+            uint8_t scale = 1 << config.broadcast_assessment_delay;
+            auto max_delay = BROADCAST_ASSESSMENT_DELAY_UNIT * scale;
+            auto delay = rand.gen_uint16_t(static_cast<uint16_t>(max_delay.millis()));
+            return BroadcastSuppression{
+                source_hash,
+                frame_id,
+                config.broadcast_suppression_threshold,
+                nb::Delay{time, util::Duration::from_millis(delay)},
+            };
+        }
+
+        // 待機を終えた時点で，中継を取りやめるかを返す
+        template <uint8_t N>
+        nb::Poll<bool>
+        poll_suppressed(const frame::DuplicateDetector<N> &detector, util::Time &time) const {
+            POLL_UNWRAP_OR_RETURN(delay_.poll(time));
+            return detector.duplicate_count(source_hash_, frame_id_) >= threshold_;
+        }
+    };
+} // namespace net::neighbor
@@ -25,6 +25,10 @@ namespace net::node {
             return id_ != other.id_;
         }
 
+        inline uint8_t hash() const {
+            return id_;
+        }
+
         inline friend logger::log::Printer &
         operator<<(logger::log::Printer &printer, const ClusterId &id) {
             return printer << id.id_;
@@ -2,6 +2,7 @@
 
 #include <nb/serde.h>
 #include <net/link.h>
+#include <util/hash.h>
 
 namespace net::node {
     enum class NodeIdType : uint8_t {
@@ -90,6 +91,11 @@ namespace net::node {
         inline bool is_broadcast() const {
             return type_ == NodeIdType::Broadcast;
         }
+
+        // Address互換のIDであれば，対応する`link::Address::hash`と同じ値になる
+        inline uint8_t hash() const {
+            return util::hash_bytes(static_cast<uint8_t>(type_), body());
+        }
     };
 
     class AsyncNodeIdDeserializer {
@@ -1,7 +1,25 @@
 #pragma once
 
 #include <stdint.h>
+#include <util/time.h>
 
 namespace net::routing {
-    constexpr inline uint8_t FRAME_ID_CACHE_SIZE = 8;
-}
+    // 重複を検出するために記録するフレームの数と期間
+    constexpr inline uint8_t DUPLICATE_DETECTOR_CAPACITY = 32;
+    constexpr inline auto DUPLICATE_DETECTION_WINDOW = util::Duration::from_seconds(10);
+
+    // ソケットごとに同時に処理できる送信タスクの数の既定値
+    constexpr inline uint8_t DEFAULT_TASK_POOL_SIZE = 3;
+
+    // ソケットごとに保持できる，自ノード宛ての受信済みフレームの数の既定値
+    constexpr inline uint8_t DEFAULT_ACCEPTED_FRAME_QUEUE_SIZE = 2;
+
+    // 経路探索の完了を待つユニキャストフレームを，ソケットごとに保持できる数
+    constexpr inline uint8_t HOLDING_FRAME_QUEUE_SIZE = 4;
+
+    // 中継を取りやめるかを判定している間，送信タスクとは別に待機させるブロードキャストの数
+    constexpr inline uint8_t MAX_ASSESSING_BROADCASTS = 4;
+
+    // 同時に経路探索を待つことができる宛先の数．埋まっている間，他の宛先への送信は待たされる
+    constexpr inline uint8_t MAX_HOLDING_DESTINATIONS = 2;
+} // namespace net::routing
@@ -6,10 +6,14 @@
 #include <net/neighbor.h>
 
 namespace net::routing {
-    template <uint8_t FRAME_DELAY_POOL_SIZE>
+    template <
+        uint8_t FRAME_DELAY_POOL_SIZE,
+        uint8_t TASK_POOL_SIZE = DEFAULT_TASK_POOL_SIZE,
+        uint8_t ACCEPTED_FRAME_QUEUE_SIZE = DEFAULT_ACCEPTED_FRAME_QUEUE_SIZE>
     class RoutingSocket {
         neighbor::NeighborSocket<FRAME_DELAY_POOL_SIZE> socket_;
-        task::TaskExecutor<FRAME_DELAY_POOL_SIZE> task_{};
+        task::TaskExecutor<FRAME_DELAY_POOL_SIZE, TASK_POOL_SIZE, ACCEPTED_FRAME_QUEUE_SIZE>
+            task_{};
 
       public:
         explicit RoutingSocket(
@@ -22,6 +26,22 @@ namespace net::routing {
             return task_.poll_receive_frame();
         }
 
+        inline uint16_t dropped_frame_count() const {
+            return task_.dropped_frame_count();
+        }
+
+        inline void reset_dropped_frame_count() {
+            task_.reset_dropped_frame_count();
+        }
+
+        inline uint16_t dropped_relay_count() const {
+            return task_.dropped_relay_count();
+        }
+
+        inline void reset_dropped_relay_count() {
+            task_.reset_dropped_relay_count();
+        }
+
         inline nb::Poll<nb::Future<etl::expected<void, neighbor::SendError>>>
         poll_send_frame(const node::Destination &destination, frame::FrameBufferReader &&reader) {
             return task_.poll_send_frame(destination, etl::move(reader));
@@ -50,7 +70,7 @@ namespace net::routing {
             AsyncRoutingFrameHeaderSerializer serializer{
                 info.source,
                 destination,
-                task_.generate_frame_id(rand),
+                task_.generate_frame_id(info.source, rand),
             };
             writer.serialize_all_at_once(serializer);
             return writer.subwriter();
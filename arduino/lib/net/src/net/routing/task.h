@@ -2,29 +2,97 @@
 
 #include "./constants.h"
 #include "./event.h"
+#include "./task/hold.h"
 #include "./task/receive.h"
 #include "./task/send.h"
+#include <etl/circular_buffer.h>
+#include <nb/task_pool.h>
+#include <tl/vec.h>
 #include <net/neighbor.h>
 
 namespace net::routing::task {
-    template <uint8_t FRAME_DELAY_POOL_SIZE>
+    /**
+     * 受信と送信を別々のレーンで処理する．
+     *
+     * ユニキャストフレームは経路探索が完了するまで`HoldingQueue`で保持し，
+     * ブロードキャストフレームの送信タスクは`TASK_POOL_SIZE`個まで同時に実行される．
+     * 中継を取りやめるかを判定しているブロードキャストは，送信タスクとは別に待機させる．
+     * 受信は送信の空きを待たずに進め，中継先の空きがないフレームはそのフレームだけを破棄する．
+     * そのため，到達できない宛先の経路探索中も，自ノード宛ての受信や他の宛先への中継は進行する．
+     * 自ノード宛てのフレームは`ACCEPTED_FRAME_QUEUE_SIZE`個まで保持し，溢れた場合は破棄する．
+     */
+    template <
+        uint8_t FRAME_DELAY_POOL_SIZE,
+        uint8_t TASK_POOL_SIZE = DEFAULT_TASK_POOL_SIZE,
+        uint8_t ACCEPTED_FRAME_QUEUE_SIZE = DEFAULT_ACCEPTED_FRAME_QUEUE_SIZE>
     class TaskExecutor {
-        etl::variant<etl::monostate, SendFrameTask, ReceiveFrameTask> task_{};
-        frame::FrameIdCache<FRAME_ID_CACHE_SIZE> frame_id_cache_{};
-        etl::optional<RoutingFrame> accepted_frame_{};
+        etl::variant<etl::monostate, ReceiveFrameTask> receive_task_{};
+        nb::TaskPool<SendFrameTask, TASK_POOL_SIZE> send_tasks_{};
+        HoldingQueue holding_{};
+        frame::DuplicateDetector<DUPLICATE_DETECTOR_CAPACITY> duplicate_detector_{
+            DUPLICATE_DETECTION_WINDOW
+        };
+        etl::circular_buffer<RoutingFrame, ACCEPTED_FRAME_QUEUE_SIZE> accepted_frames_{};
+        uint16_t dropped_frame_count_{0};
+        uint16_t dropped_relay_count_{0};
 
-        void send_frame(
-            node::Destination destination,
-            frame::FrameBufferReader &&reader,
+        // 判定の間に重複して受信したフレームを数えられるよう，待機中も受信と送信は続ける
+        struct AssessingBroadcast {
+            frame::FrameBufferReader reader;
+            neighbor::BroadcastSuppression suppression;
+        };
+
+        tl::Vec<AssessingBroadcast, MAX_ASSESSING_BROADCASTS> assessing_{};
+
+        inline bool is_send_task_addable(const node::Destination &destination) const {
+            if (destination.is_unicast()) {
+                return holding_.is_pushable(destination);
+            }
+            return !send_tasks_.full();
+        }
+
+        inline void drop_relay(const RoutingFrame &frame) {
+            LOG_INFO(FLASH_STRING("Routing: no room to relay, drop frame: "), frame.destination);
+            dropped_relay_count_++;
+        }
+
+        void relay_frame(
+            const RoutingFrame &frame,
+            const local::LocalNodeService &lns,
+            neighbor::NeighborService &ns,
+            discovery::DiscoveryService &ds,
             const local::LocalNodeInfo &local,
-            util::Time &time
+            util::Time &time,
+            util::Rand &rand
         ) {
-            FASSERT(etl::holds_alternative<etl::monostate>(task_));
+            const auto &destination = frame.destination;
             auto unicast = [&]() {
-                task_ = SendFrameTask::unicast(destination, etl::move(reader), etl::nullopt);
+                // ゲートウェイが分かっていれば，経路探索を待つフレームで埋まっていても中継できる
+                auto opt_gateway_id = ds.find_known_gateway(ns, destination);
+                if (opt_gateway_id.has_value() && holding_.is_resolved_pushable()) {
+                    holding_.push_resolved(*opt_gateway_id, frame.payload.make_initial_clone());
+                } else if (!opt_gateway_id.has_value() && holding_.is_pushable(destination)) {
+                    holding_.push(destination, frame.payload.make_initial_clone(), etl::nullopt);
+                } else {
+                    drop_relay(frame);
+                }
             };
             auto broadcast = [&]() {
-                task_ = SendFrameTask::broadcast(etl::move(reader), etl::nullopt, etl::nullopt);
+                auto suppression = neighbor::BroadcastSuppression::start(
+                    lns.config(), frame.source.node_id.hash(), frame.frame_id, time, rand
+                );
+                if (suppression.has_value() && !assessing_.full()) {
+                    assessing_.emplace_back(AssessingBroadcast{
+                        .reader = frame.payload.make_initial_clone(),
+                        .suppression = *suppression,
+                    });
+                } else if (!suppression.has_value() && !send_tasks_.full()) {
+                    send_tasks_.emplace(SendFrameTask::broadcast(
+                        frame.payload.make_initial_clone(), etl::nullopt, etl::nullopt
+                    ));
+                } else {
+                    drop_relay(frame);
+                }
             };
 
             if (destination.is_unicast()) {
@@ -47,6 +115,55 @@ namespace net::routing::task {
             }
         }
 
+        // 判定を終えたブロードキャストのうち，中継するものを送信タスクに移す
+        void poll_assessing_broadcasts(util::Time &time) {
+            uint8_t i = 0;
+            while (i < assessing_.size()) {
+                auto &[reader, suppression] = assessing_[i];
+                auto poll_suppressed = suppression.poll_suppressed(duplicate_detector_, time);
+                if (poll_suppressed.is_pending()) {
+                    i++;
+                    continue;
+                }
+
+                if (!poll_suppressed.unwrap()) {
+                    if (send_tasks_.full()) {
+                        i++;
+                        continue;
+                    }
+                    send_tasks_.emplace(
+                        SendFrameTask::broadcast(etl::move(reader), etl::nullopt, etl::nullopt)
+                    );
+                }
+                assessing_.remove(i);
+            }
+        }
+
+        void on_frame_received(
+            RoutingFrame &&frame,
+            const local::LocalNodeService &lns,
+            neighbor::NeighborService &ns,
+            discovery::DiscoveryService &ds,
+            const local::LocalNodeInfo &local,
+            util::Time &time,
+            util::Rand &rand
+        ) {
+            if (local.source.matches(frame.destination)) {
+                if (accepted_frames_.full()) {
+                    LOG_INFO(FLASH_STRING("Routing: accepted frame queue full, drop frame"));
+                    dropped_frame_count_++;
+                } else {
+                    accepted_frames_.push(frame.clone());
+                }
+
+                if (frame.destination.is_unicast()) {
+                    return;
+                }
+            }
+
+            relay_frame(frame, lns, ns, ds, local, time, rand);
+        }
+
       public:
         RoutingSocketEvent execute(
             frame::FrameService &fs,
@@ -66,83 +183,83 @@ namespace net::routing::task {
             }
             const auto &local = poll_local.unwrap();
 
-            if (etl::holds_alternative<etl::monostate>(task_)) {
+            if (etl::holds_alternative<etl::monostate>(receive_task_)) {
                 nb::Poll<neighbor::ReceivedNeighborFrame> &&poll_frame =
                     socket.poll_receive_frame(time);
                 if (poll_frame.is_ready()) {
-                    task_.emplace<ReceiveFrameTask>(etl::move(poll_frame.unwrap()));
+                    receive_task_.emplace<ReceiveFrameTask>(etl::move(poll_frame.unwrap()));
                 }
             }
 
-            if (etl::holds_alternative<ReceiveFrameTask>(task_)) {
-                auto &task = etl::get<ReceiveFrameTask>(task_);
-                if (task.execute(ns, frame_id_cache_, local, time).is_pending()) {
-                    return result;
-                }
-
-                auto &opt_frame = task.result();
-                if (!opt_frame.has_value()) {
-                    task_.emplace<etl::monostate>();
-                    return result;
-                }
-
-                result.set_frame_received();
-
-                // すでに受信済みのフレームがある場合は、今受信したフレームを破棄する
-                if (accepted_frame_.has_value()) {
-                    task_.emplace<etl::monostate>();
-                    return result;
-                }
-
-                auto frame = etl ::move(opt_frame.value());
-                task_.emplace<etl::monostate>();
-                if (local.source.matches(frame.destination)) {
-                    accepted_frame_.emplace(frame.clone());
-
-                    if (frame.destination.is_unicast()) {
-                        return result;
+            if (etl::holds_alternative<ReceiveFrameTask>(receive_task_)) {
+                auto &task = etl::get<ReceiveFrameTask>(receive_task_);
+                if (task.execute(ns, duplicate_detector_, local, time).is_ready()) {
+                    auto opt_frame = etl::move(task.result());
+                    receive_task_.emplace<etl::monostate>();
+                    if (opt_frame.has_value()) {
+                        result.set_frame_received();
+                        ds.learn_reverse_path(
+                            ns, local, opt_frame->source, opt_frame->previous_hop, time
+                        );
+                        ds.on_reachable(opt_frame->source);
+                        on_frame_received(etl::move(*opt_frame), lns, ns, ds, local, time, rand);
                     }
                 }
-
-                send_frame(frame.destination, frame.payload.make_initial_clone(), local, time);
             }
 
-            if (etl::holds_alternative<SendFrameTask>(task_)) {
-                auto &send_task = etl::get<SendFrameTask>(task_);
-                auto poll_result = send_task.execute(lns, ns, ds, socket, time, rand);
-                if (poll_result.is_ready()) {
-                    task_.emplace<etl::monostate>();
-                }
-            }
+            holding_.execute(lns, ns, ds, socket, time, rand);
+            poll_assessing_broadcasts(time);
+            send_tasks_.execute([&](SendFrameTask &task) { return task.execute(ns, socket); });
 
             return result;
         }
 
         inline nb::Poll<nb::Future<SendResult>>
         poll_send_frame(const node::Destination &destination, frame::FrameBufferReader &&reader) {
-            if (!etl::holds_alternative<etl::monostate>(task_)) {
+            if (!is_send_task_addable(destination)) {
                 return nb::pending;
             }
 
             auto [f, p] = nb::make_future_promise_pair<SendResult>();
-            task_ = destination.is_unicast()
-                ? SendFrameTask::unicast(destination, etl::move(reader), etl::move(p))
-                : SendFrameTask::broadcast(etl::move(reader), etl::nullopt, etl::move(p));
+            if (destination.is_unicast()) {
+                holding_.push(destination, etl::move(reader), etl::move(p));
+            } else {
+                send_tasks_.emplace(
+                    SendFrameTask::broadcast(etl::move(reader), etl::nullopt, etl::move(p))
+                );
+            }
             return etl::move(f);
         }
 
         inline nb::Poll<RoutingFrame> poll_receive_frame() {
-            if (accepted_frame_.has_value()) {
-                auto frame = etl::move(*accepted_frame_);
-                accepted_frame_.reset();
-                return frame;
-            } else {
+            if (accepted_frames_.empty()) {
                 return nb::pending;
             }
+            auto frame = etl::move(accepted_frames_.front());
+            accepted_frames_.pop();
+            return frame;
+        }
+
+        // 受信キューが満杯だったために破棄された，自ノード宛てのフレームの数
+        inline uint16_t dropped_frame_count() const {
+            return dropped_frame_count_;
+        }
+
+        inline void reset_dropped_frame_count() {
+            dropped_frame_count_ = 0;
+        }
+
+        // 中継先の空きがなかったために破棄された，中継するフレームの数
+        inline uint16_t dropped_relay_count() const {
+            return dropped_relay_count_;
+        }
+
+        inline void reset_dropped_relay_count() {
+            dropped_relay_count_ = 0;
         }
 
-        inline frame::FrameId generate_frame_id(util::Rand &rand) {
-            return frame_id_cache_.generate(rand);
+        inline frame::FrameId generate_frame_id(const node::Source &source, util::Rand &rand) {
+            return duplicate_detector_.generate(source.node_id.hash(), rand);
         }
     };
 } // namespace net::routing::task
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "../constants.h"
+#include "../frame.h"
+#include <net/discovery.h>
+#include <tl/vec.h>
+
+namespace net::routing::task {
+    struct HeldFrame {
+        // 経路探索を待つ宛先の位置．ゲートウェイが既に分かっている場合はそのノード
+        etl::variant<uint8_t, node::NodeId> next_hop;
+        frame::FrameBufferReader reader;
+        etl::optional<nb::Promise<SendResult>> promise;
+
+        inline bool is_waiting_for(uint8_t destination_index) const {
+            return etl::holds_alternative<uint8_t>(next_hop) &&
+                etl::get<uint8_t>(next_hop) == destination_index;
+        }
+
+        inline bool is_resolved() const {
+            return etl::holds_alternative<node::NodeId>(next_hop);
+        }
+
+        inline void complete(const SendResult &result) {
+            if (promise.has_value()) {
+                promise->set_value(result);
+            }
+        }
+    };
+
+    class HoldingDestination {
+        node::Destination destination_;
+        discovery::DiscoveryTask discovery_task_;
+        etl::optional<node::NodeId> gateway_id_{};
+
+      public:
+        explicit HoldingDestination(const node::Destination &destination)
+            : destination_{destination},
+              discovery_task_{destination} {}
+
+        inline const node::Destination &destination() const {
+            return destination_;
+        }
+
+        // 経路探索が完了した場合にゲートウェイを返す．到達できない場合はnulloptを返す
+        nb::Poll<etl::optional<node::NodeId>> poll_gateway(
+            const local::LocalNodeService &lns,
+            neighbor::NeighborService &ns,
+            discovery::DiscoveryService &ds,
+            util::Time &time,
+            util::Rand &rand
+        ) {
+            if (gateway_id_.has_value()) {
+                return gateway_id_;
+            }
+
+            auto opt_gateway_id =
+                POLL_UNWRAP_OR_RETURN(discovery_task_.execute(lns, ns, ds, time, rand));
+            gateway_id_ = opt_gateway_id;
+            return opt_gateway_id;
+        }
+    };
+
+    /**
+     * 経路探索の完了を待つユニキャストフレームを，宛先ごとに保持するキュー．
+     *
+     * 同じ宛先へのフレームは1回の経路探索を共有し，ゲートウェイが見つかるとまとめて送信される．
+     * 宛先に到達できない場合は，保持していたフレームを全て`SendError::UnreachableNode`で失敗させる．
+     * 保持しているフレームはフレームバッファを参照し続けるため，保持できる数を制限している．
+     *
+     * 経路探索を待つフレームで埋まっても，ゲートウェイが分かっているフレームは中継できるよう，
+     * そのための空きを1つ残しておく．
+     * 受信はこのキューの空きを待たないため，到達できない宛先で`MAX_HOLDING_DESTINATIONS`が
+     * 埋まっても受信は止まらず，保持できない中継フレームだけが破棄される．
+     */
+    class HoldingQueue {
+        static constexpr uint8_t MAX_WAITING_FRAMES = HOLDING_FRAME_QUEUE_SIZE - 1;
+
+        tl::Vec<HeldFrame, HOLDING_FRAME_QUEUE_SIZE> frames_{};
+        etl::array<etl::optional<HoldingDestination>, MAX_HOLDING_DESTINATIONS> destinations_{};
+
+        etl::optional<uint8_t> find_destination(const node::Destination &destination) const {
+            for (uint8_t i = 0; i < MAX_HOLDING_DESTINATIONS; i++) {
+                if (destinations_[i] && destinations_[i]->destination() == destination) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        etl::optional<uint8_t> find_vacant_destination() const {
+            for (uint8_t i = 0; i < MAX_HOLDING_DESTINATIONS; i++) {
+                if (!destinations_[i]) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        uint8_t vacant_destination_count() const {
+            uint8_t count = 0;
+            for (const auto &destination : destinations_) {
+                count += destination ? 0 : 1;
+            }
+            return count;
+        }
+
+        uint8_t waiting_frame_count() const {
+            uint8_t count = 0;
+            for (const auto &frame : frames_) {
+                count += frame.is_resolved() ? 0 : 1;
+            }
+            return count;
+        }
+
+        // 宛先のフレームのうち，最も古いものの位置を返す
+        etl::optional<uint8_t> find_front(uint8_t destination_index) const {
+            for (uint8_t i = 0; i < frames_.size(); i++) {
+                if (frames_[i].is_waiting_for(destination_index)) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        etl::optional<uint8_t> find_front_resolved() const {
+            for (uint8_t i = 0; i < frames_.size(); i++) {
+                if (frames_[i].is_resolved()) {
+                    return i;
+                }
+            }
+            return etl::nullopt;
+        }
+
+        void fail_all(uint8_t destination_index) {
+            LOG_INFO(
+                FLASH_STRING("Routing: unreachable, drop held frames: "),
+                destinations_[destination_index]->destination()
+            );
+
+            auto opt_index = find_front(destination_index);
+            while (opt_index.has_value()) {
+                auto held = frames_.remove(*opt_index);
+                held.complete(etl::unexpected<neighbor::SendError>{
+                    neighbor::SendError::UnreachableNode
+                });
+                opt_index = find_front(destination_index);
+            }
+            destinations_[destination_index].reset();
+        }
+
+        // `index`のフレームを`gateway_id`へ送信する．送信を要求できた場合はフレームを取り除く
+        template <uint8_t N>
+        nb::Poll<void> send(
+            uint8_t index,
+            const node::NodeId &gateway_id,
+            neighbor::NeighborService &ns,
+            neighbor::NeighborSocket<N> &socket
+        ) {
+            etl::expected<nb::Poll<void>, neighbor::SendError> result =
+                socket.poll_send_frame(ns, gateway_id, etl::move(frames_[index].reader));
+            if (result.has_value() && result.value().is_pending()) {
+                return nb::pending;
+            }
+
+            auto held = frames_.remove(index);
+            if (result.has_value()) {
+                held.complete(etl::expected<void, neighbor::SendError>{});
+            } else {
+                held.complete(etl::unexpected<neighbor::SendError>{result.error()});
+            }
+            return nb::ready();
+        }
+
+        // 宛先のフレームを送信できるだけ送信し，全て送信した場合はreadyを返す
+        template <uint8_t N>
+        nb::Poll<void> flush(
+            uint8_t destination_index,
+            const node::NodeId &gateway_id,
+            neighbor::NeighborService &ns,
+            neighbor::NeighborSocket<N> &socket
+        ) {
+            auto opt_index = find_front(destination_index);
+            while (opt_index.has_value()) {
+                POLL_UNWRAP_OR_RETURN(send(*opt_index, gateway_id, ns, socket));
+                opt_index = find_front(destination_index);
+            }
+            return nb::ready();
+        }
+
+        // ゲートウェイが分かっているフレームを，送信できるだけ送信する
+        template <uint8_t N>
+        void flush_resolved(neighbor::NeighborService &ns, neighbor::NeighborSocket<N> &socket) {
+            auto opt_index = find_front_resolved();
+            while (opt_index.has_value()) {
+                auto gateway_id = etl::get<node::NodeId>(frames_[*opt_index].next_hop);
+                if (send(*opt_index, gateway_id, ns, socket).is_pending()) {
+                    return;
+                }
+                opt_index = find_front_resolved();
+            }
+        }
+
+      public:
+        // 経路探索を待つフレームとして，`destination`宛てのフレームを保持できるかを返す
+        bool is_pushable(const node::Destination &destination) const {
+            if (waiting_frame_count() >= MAX_WAITING_FRAMES) {
+                return false;
+            }
+            return find_destination(destination).has_value() || vacant_destination_count() > 0;
+        }
+
+        // ゲートウェイが分かっているフレームを保持できるかを返す
+        inline bool is_resolved_pushable() const {
+            return !frames_.full();
+        }
+
+        void push(
+            const node::Destination &destination,
+            frame::FrameBufferReader &&reader,
+            etl::optional<nb::Promise<SendResult>> &&promise
+        ) {
+            FASSERT(is_pushable(destination));
+
+            auto opt_index = find_destination(destination);
+            if (!opt_index.has_value()) {
+                opt_index = find_vacant_destination();
+                FASSERT(opt_index.has_value());
+                destinations_[*opt_index].emplace(destination);
+            }
+            frames_.emplace_back(HeldFrame{
+                .next_hop = *opt_index,
+                .reader = etl::move(reader),
+                .promise = etl::move(promise),
+            });
+        }
+
+        // 経路探索を行わずに，`gateway_id`へ送信するフレームを保持する
+        void push_resolved(const node::NodeId &gateway_id, frame::FrameBufferReader &&reader) {
+            FASSERT(is_resolved_pushable());
+            frames_.emplace_back(HeldFrame{
+                .next_hop = gateway_id,
+                .reader = etl::move(reader),
+                .promise = etl::nullopt,
+            });
+        }
+
+        template <uint8_t N>
+        void execute(
+            const local::LocalNodeService &lns,
+            neighbor::NeighborService &ns,
+            discovery::DiscoveryService &ds,
+            neighbor::NeighborSocket<N> &socket,
+            util::Time &time,
+            util::Rand &rand
+        ) {
+            flush_resolved(ns, socket);
+
+            for (uint8_t i = 0; i < MAX_HOLDING_DESTINATIONS; i++) {
+                if (!destinations_[i].has_value()) {
+                    continue;
+                }
+
+                auto poll_gateway = destinations_[i]->poll_gateway(lns, ns, ds, time, rand);
+                if (poll_gateway.is_pending()) {
+                    continue;
+                }
+
+                const auto &opt_gateway_id = poll_gateway.unwrap();
+                if (!opt_gateway_id.has_value()) {
+                    fail_all(i);
+                    continue;
+                }
+
+                if (flush(i, *opt_gateway_id, ns, socket).is_ready()) {
+                    destinations_[i].reset();
+                }
+            }
+        }
+    };
+} // namespace net::routing::task
@@ -30,7 +30,7 @@ namespace net::routing::task {
         template <uint8_t N>
         inline nb::Poll<void> execute(
             neighbor::NeighborService &ns,
-            frame::FrameIdCache<N> &frame_id_cache,
+            frame::DuplicateDetector<N> &duplicate_detector,
             const local::LocalNodeInfo &local,
             util::Time &time
         ) {
@@ -43,7 +43,9 @@ namespace net::routing::task {
                 }
 
                 RoutingFrame &&deserialized = deserializer.as_frame(frame);
-                if (frame_id_cache.insert_and_check_contains(deserialized.frame_id)) {
+                uint8_t source_hash = deserialized.source.node_id.hash();
+                auto frame_id = deserialized.frame_id;
+                if (duplicate_detector.insert_and_check_contains(source_hash, frame_id, time)) {
                     state_.emplace<Result>(etl::nullopt);
                     return nb::ready();
                 }
@@ -5,6 +5,8 @@
 
 namespace net::rpc {
     constexpr inline uint8_t FRAME_DELAY_POOL_SIZE = 4;
+    // リクエストが連続して届いても取りこぼさないよう，既定値より多く保持する
+    constexpr inline uint8_t ACCEPTED_FRAME_QUEUE_SIZE = 4;
     constexpr inline neighbor::NeighborSocketConfig SOCKET_CONFIG{.do_delay = true};
 
     constexpr inline util::Duration RESPONSE_TIMEOUT = util::Duration::from_seconds(5);
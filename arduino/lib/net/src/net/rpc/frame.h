@@ -18,6 +18,8 @@ namespace net::rpc {
     enum class Procedure : RawProcedure {
         // Debug 1~99
         Blink = 1,
+        GetFrameBufferPoolStats = 10,
+        ResetFrameBufferPoolStats = 11,
 
         // Media 100~199
         GetMediaList = 100,
@@ -34,6 +36,7 @@ namespace net::rpc {
 
         // Serial 400~499
         SetAddress = 400,
+        NegotiateBaudRate = 401,
 
         // Ethernet 500~599
         SetEthernetIpAddress = 500,
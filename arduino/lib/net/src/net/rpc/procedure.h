@@ -3,6 +3,8 @@
 #include "./frame.h"
 #include "./procedures/address/resolve_address.h"
 #include "./procedures/debug/blink.h"
+#include "./procedures/debug/get_frame_buffer_pool_stats.h"
+#include "./procedures/debug/reset_frame_buffer_pool_stats.h"
 #include "./procedures/dummy/error.h"
 #include "./procedures/ethernet/set_ethernet_ip_address.h"
 #include "./procedures/ethernet/set_ethernet_subnet_mask.h"
@@ -12,6 +14,7 @@
 #include "./procedures/local/set_cost.h"
 #include "./procedures/media/get_media_list.h"
 #include "./procedures/neighbor/send_hello.h"
+#include "./procedures/serial/negotiate_baud_rate.h"
 #include "./procedures/serial/set_address.h"
 #include "./procedures/wifi/close_server.h"
 #include "./procedures/wifi/connect_to_access_point.h"
@@ -24,11 +27,14 @@ namespace net::rpc {
         using Executor = etl::variant<
             dummy::error::Executor,
             debug::blink::Executor,
+            debug::get_frame_buffer_pool_stats::Executor,
+            debug::reset_frame_buffer_pool_stats::Executor,
             media::get_media_list::Executor,
             wifi::connect_to_access_point::Executor,
             wifi::start_server::Executor,
             wifi::close_server::Executor,
             serial::set_address::Executor,
+            serial::negotiate_baud_rate::Executor,
             ethernet::set_ethernet_ip_address::Executor,
             ethernet::set_ethernet_subnet_mask::Executor,
             local::set_cost::Executor,
@@ -44,6 +50,10 @@ namespace net::rpc {
             switch (procedure) {
             case static_cast<uint16_t>(Procedure::Blink):
                 return debug::blink::Executor{etl::move(ctx)};
+            case static_cast<uint16_t>(Procedure::GetFrameBufferPoolStats):
+                return debug::get_frame_buffer_pool_stats::Executor{etl::move(ctx)};
+            case static_cast<uint16_t>(Procedure::ResetFrameBufferPoolStats):
+                return debug::reset_frame_buffer_pool_stats::Executor{etl::move(ctx)};
             case static_cast<uint16_t>(Procedure::GetMediaList):
                 return media::get_media_list::Executor{etl::move(ctx)};
             case static_cast<uint16_t>(Procedure::ConnectToAccessPoint):
@@ -54,6 +64,8 @@ namespace net::rpc {
                 return wifi::close_server::Executor{etl::move(ctx)};
             case static_cast<uint16_t>(Procedure::SetAddress):
                 return serial::set_address::Executor{etl::move(ctx)};
+            case static_cast<uint16_t>(Procedure::NegotiateBaudRate):
+                return serial::negotiate_baud_rate::Executor{etl::move(ctx)};
             case static_cast<uint16_t>(Procedure::SetEthernetIpAddress):
                 return ethernet::set_ethernet_ip_address::Executor{etl::move(ctx)};
             case static_cast<uint16_t>(Procedure::SetCost):
@@ -96,6 +108,12 @@ namespace net::rpc {
                     [&](debug::blink::Executor &executor) {
                         return executor.execute(fs, lns, time, rand);
                     },
+                    [&](debug::get_frame_buffer_pool_stats::Executor &executor) {
+                        return executor.execute(fs, lns, time, rand);
+                    },
+                    [&](debug::reset_frame_buffer_pool_stats::Executor &executor) {
+                        return executor.execute(fs, lns, time, rand);
+                    },
                     [&](media::get_media_list::Executor &executor) {
                         return executor.execute(fs, ms, lns, time, rand);
                     },
@@ -111,6 +129,9 @@ namespace net::rpc {
                     [&](serial::set_address::Executor &executor) {
                         return executor.execute(fs, ms, lns, time, rand);
                     },
+                    [&](serial::negotiate_baud_rate::Executor &executor) {
+                        return executor.execute(fs, ms, lns, time, rand);
+                    },
                     [&](ethernet::set_ethernet_ip_address::Executor &executor) {
                         return executor.execute(fs, ms, lns, time, rand);
                     },
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../../request.h"
+
+namespace net::rpc::debug::reset_frame_buffer_pool_stats {
+    class Executor {
+        RequestContext ctx_;
+
+      public:
+        explicit Executor(RequestContext &&ctx) : ctx_{etl::move(ctx)} {}
+
+        nb::Poll<void> execute(
+            frame::FrameService &fs,
+            const net::local::LocalNodeService &lns,
+            util::Time &time,
+            util::Rand &rand
+        ) {
+            if (ctx_.is_response_property_set()) {
+                return ctx_.poll_send_response(fs, lns, time, rand);
+            }
+
+            fs.reset_pool_stats();
+            ctx_.set_response_property(Result::Success, 0);
+            return ctx_.poll_send_response(fs, lns, time, rand);
+        }
+    };
+} // namespace net::rpc::debug::reset_frame_buffer_pool_stats
@@ -6,6 +6,11 @@
 #include <net/routing.h>
 
 namespace net::rpc {
+    using RpcSocket = routing::RoutingSocket<
+        FRAME_DELAY_POOL_SIZE,
+        routing::DEFAULT_TASK_POOL_SIZE,
+        ACCEPTED_FRAME_QUEUE_SIZE>;
+
     class Request {
         RawProcedure procedure_;
         RequestId request_id_;
@@ -71,7 +76,7 @@ namespace net::rpc {
         nb::Poll<etl::reference_wrapper<frame::FrameBufferWriter>> poll_response_frame_writer(
             frame::FrameService &fs,
             const local::LocalNodeService &lns,
-            routing::RoutingSocket<FRAME_DELAY_POOL_SIZE> &socket,
+            RpcSocket &socket,
             util::Rand &rand,
             const Request &request
         ) {
@@ -105,7 +110,7 @@ namespace net::rpc {
         }
 
         inline nb::Poll<etl::expected<void, net::neighbor::SendError>> poll_send_response(
-            routing::RoutingSocket<FRAME_DELAY_POOL_SIZE> &socket,
+            RpcSocket &socket,
             util::Time &time,
             util::Rand &rand,
             const node::Source &client
@@ -125,7 +130,7 @@ namespace net::rpc {
     };
 
     class RequestContext {
-        memory::Static<routing::RoutingSocket<FRAME_DELAY_POOL_SIZE>> &socket_;
+        memory::Static<RpcSocket> &socket_;
         Request request_;
         Response response_{};
         nb::Delay response_timeout_;
@@ -133,7 +138,7 @@ namespace net::rpc {
       public:
         explicit RequestContext(
             util::Time &time,
-            memory::Static<routing::RoutingSocket<FRAME_DELAY_POOL_SIZE>> &socket,
+            memory::Static<RpcSocket> &socket,
             Request &&request
         )
             : socket_{socket},
@@ -191,11 +196,11 @@ namespace net::rpc {
     };
 
     class RequestReceiver {
-        memory::Static<routing::RoutingSocket<FRAME_DELAY_POOL_SIZE>> socket_;
+        memory::Static<RpcSocket> socket_;
         etl::optional<DeserializeFrame> deserializer_;
 
       public:
-        explicit RequestReceiver(routing::RoutingSocket<FRAME_DELAY_POOL_SIZE> &&socket)
+        explicit RequestReceiver(RpcSocket &&socket)
             : socket_{etl::move(socket)} {}
 
         inline void execute(
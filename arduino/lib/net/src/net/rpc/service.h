@@ -11,7 +11,7 @@ namespace net::rpc {
 
       public:
         explicit RpcService(link::LinkService &link_service)
-            : receiver_{routing::RoutingSocket<FRAME_DELAY_POOL_SIZE>{
+            : receiver_{RpcSocket{
                   link_service.open(frame::ProtocolNumber::Rpc), SOCKET_CONFIG
               }} {}
 
@@ -11,8 +11,9 @@
 #include <util/time.h>
 
 namespace net {
-    template <uint8_t SHORT_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
-    using BufferPool = frame::MultiSizeFrameBufferPool<SHORT_BUFFER_COUNT, LARGE_BUFFER_COUNT>;
+    template <uint8_t SHORT_BUFFER_COUNT, uint8_t MEDIUM_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
+    using BufferPool = frame::
+        MultiSizeFrameBufferPool<SHORT_BUFFER_COUNT, MEDIUM_BUFFER_COUNT, LARGE_BUFFER_COUNT>;
 
     class NetService {
         link::LinkService link_service_;
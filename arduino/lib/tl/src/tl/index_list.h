@@ -0,0 +1,101 @@
+#pragma once
+
+#include <etl/array.h>
+#include <etl/optional.h>
+#include <logger.h>
+#include <stdint.h>
+
+namespace tl {
+    /**
+     * 添字`0`から`N - 1`を要素とする双方向連結リスト．
+     *
+     * 外部の配列の添字を並べ替えるために使い，末尾への追加と任意の要素の削除をO(1)で行う．
+     * 同じ添字を2回追加してはならず，リストに含まれない添字を削除してはならない．
+     */
+    template <uint8_t N>
+    class IndexList {
+        static_assert(N > 0 && N < 0xFF);
+
+        static constexpr uint8_t NIL = 0xFF;
+
+        etl::array<uint8_t, N> prev_;
+        etl::array<uint8_t, N> next_;
+        uint8_t head_{NIL};
+        uint8_t tail_{NIL};
+        uint8_t size_{0};
+
+      public:
+        IndexList() {
+            prev_.fill(NIL);
+            next_.fill(NIL);
+        }
+
+        inline uint8_t size() const {
+            return size_;
+        }
+
+        inline bool empty() const {
+            return size_ == 0;
+        }
+
+        inline etl::optional<uint8_t> front() const {
+            return head_ == NIL ? etl::nullopt : etl::optional<uint8_t>{head_};
+        }
+
+        void push_back(uint8_t index) {
+            FASSERT(index < N);
+            FASSERT(size_ < N);
+
+            prev_[index] = tail_;
+            next_[index] = NIL;
+            if (tail_ == NIL) {
+                head_ = index;
+            } else {
+                next_[tail_] = index;
+            }
+            tail_ = index;
+            size_++;
+        }
+
+        void remove(uint8_t index) {
+            FASSERT(index < N);
+            FASSERT(size_ > 0);
+
+            uint8_t prev = prev_[index];
+            uint8_t next = next_[index];
+            if (prev == NIL) {
+                head_ = next;
+            } else {
+                next_[prev] = next;
+            }
+            if (next == NIL) {
+                tail_ = prev;
+            } else {
+                prev_[next] = prev;
+            }
+            prev_[index] = NIL;
+            next_[index] = NIL;
+            size_--;
+        }
+
+        inline void move_to_back(uint8_t index) {
+            remove(index);
+            push_back(index);
+        }
+
+        inline etl::optional<uint8_t> pop_front() {
+            auto index = front();
+            if (index.has_value()) {
+                remove(*index);
+            }
+            return index;
+        }
+
+        template <typename F>
+        inline void for_each(F &&f) const {
+            for (uint8_t index = head_; index != NIL; index = next_[index]) {
+                f(index);
+            }
+        }
+    };
+} // namespace tl
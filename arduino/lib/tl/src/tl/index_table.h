@@ -0,0 +1,108 @@
+#pragma once
+
+#include <etl/array.h>
+#include <etl/optional.h>
+#include <logger.h>
+#include <stdint.h>
+
+namespace tl {
+    /**
+     * `IndexTable`に負荷率75%以下で格納できる要素数の上限．スロット数の上限128に対応する
+     */
+    constexpr uint8_t MAX_INDEX_TABLE_ELEMENT_COUNT = 96;
+
+    /**
+     * 負荷率が75%以下になる最小の2の冪を返す
+     *
+     * `IndexTable`のスロット数は128以下であるため，
+     * 要素数は`MAX_INDEX_TABLE_ELEMENT_COUNT`以下である必要がある
+     */
+    template <uint16_t ELEMENT_COUNT>
+    inline constexpr uint8_t index_table_slot_count() {
+        static_assert(ELEMENT_COUNT > 0 && ELEMENT_COUNT < 0xFF, "invalid element count");
+
+        constexpr uint16_t slot_count = []() {
+            uint16_t required = ELEMENT_COUNT + (ELEMENT_COUNT + 2) / 3;
+            uint16_t count = 1;
+            while (count < required) {
+                count <<= 1;
+            }
+            return count;
+        }();
+        static_assert(slot_count <= 128, "too many elements for IndexTable");
+        return static_cast<uint8_t>(slot_count);
+    }
+
+    /**
+     * 要素の添字を格納する，オープンアドレス法（線形探査）によるハッシュ索引．
+     *
+     * キーそのものは保持しないため，検索時は候補の添字を述語で検証する．
+     * 個別の削除には対応しないため，要素を削除した場合は`clear`して再構築すること．
+     */
+    template <uint8_t SLOT_COUNT>
+    class IndexTable {
+        static_assert(SLOT_COUNT > 0 && SLOT_COUNT <= 128);
+        static_assert((SLOT_COUNT & (SLOT_COUNT - 1)) == 0, "SLOT_COUNT must be a power of two");
+
+        static constexpr uint8_t EMPTY = 0xFF;
+        static constexpr uint8_t MASK = SLOT_COUNT - 1;
+
+        // 連続したハッシュ値が隣接するスロットに並ぶと線形探査の連鎖が伸びるため，
+        // 黄金比に近い奇数を掛けた値の上位ビットを最初のスロットとする
+        static constexpr uint8_t HASH_MULTIPLIER = 157;
+
+        static inline uint8_t home_slot(uint8_t hash) {
+            uint8_t mixed = static_cast<uint8_t>(hash * HASH_MULTIPLIER);
+            return static_cast<uint8_t>((static_cast<uint16_t>(mixed) * SLOT_COUNT) >> 8);
+        }
+
+        etl::array<uint8_t, SLOT_COUNT> slots_;
+        uint8_t size_{0};
+
+      public:
+        IndexTable() {
+            clear();
+        }
+
+        inline void clear() {
+            slots_.fill(EMPTY);
+            size_ = 0;
+        }
+
+        inline uint8_t size() const {
+            return size_;
+        }
+
+        inline bool full() const {
+            return size_ == SLOT_COUNT;
+        }
+
+        void insert(uint8_t hash, uint8_t index) {
+            FASSERT(index != EMPTY);
+            FASSERT(!full());
+
+            uint8_t slot = home_slot(hash);
+            while (slots_[slot] != EMPTY) {
+                slot = (slot + 1) & MASK;
+            }
+            slots_[slot] = index;
+            size_++;
+        }
+
+        template <typename F>
+        etl::optional<uint8_t> find(uint8_t hash, F &&matches) const {
+            uint8_t slot = home_slot(hash);
+            for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+                uint8_t index = slots_[slot];
+                if (index == EMPTY) {
+                    return etl::nullopt;
+                }
+                if (matches(index)) {
+                    return index;
+                }
+                slot = (slot + 1) & MASK;
+            }
+            return etl::nullopt;
+        }
+    };
+} // namespace tl
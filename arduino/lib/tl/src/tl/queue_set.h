@@ -0,0 +1,174 @@
+#pragma once
+
+#include <etl/array.h>
+#include <etl/optional.h>
+#include <etl/utility.h>
+#include <logger.h>
+#include <memory/maybe_uninit.h>
+#include <stdint.h>
+
+namespace tl {
+    /**
+     * 容量を共有する複数のFIFOキュー．
+     *
+     * 要素は共通の領域に格納され，各キューは要素の添字を連結したリストで表現される．
+     * そのため，どのキューも合計`CAPACITY`個まで要素を保持でき，先頭要素の追加・削除はO(1)で行える．
+     */
+    template <typename T, uint8_t CAPACITY, uint8_t QUEUE_COUNT>
+    class QueueSet {
+        static_assert(CAPACITY > 0 && CAPACITY < 0xFF);
+
+        static constexpr uint8_t NIL = 0xFF;
+
+        etl::array<memory::MaybeUninit<T>, CAPACITY> values_;
+        etl::array<uint8_t, CAPACITY> next_;
+        etl::array<uint8_t, QUEUE_COUNT> heads_;
+        etl::array<uint8_t, QUEUE_COUNT> tails_;
+        uint8_t free_head_{0};
+        uint8_t size_{0};
+
+        inline T take(uint8_t index) {
+            T value = etl::move(values_[index].get());
+            values_[index].destroy();
+            next_[index] = free_head_;
+            free_head_ = index;
+            size_--;
+            return value;
+        }
+
+      public:
+        QueueSet(const QueueSet &) = delete;
+        QueueSet(QueueSet &&) = delete;
+        QueueSet &operator=(const QueueSet &) = delete;
+        QueueSet &operator=(QueueSet &&) = delete;
+
+        QueueSet() {
+            heads_.fill(NIL);
+            tails_.fill(NIL);
+            for (uint8_t i = 0; i < CAPACITY; i++) {
+                next_[i] = i + 1 < CAPACITY ? i + 1 : NIL;
+            }
+        }
+
+        ~QueueSet() {
+            for (uint8_t queue = 0; queue < QUEUE_COUNT; queue++) {
+                for (uint8_t i = heads_[queue]; i != NIL; i = next_[i]) {
+                    values_[i].destroy();
+                }
+            }
+        }
+
+        inline uint8_t size() const {
+            return size_;
+        }
+
+        inline bool full() const {
+            return size_ == CAPACITY;
+        }
+
+        inline bool empty(uint8_t queue) const {
+            FASSERT(queue < QUEUE_COUNT);
+            return heads_[queue] == NIL;
+        }
+
+        template <typename... Args>
+        void emplace_back(uint8_t queue, Args &&...args) {
+            FASSERT(queue < QUEUE_COUNT);
+            FASSERT(!full());
+
+            uint8_t index = free_head_;
+            free_head_ = next_[index];
+            values_[index].set(T{etl::forward<Args>(args)...});
+            next_[index] = NIL;
+            size_++;
+
+            if (tails_[queue] == NIL) {
+                heads_[queue] = index;
+            } else {
+                next_[tails_[queue]] = index;
+            }
+            tails_[queue] = index;
+        }
+
+        inline T &front(uint8_t queue) {
+            FASSERT(!empty(queue));
+            return values_[heads_[queue]].get();
+        }
+
+        inline const T &front(uint8_t queue) const {
+            FASSERT(!empty(queue));
+            return values_[heads_[queue]].get();
+        }
+
+        T pop_front(uint8_t queue) {
+            FASSERT(!empty(queue));
+
+            uint8_t index = heads_[queue];
+            heads_[queue] = next_[index];
+            if (heads_[queue] == NIL) {
+                tails_[queue] = NIL;
+            }
+            return take(index);
+        }
+
+        // 末尾の要素の直前を辿るため，キューの長さに比例する時間がかかる
+        T pop_back(uint8_t queue) {
+            FASSERT(!empty(queue));
+
+            uint8_t index = tails_[queue];
+            if (heads_[queue] == index) {
+                heads_[queue] = NIL;
+                tails_[queue] = NIL;
+                return take(index);
+            }
+
+            uint8_t prev = heads_[queue];
+            while (next_[prev] != index) {
+                prev = next_[prev];
+            }
+            next_[prev] = NIL;
+            tails_[queue] = prev;
+            return take(index);
+        }
+
+        /**
+         * キューを先頭から走査し，条件を満たす最初の要素へのポインタを返す．
+         */
+        template <typename F>
+        const T *find_first_if(uint8_t queue, F &&predicate) const {
+            FASSERT(queue < QUEUE_COUNT);
+            for (uint8_t i = heads_[queue]; i != NIL; i = next_[i]) {
+                if (predicate(values_[i].get())) {
+                    return values_[i].get_ptr();
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * キューを先頭から走査し，条件を満たす最初の要素を取り出す．
+         */
+        template <typename F>
+        etl::optional<T> pop_first_if(uint8_t queue, F &&predicate) {
+            FASSERT(queue < QUEUE_COUNT);
+
+            uint8_t prev = NIL;
+            for (uint8_t i = heads_[queue]; i != NIL; prev = i, i = next_[i]) {
+                if (!predicate(values_[i].get())) {
+                    continue;
+                }
+
+                if (prev == NIL) {
+                    heads_[queue] = next_[i];
+                } else {
+                    next_[prev] = next_[i];
+                }
+                if (tails_[queue] == i) {
+                    tails_[queue] = prev;
+                }
+                return take(i);
+            }
+            return etl::nullopt;
+        }
+    };
+} // namespace tl
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <etl/array.h>
+#include <etl/span.h>
+#include <stdint.h>
+
+namespace util {
+    /**
+     * CRC-16/CCITT-FALSE（多項式`0x1021`，初期値`0xFFFF`）．
+     *
+     * RAMを節約するため，256要素ではなく4bitずつ引く16要素の表を使う．
+     */
+    class Crc16 {
+        static constexpr uint16_t INITIAL_VALUE = 0xFFFF;
+        static constexpr etl::array<uint16_t, 16> TABLE{
+            0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+            0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        };
+
+        uint16_t value_{INITIAL_VALUE};
+
+        inline constexpr void update_nibble(uint8_t nibble) {
+            value_ = static_cast<uint16_t>((value_ << 4) ^ TABLE[(value_ >> 12) ^ nibble]);
+        }
+
+      public:
+        inline constexpr uint16_t value() const {
+            return value_;
+        }
+
+        inline constexpr void update(uint8_t byte) {
+            update_nibble(byte >> 4);
+            update_nibble(byte & 0x0F);
+        }
+
+        inline constexpr void update(etl::span<const uint8_t> bytes) {
+            for (uint8_t byte : bytes) {
+                update(byte);
+            }
+        }
+    };
+} // namespace util
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <etl/span.h>
+#include <stdint.h>
+
+namespace util {
+    // ハッシュ表の索引用の軽量なハッシュ関数．暗号学的な強度はない
+    inline constexpr uint8_t hash_bytes(uint8_t seed, etl::span<const uint8_t> bytes) {
+        uint8_t hash = seed;
+        for (uint8_t byte : bytes) {
+            hash = static_cast<uint8_t>(hash * 31 + byte);
+        }
+        return hash;
+    }
+} // namespace util
@@ -14,13 +14,40 @@ memory::Static<RWSerial> serial{Serial};
 memory::Static<RWSerial> serial2{Serial2};
 memory::Static<RWSerial> serial3{Serial3};
 
-memory::Static<media::SerialPortMediaPort<RWSerial>> serial_port0{serial, app.frame_queue(), time};
-memory::Static<media::SerialPortMediaPort<RWSerial>> serial_port1{serial2, app.frame_queue(), time};
-memory::Static<media::SerialPortMediaPort<RWSerial>> serial_port2{serial3, app.frame_queue(), time};
+constexpr auto SERIAL_FRAME_FORMAT = media::serial::DEFAULT_FRAME_FORMAT;
+
+// シリアルポートは既定の速度で起動し，相手から提案された場合はこの速度まで上げる．
+// 自ら交渉を始めるポートでは，`.auto_negotiate = true`とする
+constexpr media::serial::BaudRateConfig SERIAL_PORT0_BAUD_RATE{
+    .max = media::serial::BaudRate::B115200,
+};
+constexpr media::serial::BaudRateConfig SERIAL_PORT1_BAUD_RATE{
+    .max = media::serial::BaudRate::B115200,
+};
+constexpr media::serial::BaudRateConfig SERIAL_PORT2_BAUD_RATE{
+    .max = media::serial::BaudRate::B115200,
+};
+
+// UHFモデムがつながった場合に，小さなフレームを集約して送るか．
+// 集約フレームを解釈できないファームウェアのノードが近くにない場合のみ有効にする
+constexpr bool ENABLE_UHF_AGGREGATION = false;
+
+memory::Static<media::SerialPortMediaPort<RWSerial>> serial_port0{
+    serial, app.frame_queue(), time, SERIAL_FRAME_FORMAT, SERIAL_PORT0_BAUD_RATE,
+    ENABLE_UHF_AGGREGATION
+};
+memory::Static<media::SerialPortMediaPort<RWSerial>> serial_port1{
+    serial2, app.frame_queue(), time, SERIAL_FRAME_FORMAT, SERIAL_PORT1_BAUD_RATE,
+    ENABLE_UHF_AGGREGATION
+};
+memory::Static<media::SerialPortMediaPort<RWSerial>> serial_port2{
+    serial3, app.frame_queue(), time, SERIAL_FRAME_FORMAT, SERIAL_PORT2_BAUD_RATE,
+    ENABLE_UHF_AGGREGATION
+};
 memory::Static<media::EthernetShieldMediaPort> ethernet_port{app.frame_queue(), time};
 
 void setup() {
-    constexpr int BAUD_RATE = 19200;
+    constexpr uint32_t BAUD_RATE = media::serial::to_bps(media::serial::DEFAULT_BAUD_RATE);
 
     Serial.begin(BAUD_RATE);
     Serial1.begin(BAUD_RATE);
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <doctest.h>
+
+#include <etl/span.h>
+#include <memory/lifetime.h>
+#include <nb/serde.h>
+#include <net/frame.h>
+#include <net/link.h>
+
+// メディアのテストで共有する，シリアル通信路とリンク層のモック
+
+/**
+ * 読み書きできるバイト数と1byteずつの読み書きから，シリアルポートとしての読み書きを提供する．
+ * `Derived`は読み書きできるバイト数を返す`readable_count`と`writable_count`，
+ * および`read_unchecked`と`write_unchecked`を持つ．
+ */
+template <typename Derived>
+struct MockSerialEndpoint {
+    nb::Poll<nb::de::DeserializeResult> poll_readable(uint8_t count) {
+        if (self().readable_count() < count) {
+            return nb::pending;
+        }
+        return nb::de::DeserializeResult::Ok;
+    }
+
+    nb::Poll<nb::de::DeserializeResult> read(uint8_t &dest) {
+        SERDE_DESERIALIZE_OR_RETURN(poll_readable(1));
+        dest = self().read_unchecked();
+        return nb::de::DeserializeResult::Ok;
+    }
+
+    nb::Poll<nb::ser::SerializeResult> poll_writable(uint8_t count) {
+        if (self().writable_count() < count) {
+            return nb::pending;
+        }
+        return nb::ser::SerializeResult::Ok;
+    }
+
+    nb::Poll<nb::ser::SerializeResult> write(uint8_t byte) {
+        SERDE_SERIALIZE_OR_RETURN(poll_writable(1));
+        self().write_unchecked(byte);
+        return nb::ser::SerializeResult::Ok;
+    }
+
+  private:
+    inline Derived &self() {
+        return static_cast<Derived &>(*this);
+    }
+};
+
+/**
+ * 1つのメディアポートを持つノードのリンク層．
+ * `memory::Static`は破棄するとpanicするため，意図的にリークさせる．
+ */
+template <uint8_t BUFFER_COUNT>
+struct MockLink {
+    net::frame::FrameService &fs = *new net::frame::FrameService{
+        *new memory::Static<net::frame::MultiSizeFrameBufferPool<BUFFER_COUNT, 0, 0>>{}
+    };
+    memory::Static<net::link::MeasuredLinkFrameQueue> &queue;
+    memory::Static<net::link::FrameBroker> &broker;
+    net::link::MediaPortNumber port;
+
+    MockLink(util::Time &time, net::link::MediaPortNumber port)
+        : queue{*new memory::Static<net::link::MeasuredLinkFrameQueue>{time}},
+          broker{*new memory::Static<net::link::FrameBroker>{queue}},
+          port{port} {
+        broker->initialize_media_port(port);
+    }
+
+    // `payload`を`remote`へ送るよう要求する．バッファかキューに空きがなければfalseを返す
+    bool request_send(
+        const net::link::Address &remote,
+        etl::span<const uint8_t> payload,
+        util::Time &time
+    ) {
+        auto poll_writer = fs.request_frame_writer(payload.size());
+        if (poll_writer.is_pending()) {
+            return false;
+        }
+        auto &writer = poll_writer.unwrap();
+        for (uint8_t byte : payload) {
+            writer.write_unchecked(byte);
+        }
+        return queue
+            ->poll_request_send_frame(
+                net::link::MediaPortMask::from_port_number(port), net::frame::ProtocolNumber::Rpc,
+                remote, writer.create_reader(), net::link::FramePriority::Rpc, time
+            )
+            .is_ready();
+    }
+};
@@ -0,0 +1,163 @@
+#include <doctest.h>
+
+#include "../mock.h"
+#include <etl/deque.h>
+#include <media/serial.h>
+
+using namespace media;
+
+static const net::link::MediaPortNumber PORT{0};
+static constexpr uint8_t FRAME_COUNT = 30;
+static constexpr uint8_t PAYLOAD_LENGTH = 8;
+
+// 一方向のシリアル通信路．`loss_interval`バイトごとに1ビットを反転させる
+struct LossyChannel {
+    etl::deque<uint8_t, 512> bytes{};
+    uint16_t loss_interval;
+    uint16_t written_count{0};
+
+    void push(uint8_t byte) {
+        written_count++;
+        if (loss_interval != 0 && written_count % loss_interval == 0) {
+            byte ^= 0b00010000;
+        }
+        bytes.push_back(byte);
+    }
+};
+
+struct Endpoint : MockSerialEndpoint<Endpoint> {
+    LossyChannel &rx;
+    LossyChannel &tx;
+
+    Endpoint(LossyChannel &rx, LossyChannel &tx) : rx{rx}, tx{tx} {}
+
+    inline size_t readable_count() const {
+        return rx.bytes.size();
+    }
+
+    inline size_t writable_count() const {
+        return tx.bytes.available();
+    }
+
+    uint8_t read_unchecked() {
+        uint8_t byte = rx.bytes.front();
+        rx.bytes.pop_front();
+        return byte;
+    }
+
+    void write_unchecked(uint8_t byte) {
+        tx.push(byte);
+    }
+};
+
+struct Node : MockLink<16> {
+    Endpoint endpoint;
+    serial::SerialInteractor<Endpoint> interactor;
+
+    Node(
+        LossyChannel &rx,
+        LossyChannel &tx,
+        uint8_t address,
+        serial::FrameFormat format,
+        util::Time &time
+    )
+        : MockLink{time, PORT},
+          endpoint{rx, tx},
+          interactor{endpoint, broker, format} {
+        interactor.try_initialize_local_address(net::link::Address{SerialAddress{address}});
+    }
+
+    bool request_send(uint8_t value, util::Time &time) {
+        etl::array<uint8_t, PAYLOAD_LENGTH> payload;
+        payload.fill(value);
+        return MockLink::request_send(net::link::Address{SerialAddress{2}}, payload, time);
+    }
+};
+
+struct Result {
+    etl::array<uint8_t, FRAME_COUNT> received_count{};
+    uint16_t retransmission_count;
+    uint16_t give_up_count;
+};
+
+// 1から2へ`FRAME_COUNT`個のフレームを送り，2が受け取ったフレームを数える
+static Result transfer(uint16_t loss_interval) {
+    util::MockTime time{0};
+    LossyChannel a_to_b{.loss_interval = loss_interval};
+    LossyChannel b_to_a{.loss_interval = loss_interval};
+    Node a{b_to_a, a_to_b, 1, serial::FrameFormat::Arq, time};
+    Node b{a_to_b, b_to_a, 2, serial::DEFAULT_FRAME_FORMAT, time};
+
+    Result result{};
+    uint8_t sent_count = 0;
+    for (uint16_t t = 0; t < 10000; t++) {
+        if (sent_count < FRAME_COUNT && a.request_send(sent_count, time)) {
+            sent_count++;
+        }
+
+        a.interactor.execute(a.fs, time);
+        b.interactor.execute(b.fs, time);
+
+        while (true) {
+            auto poll = b.queue->poll_receive_frame(net::frame::ProtocolNumber::Rpc, time);
+            if (poll.is_pending()) {
+                break;
+            }
+
+            auto &reader = poll.unwrap().reader;
+            REQUIRE(reader.buffer_length() == PAYLOAD_LENGTH);
+            uint8_t value = reader.read_unchecked();
+            REQUIRE(value < FRAME_COUNT);
+            result.received_count[value]++;
+        }
+
+        time.advance(util::Duration::from_millis(1));
+    }
+
+    const auto &window = a.interactor.arq_send_window();
+    CHECK(window.in_flight_count() == 0);
+    result.retransmission_count = window.retransmission_count();
+    result.give_up_count = window.give_up_count();
+    return result;
+}
+
+TEST_CASE("deliver every frame once without loss") {
+    auto result = transfer(0);
+    for (uint8_t i = 0; i < FRAME_COUNT; i++) {
+        CHECK(result.received_count[i] == 1);
+    }
+    CHECK(result.retransmission_count == 0);
+}
+
+TEST_CASE("repair loss on a lossy serial pair") {
+    auto result = transfer(97);
+    for (uint8_t i = 0; i < FRAME_COUNT; i++) {
+        CHECK(result.received_count[i] == 1);
+    }
+    CHECK(result.retransmission_count > 0);
+    CHECK(result.give_up_count == 0);
+}
+
+TEST_CASE("lose frames without ARQ") {
+    util::MockTime time{0};
+    LossyChannel a_to_b{.loss_interval = 97};
+    LossyChannel b_to_a{.loss_interval = 97};
+    Node a{b_to_a, a_to_b, 1, serial::FrameFormat::Crc, time};
+    Node b{a_to_b, b_to_a, 2, serial::DEFAULT_FRAME_FORMAT, time};
+
+    uint8_t sent_count = 0;
+    uint8_t received_count = 0;
+    for (uint16_t t = 0; t < 1000; t++) {
+        if (sent_count < FRAME_COUNT && a.request_send(sent_count, time)) {
+            sent_count++;
+        }
+        a.interactor.execute(a.fs, time);
+        b.interactor.execute(b.fs, time);
+        while (b.queue->poll_receive_frame(net::frame::ProtocolNumber::Rpc, time).is_ready()) {
+            received_count++;
+        }
+        time.advance(util::Duration::from_millis(1));
+    }
+    CHECK(sent_count == FRAME_COUNT);
+    CHECK(received_count < FRAME_COUNT);
+}
@@ -0,0 +1,223 @@
+#include <doctest.h>
+
+#include "../mock.h"
+#include <etl/deque.h>
+#include <media/serial.h>
+
+using namespace media;
+
+static const net::link::MediaPortNumber PORT{0};
+static constexpr uint8_t PAYLOAD[] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+// 一方向のシリアル通信路．送信側と受信側の速度が異なるバイトは化ける
+struct Channel {
+    struct Byte {
+        uint8_t value;
+        uint32_t bps;
+    };
+
+    etl::deque<Byte, 512> bytes{};
+    uint32_t max_bps; // これより速い速度で送ったバイトは化ける
+};
+
+struct Endpoint : MockSerialEndpoint<Endpoint> {
+    Channel &rx;
+    Channel &tx;
+    uint32_t bps{serial::to_bps(serial::DEFAULT_BAUD_RATE)};
+
+    Endpoint(Channel &rx, Channel &tx) : rx{rx}, tx{tx} {}
+
+    void set_baud_rate(uint32_t baud_rate) {
+        bps = baud_rate;
+        rx.bytes.clear();
+    }
+
+    inline size_t readable_count() const {
+        return rx.bytes.size();
+    }
+
+    inline size_t writable_count() const {
+        return tx.bytes.available();
+    }
+
+    uint8_t read_unchecked() {
+        auto byte = rx.bytes.front();
+        rx.bytes.pop_front();
+        return byte.bps == bps && byte.bps <= rx.max_bps ? byte.value : ~byte.value;
+    }
+
+    void write_unchecked(uint8_t byte) {
+        tx.bytes.push_back(Channel::Byte{.value = byte, .bps = bps});
+    }
+};
+
+struct Node : MockLink<16> {
+    Endpoint endpoint;
+    serial::SerialInteractor<Endpoint> interactor;
+    uint8_t remote;
+    uint8_t received_count{0};
+
+    Node(
+        Channel &rx,
+        Channel &tx,
+        uint8_t address,
+        uint8_t remote_address,
+        const serial::BaudRateConfig &baud_rate,
+        util::Time &time
+    )
+        : MockLink{time, PORT},
+          endpoint{rx, tx},
+          interactor{endpoint, broker, serial::DEFAULT_FRAME_FORMAT, baud_rate},
+          remote{remote_address} {
+        interactor.try_initialize_local_address(net::link::Address{SerialAddress{address}});
+    }
+
+    void request_send(util::Time &time) {
+        MockLink::request_send(net::link::Address{SerialAddress{remote}}, PAYLOAD, time);
+    }
+
+    void execute(util::Time &time) {
+        interactor.execute(fs, time);
+        while (queue->poll_receive_frame(net::frame::ProtocolNumber::Rpc, time).is_ready()) {
+            received_count++;
+        }
+    }
+};
+
+struct Link {
+    util::MockTime time{0};
+    Channel a_to_b;
+    Channel b_to_a;
+    Node a;
+    Node b;
+
+    Link(
+        serial::BaudRate a_max,
+        serial::BaudRate b_max,
+        uint32_t max_bps = 115200,
+        bool auto_negotiate = true
+    )
+        : a_to_b{.max_bps = max_bps},
+          b_to_a{.max_bps = max_bps},
+          a{b_to_a, a_to_b, 1, 2, {.max = a_max, .auto_negotiate = auto_negotiate}, time},
+          b{a_to_b, b_to_a, 2, 1, {.max = b_max, .auto_negotiate = auto_negotiate}, time} {}
+
+    // 双方から`interval_ms`ごとにフレームを送りながら，`duration_ms`だけ進める
+    void run(uint16_t duration_ms, uint16_t interval_ms = 50) {
+        for (uint16_t t = 0; t < duration_ms; t++) {
+            if (t % interval_ms == 0) {
+                a.request_send(time);
+                b.request_send(time);
+            }
+            a.execute(time);
+            b.execute(time);
+            time.advance(util::Duration::from_millis(1));
+        }
+    }
+
+    // どちらもフレームを送らずに，`duration_ms`だけ進める
+    void idle(uint16_t duration_ms) {
+        for (uint16_t t = 0; t < duration_ms; t++) {
+            a.execute(time);
+            b.execute(time);
+            time.advance(util::Duration::from_millis(1));
+        }
+    }
+
+    // 双方がフレームを届けられるか
+    bool delivers() {
+        a.received_count = 0;
+        b.received_count = 0;
+        run(500);
+        return a.received_count > 0 && b.received_count > 0;
+    }
+};
+
+TEST_CASE("negotiate the highest baud rate both ends support") {
+    Link link{serial::BaudRate::B115200, serial::BaudRate::B57600};
+    link.run(2000);
+    CHECK(link.a.interactor.baud_rate() == serial::BaudRate::B57600);
+    CHECK(link.b.interactor.baud_rate() == serial::BaudRate::B57600);
+    CHECK(link.a.endpoint.bps == 57600);
+    CHECK(link.b.endpoint.bps == 57600);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("stay at the default baud rate with a peer that cannot switch") {
+    Link link{serial::BaudRate::B115200, serial::DEFAULT_BAUD_RATE};
+    link.run(2000);
+    CHECK(link.a.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.b.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("negotiate on request") {
+    Link link{serial::BaudRate::B115200, serial::DEFAULT_BAUD_RATE};
+    link.run(2000);
+
+    CHECK_FALSE(link.b.interactor.try_negotiate_baud_rate(12345, link.time));
+    CHECK(link.b.interactor.try_negotiate_baud_rate(38400, link.time));
+    link.run(2000);
+    CHECK(link.a.interactor.baud_rate() == serial::BaudRate::B38400);
+    CHECK(link.b.interactor.baud_rate() == serial::BaudRate::B38400);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("fall back when the new baud rate does not work") {
+    Link link{serial::BaudRate::B115200, serial::BaudRate::B115200, 38400};
+    link.run(3000);
+    CHECK(link.a.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.b.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.a.endpoint.bps == 19200);
+    CHECK(link.b.endpoint.bps == 19200);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("fall back when the peer restarts at the default baud rate") {
+    Link link{serial::BaudRate::B57600, serial::BaudRate::B57600};
+    link.run(2000);
+    REQUIRE(link.a.interactor.baud_rate() == serial::BaudRate::B57600);
+
+    link.b.endpoint.set_baud_rate(19200);
+    link.run(3000, 10);
+    CHECK(link.a.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.b.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("fall back when nothing arrives from the peer") {
+    Link link{serial::BaudRate::B57600, serial::BaudRate::B57600};
+    link.run(2000);
+    REQUIRE(link.a.interactor.baud_rate() == serial::BaudRate::B57600);
+
+    // 相手は既定の速度で再起動し，何も送らない
+    link.b.endpoint.set_baud_rate(19200);
+    link.idle(5000);
+    CHECK(link.a.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.a.endpoint.bps == 19200);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("keep the negotiated baud rate while the link is quiet") {
+    Link link{serial::BaudRate::B57600, serial::BaudRate::B57600};
+    link.run(2000);
+    REQUIRE(link.a.interactor.baud_rate() == serial::BaudRate::B57600);
+
+    link.idle(10000);
+    CHECK(link.a.interactor.baud_rate() == serial::BaudRate::B57600);
+    CHECK(link.b.interactor.baud_rate() == serial::BaudRate::B57600);
+    CHECK(link.delivers());
+}
+
+TEST_CASE("negotiate only on request unless auto negotiation is enabled") {
+    Link link{serial::BaudRate::B115200, serial::BaudRate::B115200, 115200, false};
+    link.run(2000);
+    CHECK(link.a.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+    CHECK(link.b.interactor.baud_rate() == serial::DEFAULT_BAUD_RATE);
+
+    CHECK(link.a.interactor.try_negotiate_baud_rate(115200, link.time));
+    link.run(2000);
+    CHECK(link.a.interactor.baud_rate() == serial::BaudRate::B115200);
+    CHECK(link.b.interactor.baud_rate() == serial::BaudRate::B115200);
+    CHECK(link.delivers());
+}
@@ -0,0 +1,154 @@
+#include <doctest.h>
+
+#include "../mock.h"
+#include <media/serial.h>
+
+using namespace media;
+
+// 読み書きを同じバッファで行うシリアルポート
+struct LoopbackSerial : MockSerialEndpoint<LoopbackSerial> {
+    etl::vector<uint8_t, 256> data{};
+    uint8_t read_index{0};
+
+    inline size_t readable_count() const {
+        return data.size() - read_index;
+    }
+
+    inline size_t writable_count() const {
+        return data.available();
+    }
+
+    uint8_t read_unchecked() {
+        return data[read_index++];
+    }
+
+    void write_unchecked(uint8_t byte) {
+        data.push_back(byte);
+    }
+
+    void flip_bit(uint8_t index, uint8_t bit) {
+        data[index] ^= 1 << bit;
+    }
+};
+
+static const SerialAddress SELF{1};
+static const SerialAddress REMOTE{2};
+static const uint8_t PAYLOAD[] = {0x01, 0x02, 0x03, 0x04};
+static constexpr uint8_t PAYLOAD_OFFSET =
+    serial::PREAMBLE_LENGTH + serial::LAST_PREAMBLE_LENGTH + serial::HEADER_LENGTH;
+
+struct Fixture {
+    util::MockTime time{0};
+    MockLink<8> link{time, net::link::MediaPortNumber{0}};
+    serial::FrameReceiver receiver{link.broker};
+    serial::Arq arq{};
+    LoopbackSerial serial{};
+
+    void write_frame(bool with_crc) {
+        auto poll_writer = link.fs.request_frame_writer(sizeof(PAYLOAD));
+        auto &writer = poll_writer.unwrap();
+        for (uint8_t byte : PAYLOAD) {
+            writer.write_unchecked(byte);
+        }
+        serial::SerialFrameHeader header{
+            .protocol_number = net::frame::ProtocolNumber::Rpc,
+            .source = REMOTE,
+            .destination = SELF,
+            .length = sizeof(PAYLOAD),
+        };
+        auto format = with_crc ? serial::FrameFormat::Crc : serial::FrameFormat::Plain;
+        serial::AsyncFrameSerializer serializer{header, writer.create_reader(), format};
+        REQUIRE(serializer.serialize(serial).is_ready());
+    }
+
+    void receive() {
+        for (uint8_t i = 0; i < 10 && serial.read_index < serial.data.size(); i++) {
+            receiver.execute(link.fs, serial, arq, time);
+        }
+    }
+
+    uint8_t received_frame_count() {
+        uint8_t count = 0;
+        while (true) {
+            auto poll = link.queue->poll_receive_frame(net::frame::ProtocolNumber::Rpc, time);
+            if (poll.is_pending()) {
+                return count;
+            }
+
+            auto &reader = poll.unwrap().reader;
+            CHECK(reader.buffer_length() == sizeof(PAYLOAD));
+            for (uint8_t byte : PAYLOAD) {
+                CHECK(reader.read_unchecked() == byte);
+            }
+            count++;
+        }
+    }
+};
+
+TEST_CASE("receive frame without CRC") {
+    Fixture f;
+    f.write_frame(false);
+    f.receive();
+    CHECK(f.received_frame_count() == 1);
+    CHECK_FALSE(f.receiver.remote_uses_crc());
+}
+
+TEST_CASE("receive frame with CRC") {
+    Fixture f;
+    f.write_frame(true);
+    f.receive();
+    CHECK(f.received_frame_count() == 1);
+    CHECK(f.receiver.remote_uses_crc());
+    CHECK(f.receiver.error_counter().crc_error_count() == 0);
+}
+
+TEST_CASE("discard frame with corrupted payload") {
+    Fixture f;
+    f.write_frame(true);
+    f.serial.flip_bit(PAYLOAD_OFFSET + 1, 3);
+    f.write_frame(true);
+    f.receive();
+    CHECK(f.received_frame_count() == 1);
+    CHECK(f.receiver.error_counter().crc_error_count() == 1);
+}
+
+TEST_CASE("discard frame with corrupted header") {
+    Fixture f;
+    f.write_frame(true);
+    f.serial.flip_bit(PAYLOAD_OFFSET - 2, 0); // 宛先アドレス
+    f.write_frame(true);
+    f.receive();
+    CHECK(f.received_frame_count() == 1);
+    CHECK(f.receiver.error_counter().crc_error_count() == 1);
+}
+
+TEST_CASE("discard frame with corrupted CRC") {
+    Fixture f;
+    f.write_frame(true);
+    f.serial.flip_bit(PAYLOAD_OFFSET + sizeof(PAYLOAD), 7);
+    f.receive();
+    CHECK(f.received_frame_count() == 0);
+    CHECK(f.receiver.error_counter().crc_error_count() == 1);
+}
+
+TEST_CASE("resynchronise right after noise") {
+    Fixture f;
+    // 途中まで一致したプリアンブルの直後に，本物のプリアンブルが続く
+    f.serial.write_unchecked(serial::PREAMBLE);
+    f.serial.write_unchecked(serial::PREAMBLE);
+    f.serial.write_unchecked(0x00);
+    f.write_frame(true);
+    f.receive();
+    CHECK(f.received_frame_count() == 1);
+    CHECK(f.receiver.error_counter().discarded_byte_count() == 3);
+}
+
+TEST_CASE("resynchronise after corrupted preamble") {
+    Fixture f;
+    f.write_frame(true);
+    f.serial.flip_bit(3, 4);
+    f.write_frame(true);
+    f.receive();
+    CHECK(f.received_frame_count() == 1);
+    CHECK(f.receiver.error_counter().crc_error_count() == 0);
+}
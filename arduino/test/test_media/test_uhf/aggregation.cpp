@@ -0,0 +1,184 @@
+#include <doctest.h>
+
+#include "../mock.h"
+#include <etl/deque.h>
+#include <etl/vector.h>
+#include <media/uhf/task.h>
+
+using namespace media;
+
+static const net::link::MediaPortNumber PORT{0};
+static constexpr uint8_t PAYLOAD[] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+// 4.8kbpsでの1byteあたりの送信時間(us)
+static constexpr uint32_t AIR_TIME_US_PER_BYTE = 8 * 1000000 / 4800;
+// @DTコマンドのデータ以外に送信される制御用のバイト数
+static constexpr uint8_t AIR_OVERHEAD_BYTES = 10;
+
+static uint8_t to_hex(uint8_t value) {
+    return value < 10 ? '0' + value : 'A' + value - 10;
+}
+
+static uint8_t from_hex(uint8_t c) {
+    return c <= '9' ? c - '0' : c - 'A' + 10;
+}
+
+// @CSと@DTだけに応答するモデム．@DTで送ったデータは，送信時間の経過後に相手のモデムで受信される
+struct Modem : MockSerialEndpoint<Modem> {
+    util::Time &time;
+    uint8_t id;
+    Modem *peer{nullptr};
+    etl::deque<uint8_t, 1024> to_host{};
+    etl::vector<uint8_t, 512> command{};
+    util::Instant busy_until;
+    etl::optional<etl::vector<uint8_t, 300>> on_air{};
+
+    Modem(util::Time &time, uint8_t id) : time{time}, id{id}, busy_until{time.now()} {}
+
+    void respond(etl::string_view response) {
+        for (char c : response) {
+            to_host.push_back(c);
+        }
+    }
+
+    bool is_busy() const {
+        return time.now() < busy_until || peer->time.now() < peer->busy_until;
+    }
+
+    void on_command() {
+        if (command.size() == 5 && util::as_str(etl::span{command.data(), 5}) == "@CS\r\n") {
+            respond(is_busy() ? "*CS=NE\r\n" : "*CS=EN\r\n");
+            command.clear();
+            return;
+        }
+
+        if (command.size() < 5 || command[0] != '@' || command[1] != 'D' || command[2] != 'T') {
+            return;
+        }
+        uint8_t length = from_hex(command[3]) << 4 | from_hex(command[4]);
+        if (command.size() < 5u + length + 2 + 2 + 2) {
+            return;
+        }
+
+        respond("*DT=");
+        to_host.push_back(command[3]);
+        to_host.push_back(command[4]);
+        respond("\r\n");
+
+        etl::vector<uint8_t, 300> dr;
+        for (char c : etl::string_view{"*DR="}) {
+            dr.push_back(c);
+        }
+        for (uint8_t i = 3; i < 5u + length; i++) {
+            dr.push_back(command[i]);
+        }
+        for (char c : etl::string_view{"/R"}) {
+            dr.push_back(c);
+        }
+        dr.push_back(to_hex(id >> 4));
+        dr.push_back(to_hex(id & 0xF));
+        dr.push_back('\r');
+        dr.push_back('\n');
+        on_air = dr;
+
+        uint32_t air_time_us = (length + AIR_OVERHEAD_BYTES) * AIR_TIME_US_PER_BYTE;
+        busy_until = time.now() + util::Duration::from_millis(air_time_us / 1000);
+        command.clear();
+    }
+
+    void execute() {
+        if (on_air.has_value() && !is_busy()) {
+            for (uint8_t byte : *on_air) {
+                peer->to_host.push_back(byte);
+            }
+            on_air.reset();
+        }
+    }
+
+    inline size_t readable_count() const {
+        return to_host.size();
+    }
+
+    // 書き込んだコマンドはすぐに処理する
+    inline size_t writable_count() const {
+        return etl::integral_limits<uint8_t>::max;
+    }
+
+    uint8_t read_unchecked() {
+        uint8_t byte = to_host.front();
+        to_host.pop_front();
+        return byte;
+    }
+
+    void write_unchecked(uint8_t byte) {
+        command.push_back(byte);
+        on_command();
+    }
+};
+
+struct Node : MockLink<32> {
+    Modem modem;
+    nb::Lock<etl::reference_wrapper<Modem>> rw{etl::ref(modem)};
+    uhf::UhfResponseHeaderReceiver<Modem> header_receiver{};
+    uhf::TaskExecutor<Modem> executor;
+    uint16_t received_count{0};
+
+    Node(util::Time &time, uint8_t id, bool enable_aggregation)
+        : MockLink{time, PORT},
+          modem{time, id},
+          executor{broker, enable_aggregation} {}
+
+    void request_send(uint8_t remote, util::Time &time) {
+        MockLink::request_send(net::link::Address{ModemId{remote}}, PAYLOAD, time);
+    }
+
+    void execute(util::Time &time, util::Rand &rand) {
+        modem.execute();
+        executor.execute(fs, rw, time, rand);
+        auto &&opt_res = header_receiver.execute(rw);
+        if (opt_res.has_value()) {
+            executor.handle_response(time, etl::move(*opt_res));
+        }
+        while (true) {
+            auto poll_frame = queue->poll_receive_frame(net::frame::ProtocolNumber::Rpc, time);
+            if (poll_frame.is_pending()) {
+                break;
+            }
+
+            auto &reader = poll_frame.unwrap().reader;
+            CHECK(reader.buffer_length() == sizeof(PAYLOAD));
+            for (uint8_t byte : PAYLOAD) {
+                CHECK(reader.read_unchecked() == byte);
+            }
+            received_count++;
+        }
+    }
+};
+
+// 送信側のキューを常に埋めながら`duration_ms`だけ進め，受信側に届いたフレーム数を返す
+static uint16_t count_delivered_frames(bool enable_aggregation, uint16_t duration_ms) {
+    util::MockTime time{0};
+    util::MockRandom rand{50};
+    Node a{time, 1, enable_aggregation};
+    Node b{time, 2, enable_aggregation};
+    a.modem.peer = &b.modem;
+    b.modem.peer = &a.modem;
+
+    for (uint16_t t = 0; t < duration_ms; t++) {
+        a.request_send(2, time);
+        a.execute(time, rand);
+        b.execute(time, rand);
+        time.advance(util::Duration::from_millis(1));
+    }
+    return b.received_count;
+}
+
+TEST_CASE("deliver frames without aggregation") {
+    CHECK(count_delivered_frames(false, 5000) > 0);
+}
+
+TEST_CASE("aggregation increases the number of delivered small frames") {
+    uint16_t single = count_delivered_frames(false, 5000);
+    uint16_t aggregated = count_delivered_frames(true, 5000);
+    CHECK(aggregated > single * 2);
+}
@@ -0,0 +1,251 @@
+#include <doctest.h>
+
+#include "../mock.h"
+#include <etl/deque.h>
+#include <etl/vector.h>
+#include <media/uhf/task.h>
+
+using namespace media;
+
+// 常に範囲の上限を返す
+class MaxRand final : public util::Rand {
+  public:
+    uint8_t gen_uint8_t(uint8_t max) override {
+        return max;
+    }
+
+    uint8_t gen_uint8_t(uint8_t, uint8_t max) override {
+        return max;
+    }
+
+    uint16_t gen_uint16_t(uint16_t max) override {
+        return max;
+    }
+
+    uint16_t gen_uint16_t(uint16_t, uint16_t max) override {
+        return max;
+    }
+
+    uint32_t gen_uint32_t(uint32_t max) override {
+        return max;
+    }
+
+    uint32_t gen_uint32_t(uint32_t, uint32_t max) override {
+        return max;
+    }
+};
+
+// @CSに対して，あらかじめ決めた順に`*CS=DI`または`*CS=EN`を返すモデム．@DTには応答しない
+struct ScriptedModem : MockSerialEndpoint<ScriptedModem> {
+    util::MockTime &time;
+    etl::deque<bool, 32> busy_script{};
+    etl::vector<util::TimeInt, 32> carrier_sense_times{};
+    etl::deque<uint8_t, 64> to_host{};
+    etl::vector<uint8_t, 8> command{};
+    bool data_requested{false};
+
+    explicit ScriptedModem(util::MockTime &time) : time{time} {}
+
+    void on_command() {
+        auto str = util::as_str(etl::span{command.data(), command.size()});
+        if (str == "@DT") {
+            data_requested = true;
+        }
+        if (data_requested) {
+            command.clear();
+            return;
+        }
+        if (str != "@CS\r\n") {
+            return;
+        }
+        command.clear();
+
+        FASSERT(!busy_script.empty());
+        bool busy = busy_script.front();
+        busy_script.pop_front();
+        carrier_sense_times.push_back(time.get_now_ms());
+        for (char c : etl::string_view{busy ? "*CS=DI\r\n" : "*CS=EN\r\n"}) {
+            to_host.push_back(c);
+        }
+    }
+
+    inline size_t readable_count() const {
+        return to_host.size();
+    }
+
+    inline size_t writable_count() const {
+        return etl::integral_limits<uint8_t>::max;
+    }
+
+    uint8_t read_unchecked() {
+        uint8_t byte = to_host.front();
+        to_host.pop_front();
+        return byte;
+    }
+
+    void write_unchecked(uint8_t byte) {
+        command.push_back(byte);
+        on_command();
+    }
+};
+
+// 処理の遅れとして，数msの誤差を許す
+static bool is_about(util::TimeInt actual, util::TimeInt expected) {
+    return actual >= expected && actual <= expected + 3;
+}
+
+struct Fixture {
+    util::MockTime time{0};
+    MaxRand rand{};
+    ScriptedModem modem{time};
+    nb::Lock<etl::reference_wrapper<ScriptedModem>> rw{etl::ref(modem)};
+    uhf::UhfResponseHeaderReceiver<ScriptedModem> header_receiver{};
+    uhf::CarrierSenseBackoff backoff{};
+
+    // `busy_script`の通りに応答するモデムに対して，キャリアセンスを1回行う
+    uhf::CarrierSenseResult carrier_sense(std::initializer_list<bool> busy_script) {
+        for (bool busy : busy_script) {
+            modem.busy_script.push_back(busy);
+        }
+        modem.carrier_sense_times.clear();
+
+        uhf::CarrierSenseTask<ScriptedModem> task{time, rand, backoff};
+        while (true) {
+            auto poll = task.execute(rw, time, rand, backoff);
+            if (poll.is_ready()) {
+                return poll.unwrap();
+            }
+
+            auto &&opt_res = header_receiver.execute(rw);
+            if (opt_res.has_value()) {
+                task.handle_response(etl::move(*opt_res));
+            }
+            time.advance(util::Duration::from_millis(1));
+        }
+    }
+
+    // 連続するキャリアセンスの間隔
+    etl::vector<util::TimeInt, 32> intervals() const {
+        etl::vector<util::TimeInt, 32> intervals;
+        const auto &times = modem.carrier_sense_times;
+        for (uint8_t i = 1; i < times.size(); i++) {
+            intervals.push_back(times[i] - times[i - 1]);
+        }
+        return intervals;
+    }
+};
+
+TEST_CASE("widen the contention window while the channel is busy") {
+    Fixture f;
+    auto start = f.time.get_now_ms();
+    CHECK(f.carrier_sense({true, true, true, false}) == uhf::CarrierSenseResult::Ok);
+
+    // 最初のバックオフは初期値の範囲から選ぶ
+    REQUIRE(f.modem.carrier_sense_times.size() == 4);
+    CHECK(is_about(f.modem.carrier_sense_times[0] - start, 100));
+
+    // 使用中と応答されるたびに範囲が倍になる
+    auto intervals = f.intervals();
+    CHECK(is_about(intervals[0], 200));
+    CHECK(is_about(intervals[1], 400));
+    CHECK(is_about(intervals[2], 800));
+
+    // 空いていれば半分に戻る
+    CHECK(f.backoff.contention_window_ms() == 400);
+    CHECK(f.backoff.statistics().carrier_sense_count == 4);
+    CHECK(f.backoff.statistics().busy_count == 3);
+}
+
+TEST_CASE("the contention window is bounded") {
+    Fixture f;
+    CHECK(
+        f.carrier_sense({true, true, true, true, true, true, true, false}) ==
+        uhf::CarrierSenseResult::Ok
+    );
+    for (auto interval : f.intervals()) {
+        CHECK(interval <= uhf::MAX_CONTENTION_WINDOW_MS + 3);
+    }
+    CHECK(f.backoff.contention_window_ms() == uhf::MAX_CONTENTION_WINDOW_MS / 2);
+
+    for (uint8_t i = 0; i < 10; i++) {
+        CHECK(f.carrier_sense({false}) == uhf::CarrierSenseResult::Ok);
+    }
+    CHECK(f.backoff.contention_window_ms() == uhf::MIN_CONTENTION_WINDOW_MS);
+
+    // 空いているチャネルでは，待ち時間が短くなる
+    auto start = f.time.get_now_ms();
+    CHECK(f.carrier_sense({false}) == uhf::CarrierSenseResult::Ok);
+    CHECK(f.modem.carrier_sense_times[0] - start <= uhf::MIN_CONTENTION_WINDOW_MS + 3);
+}
+
+TEST_CASE("give up after retrying on a busy channel") {
+    Fixture f;
+    CHECK(
+        f.carrier_sense({true, true, true, true, true, true, true, true, true, true, true, true,
+                         true, true, true, true}) == uhf::CarrierSenseResult::Error
+    );
+    CHECK(f.modem.carrier_sense_times.size() == 16);
+    CHECK(f.backoff.statistics().carrier_sense_count == 16);
+    CHECK(f.backoff.statistics().busy_count == 16);
+    CHECK(f.backoff.contention_window_ms() == uhf::MAX_CONTENTION_WINDOW_MS);
+}
+
+TEST_CASE("backoff on a busy channel does not count toward the task timeout") {
+    Fixture f;
+    MockLink<1> link{f.time, net::link::MediaPortNumber{0}};
+    uhf::TaskExecutor<ScriptedModem> executor{link.broker};
+    for (uint8_t i = 0; i < 8; i++) {
+        f.modem.busy_script.push_back(true);
+    }
+    f.modem.busy_script.push_back(false);
+
+    const uint8_t payload[] = {0x01};
+    REQUIRE(link.request_send(net::link::Address{ModemId{2}}, payload, f.time));
+    auto start = f.time.now();
+    for (uint16_t t = 0; t < 20000 && !f.modem.data_requested; t++) {
+        executor.execute(link.fs, f.rw, f.time, f.rand);
+        auto &&opt_res = f.header_receiver.execute(f.rw);
+        if (opt_res.has_value()) {
+            executor.handle_response(f.time, etl::move(*opt_res));
+        }
+        f.time.advance(util::Duration::from_millis(1));
+    }
+
+    // 再試行を重ねた末に空いたチャネルで，フレームを破棄せずに送信する
+    CHECK(f.modem.data_requested);
+    CHECK(f.modem.carrier_sense_times.size() == 9);
+    CHECK(f.time.now() - start > uhf::TASK_TIMEOUT);
+}
+
+TEST_CASE("drop the frame when the channel stays busy until the task deadline") {
+    Fixture f;
+    MockLink<1> link{f.time, net::link::MediaPortNumber{0}};
+    uhf::TaskExecutor<ScriptedModem> executor{link.broker};
+    while (!f.modem.busy_script.full()) {
+        f.modem.busy_script.push_back(true);
+    }
+
+    const uint8_t payload[] = {0x01};
+    REQUIRE(link.request_send(net::link::Address{ModemId{2}}, payload, f.time));
+    auto start = f.time.now();
+    for (uint16_t t = 0; t < 25000; t++) {
+        executor.execute(link.fs, f.rw, f.time, f.rand);
+        auto &&opt_res = f.header_receiver.execute(f.rw);
+        if (opt_res.has_value()) {
+            executor.handle_response(f.time, etl::move(*opt_res));
+        }
+        if (executor.poll_task_addable().is_ready()) {
+            break;
+        }
+        f.time.advance(util::Duration::from_millis(1));
+    }
+
+    // バックオフを重ねても，期限を過ぎた時点でフレームを破棄する
+    CHECK_FALSE(f.modem.data_requested);
+    CHECK(executor.poll_task_addable().is_ready());
+    CHECK(f.time.now() - start >= uhf::TASK_DEADLINE);
+    CHECK(f.time.now() - start <= uhf::TASK_DEADLINE + util::Duration::from_millis(3));
+
+    // 破棄したフレームのバッファは解放されている
+    CHECK(link.request_send(net::link::Address{ModemId{2}}, payload, f.time));
+}
@@ -0,0 +1,93 @@
+#include <doctest.h>
+
+#include <memory/rc_pool.h>
+
+template <uint8_t N>
+static memory::Static<memory::RcPool<uint8_t, N>> &make_pool() {
+    // Staticは破棄するとpanicするため，意図的にリークさせる
+    return *new memory::Static<memory::RcPool<uint8_t, N>>{};
+}
+
+TEST_CASE("allocate") {
+    auto &pool = make_pool<2>();
+    memory::RcPoolRef<uint8_t> ref{pool};
+    CHECK_EQ(ref.free_count(), 2);
+
+    auto result = ref.allocate();
+    CHECK(result.has_value());
+    CHECK_EQ(ref.free_count(), 1);
+}
+
+TEST_CASE("allocate full") {
+    auto &pool = make_pool<2>();
+    memory::RcPoolRef<uint8_t> ref{pool};
+
+    auto r1 = ref.allocate();
+    r1->first->increment();
+    auto r2 = ref.allocate();
+    r2->first->increment();
+
+    CHECK(r1->second != r2->second);
+    CHECK_EQ(ref.free_count(), 0);
+    CHECK_FALSE(ref.allocate().has_value());
+}
+
+TEST_CASE("decrement to zero returns entry") {
+    auto &pool = make_pool<2>();
+    memory::RcPoolRef<uint8_t> ref{pool};
+
+    auto r1 = ref.allocate();
+    r1->first->increment();
+    auto r2 = ref.allocate();
+    r2->first->increment();
+    CHECK_FALSE(ref.allocate().has_value());
+
+    r1->first->decrement();
+    CHECK_EQ(ref.free_count(), 1);
+
+    auto r3 = ref.allocate();
+    CHECK(r3.has_value());
+    CHECK_EQ(r3->first, r1->first);
+    CHECK_EQ(r3->second, r1->second);
+}
+
+TEST_CASE("entry is not returned while referenced") {
+    auto &pool = make_pool<1>();
+    memory::RcPoolRef<uint8_t> ref{pool};
+
+    auto r1 = ref.allocate();
+    r1->first->increment();
+    r1->first->increment();
+
+    r1->first->decrement();
+    CHECK_EQ(ref.free_count(), 0);
+    CHECK_FALSE(ref.allocate().has_value());
+
+    r1->first->decrement();
+    CHECK_EQ(ref.free_count(), 1);
+    CHECK(ref.allocate().has_value());
+}
+
+TEST_CASE("reuse at full occupancy") {
+    auto &pool = make_pool<16>();
+    memory::RcPoolRef<uint8_t> ref{pool};
+
+    memory::RcPoolCounter *counters[16];
+    for (uint8_t i = 0; i < 16; i++) {
+        auto result = ref.allocate();
+        REQUIRE(result.has_value());
+        counters[i] = result->first;
+        counters[i]->increment();
+    }
+
+    for (uint16_t i = 0; i < 1000; i++) {
+        uint8_t index = i % 16;
+        counters[index]->decrement();
+
+        auto result = ref.allocate();
+        REQUIRE(result.has_value());
+        CHECK_EQ(result->first, counters[index]);
+        result->first->increment();
+        CHECK_EQ(ref.free_count(), 0);
+    }
+}
@@ -0,0 +1,71 @@
+#include <doctest.h>
+
+#include <nb/task_pool.h>
+
+struct StubTask {
+    uint8_t id;
+    bool *done;
+    uint8_t *executed;
+
+    nb::Poll<void> execute() {
+        (*executed)++;
+        return *done ? nb::ready() : nb::pending;
+    }
+};
+
+TEST_CASE("pending task does not block following tasks") {
+    nb::TaskPool<StubTask, 3> pool;
+    bool blocked = false;
+    bool done = true;
+    uint8_t blocked_count = 0;
+    uint8_t done_count = 0;
+
+    pool.emplace(StubTask{0, &blocked, &blocked_count});
+    pool.emplace(StubTask{1, &done, &done_count});
+    pool.emplace(StubTask{2, &done, &done_count});
+    CHECK(pool.full());
+
+    pool.execute([](StubTask &task) { return task.execute(); });
+    CHECK_EQ(blocked_count, 1);
+    CHECK_EQ(done_count, 2);
+    CHECK_EQ(pool.size(), 1);
+
+    // 空いた場所に新しいタスクを追加でき，待機中のタスクの完了を待たずに実行される
+    pool.emplace(StubTask{3, &done, &done_count});
+    pool.execute([](StubTask &task) { return task.execute(); });
+    CHECK_EQ(blocked_count, 2);
+    CHECK_EQ(done_count, 3);
+    CHECK_EQ(pool.size(), 1);
+
+    blocked = true;
+    pool.execute([](StubTask &task) { return task.execute(); });
+    CHECK(pool.empty());
+}
+
+TEST_CASE("tasks are executed in insertion order") {
+    nb::TaskPool<StubTask, 3> pool;
+    bool done = false;
+    uint8_t count = 0;
+    pool.emplace(StubTask{0, &done, &count});
+    pool.emplace(StubTask{1, &done, &count});
+    pool.emplace(StubTask{2, &done, &count});
+
+    etl::array<uint8_t, 3> order{};
+    uint8_t index = 0;
+    pool.execute([&](StubTask &task) {
+        order[index++] = task.id;
+        return task.id == 1 ? nb::ready() : nb::Poll<void>{nb::pending};
+    });
+    CHECK_EQ(order[0], 0);
+    CHECK_EQ(order[1], 1);
+    CHECK_EQ(order[2], 2);
+
+    index = 0;
+    pool.execute([&](StubTask &task) {
+        order[index++] = task.id;
+        return nb::Poll<void>{nb::pending};
+    });
+    CHECK_EQ(index, 2);
+    CHECK_EQ(order[0], 0);
+    CHECK_EQ(order[1], 2);
+}
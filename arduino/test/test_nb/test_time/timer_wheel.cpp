@@ -0,0 +1,156 @@
+#include <doctest.h>
+
+#include <nb/timer_wheel.h>
+
+using Wheel = nb::TimerWheel<uint8_t, 8>;
+
+static constexpr util::Duration TICK = util::Duration::from_millis(10);
+
+TEST_CASE("fire after deadline") {
+    util::MockTime time{0};
+    Wheel wheel{time, TICK};
+    wheel.schedule(1, util::Duration::from_millis(25), time);
+
+    time.set_now_ms(24);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+
+    time.set_now_ms(30);
+    auto poll = wheel.poll_pop_expired(time);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap() == 1);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+}
+
+TEST_CASE("fire in deadline order") {
+    util::MockTime time{0};
+    Wheel wheel{time, TICK};
+    wheel.schedule(3, util::Duration::from_millis(300), time);
+    wheel.schedule(1, util::Duration::from_millis(100), time);
+    wheel.schedule(2, util::Duration::from_millis(200), time);
+
+    uint8_t fired[3];
+    uint8_t count = 0;
+    for (uint16_t ms = 0; ms <= 400; ms += 5) {
+        time.set_now_ms(ms);
+        while (true) {
+            auto poll = wheel.poll_pop_expired(time);
+            if (poll.is_pending()) {
+                break;
+            }
+            REQUIRE(count < 3);
+            fired[count++] = poll.unwrap();
+        }
+    }
+
+    REQUIRE(count == 3);
+    CHECK(fired[0] == 1);
+    CHECK(fired[1] == 2);
+    CHECK(fired[2] == 3);
+}
+
+TEST_CASE("deadline beyond wheel range") {
+    util::MockTime time{0};
+    Wheel wheel{time, TICK};
+    // 8^3 tick = 5120ms を超える期限
+    wheel.schedule(1, util::Duration::from_millis(20000), time);
+
+    time.set_now_ms(19990);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+
+    time.set_now_ms(20000);
+    CHECK(wheel.poll_pop_expired(time).is_ready());
+}
+
+TEST_CASE("reschedule") {
+    util::MockTime time{0};
+    Wheel wheel{time, TICK};
+    auto handle = wheel.schedule(1, util::Duration::from_millis(50), time);
+    REQUIRE(handle.has_value());
+
+    time.set_now_ms(40);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+    wheel.reschedule(*handle, util::Duration::from_millis(50), time);
+
+    time.set_now_ms(80);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+
+    time.set_now_ms(90);
+    CHECK(wheel.poll_pop_expired(time).is_ready());
+
+    // 発火後もハンドルは有効
+    wheel.reschedule(*handle, util::Duration::from_millis(10), time);
+    time.set_now_ms(100);
+    CHECK(wheel.poll_pop_expired(time).is_ready());
+}
+
+TEST_CASE("cancel") {
+    util::MockTime time{0};
+    Wheel wheel{time, TICK};
+    auto handle = wheel.schedule(1, util::Duration::from_millis(50), time);
+    REQUIRE(handle.has_value());
+    CHECK(wheel.size() == 1);
+
+    wheel.cancel(*handle);
+    CHECK(wheel.size() == 0);
+
+    time.set_now_ms(100);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+}
+
+TEST_CASE("full") {
+    util::MockTime time{0};
+    nb::TimerWheel<uint8_t, 2> wheel{time, TICK};
+    CHECK(wheel.schedule(1, util::Duration::from_millis(10), time).has_value());
+    auto handle = wheel.schedule(2, util::Duration::from_millis(10), time);
+    CHECK(wheel.full());
+    CHECK_FALSE(wheel.schedule(3, util::Duration::from_millis(10), time).has_value());
+
+    wheel.cancel(*handle);
+    CHECK(wheel.schedule(3, util::Duration::from_millis(10), time).has_value());
+}
+
+TEST_CASE("skip idle ticks") {
+    util::MockTime time{0};
+    Wheel wheel{time, TICK};
+    time.set_now_ms(100000);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+
+    wheel.schedule(1, util::Duration::from_millis(15), time);
+    time.set_now_ms(100010);
+    CHECK(wheel.poll_pop_expired(time).is_pending());
+    time.set_now_ms(100020);
+    CHECK(wheel.poll_pop_expired(time).is_ready());
+}
+
+TEST_CASE("fire within one tick of deadline") {
+    util::MockTime time{0};
+    nb::TimerWheel<uint8_t, 32> wheel{time, TICK};
+    uint32_t deadlines[32];
+    bool fired[32] = {};
+
+    uint32_t seed = 1;
+    for (uint8_t i = 0; i < 32; i++) {
+        seed = seed * 1103515245 + 12345;
+        deadlines[i] = (seed >> 8) % 10000;
+        wheel.schedule(i, util::Duration::from_millis(deadlines[i]), time);
+    }
+
+    for (uint32_t ms = 0; ms <= 10010; ms++) {
+        time.set_now_ms(ms);
+        while (true) {
+            auto poll = wheel.poll_pop_expired(time);
+            if (poll.is_pending()) {
+                break;
+            }
+            uint8_t i = poll.unwrap();
+            CHECK_FALSE(fired[i]);
+            CHECK(ms >= deadlines[i]);
+            CHECK(ms < deadlines[i] + 10);
+            fired[i] = true;
+        }
+    }
+
+    for (uint8_t i = 0; i < 32; i++) {
+        CHECK(fired[i]);
+    }
+}
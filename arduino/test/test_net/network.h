@@ -0,0 +1,326 @@
+#pragma once
+
+#include <doctest.h>
+
+#include <etl/array.h>
+#include <net/discovery.h>
+#include <net/link.h>
+#include <net/local.h>
+#include <net/neighbor.h>
+#include <net/notification.h>
+#include <net/routing.h>
+
+// 複数のノードをつなぎ，ルーティング層までを結合して動かすためのテスト用のネットワーク
+
+static const net::link::MediaPortNumber NETWORK_PORT{0};
+static constexpr uint8_t NETWORK_FRAME_DELAY_POOL_SIZE = 4;
+static constexpr net::neighbor::NeighborSocketConfig NETWORK_SOCKET_CONFIG{.do_delay = true};
+
+// 呼び出すたびに異なる値を返す．`util::MockRandom`ではフレームIDが重複し続けるため
+class SequentialRandom final : public util::Rand {
+    uint32_t next_{0};
+
+    uint32_t next(uint32_t min, uint32_t max) {
+        uint32_t range = max - min;
+        uint32_t value = next_++;
+        return range == etl::integral_limits<uint32_t>::max ? value : min + value % (range + 1);
+    }
+
+  public:
+    uint8_t gen_uint8_t(uint8_t max) override {
+        return next(0, max);
+    }
+
+    uint8_t gen_uint8_t(uint8_t min, uint8_t max) override {
+        return next(min, max);
+    }
+
+    uint16_t gen_uint16_t(uint16_t max) override {
+        return next(0, max);
+    }
+
+    uint16_t gen_uint16_t(uint16_t min, uint16_t max) override {
+        return next(min, max);
+    }
+
+    uint32_t gen_uint32_t(uint32_t max) override {
+        return next(0, max);
+    }
+
+    uint32_t gen_uint32_t(uint32_t min, uint32_t max) override {
+        return next(min, max);
+    }
+};
+
+struct NetworkMediaPort {
+    net::link::MediaPortOperationResult
+    serial_try_initialize_local_address(const net::link::Address &) {
+        return net::link::MediaPortOperationResult::UnsupportedOperation;
+    }
+
+    net::link::MediaPortOperationResult serial_try_negotiate_baud_rate(uint32_t, util::Time &) {
+        return net::link::MediaPortOperationResult::UnsupportedOperation;
+    }
+
+    etl::expected<nb::Poll<nb::Future<bool>>, net::link::MediaPortUnsupportedOperation>
+    wifi_join_ap(etl::span<const uint8_t>, etl::span<const uint8_t>, util::Time &) {
+        return etl::unexpected<net::link::MediaPortUnsupportedOperation>{
+            net::link::MediaPortUnsupportedOperation{}
+        };
+    }
+
+    etl::expected<nb::Poll<nb::Future<bool>>, net::link::MediaPortUnsupportedOperation>
+    wifi_start_server(uint16_t, util::Time &) {
+        return etl::unexpected<net::link::MediaPortUnsupportedOperation>{
+            net::link::MediaPortUnsupportedOperation{}
+        };
+    }
+
+    etl::expected<nb::Poll<nb::Future<bool>>, net::link::MediaPortUnsupportedOperation>
+    wifi_close_server(util::Time &) {
+        return etl::unexpected<net::link::MediaPortUnsupportedOperation>{
+            net::link::MediaPortUnsupportedOperation{}
+        };
+    }
+
+    net::link::MediaPortOperationResult
+    ethernet_set_local_ip_address(const etl::span<const uint8_t> &) {
+        return net::link::MediaPortOperationResult::UnsupportedOperation;
+    }
+
+    net::link::MediaPortOperationResult ethernet_set_subnet_mask(const etl::span<const uint8_t> &) {
+        return net::link::MediaPortOperationResult::UnsupportedOperation;
+    }
+
+    net::link::MediaInfo get_media_info() {
+        return net::link::MediaInfo{};
+    }
+
+    etl::optional<net::link::ChannelStatistics> get_channel_statistics() {
+        return etl::nullopt;
+    }
+};
+
+// ブロードキャストできないシリアルのポートを1つだけ持つ
+struct NetworkMediaService {
+    using MediaPortType = NetworkMediaPort;
+
+    net::link::Address address;
+    NetworkMediaPort port{};
+
+    etl::optional<etl::reference_wrapper<NetworkMediaPort>>
+    get_media_port(net::link::MediaPortNumber) {
+        return etl::ref(port);
+    }
+
+    etl::optional<net::link::Address> get_media_address() {
+        return address;
+    }
+
+    void get_media_addresses(etl::vector<net::link::Address, net::link::MAX_MEDIA_PER_NODE> &dest) {
+        dest.push_back(address);
+    }
+
+    void get_media_info(etl::vector<net::link::MediaInfo, net::link::MAX_MEDIA_PER_NODE> &) {}
+
+    etl::optional<net::link::Address> get_broadcast_address(net::link::AddressType) {
+        return etl::nullopt;
+    }
+
+    net::link::ChannelStatistics get_channel_statistics() {
+        return net::link::ChannelStatistics{};
+    }
+};
+
+// `Socket`はノードが使うルーティングソケットの型
+template <typename Socket = net::routing::RoutingSocket<NETWORK_FRAME_DELAY_POOL_SIZE>>
+struct NetworkNode {
+    // `memory::Static`は破棄するとpanicするため，ノードごと意図的にリークさせる
+    net::frame::FrameService fs{
+        *new memory::Static<net::frame::MultiSizeFrameBufferPool<16, 16, 16>>{}
+    };
+    memory::Static<net::link::MeasuredLinkFrameQueue> queue;
+    NetworkMediaService ms;
+    net::link::LinkService ls{queue};
+    net::notification::NotificationService nts{};
+    net::local::LocalNodeService lns;
+    net::neighbor::NeighborService ns;
+    net::discovery::DiscoveryService ds;
+    Socket socket;
+    uint16_t received_count{0};
+    // falseの間は受信したフレームを取り出さず，ソケットに溜めたままにする
+    bool drains_received_frames{true};
+
+    NetworkNode(util::Time &time, uint8_t id, const net::discovery::DiscoveryConfig &config)
+        : queue{time},
+          ms{.address = address_of(id)},
+          lns{time},
+          ns{ls, time},
+          ds{ls, time, config},
+          socket{ls.open(net::frame::ProtocolNumber::Tunnel), NETWORK_SOCKET_CONFIG} {}
+
+    static net::link::Address address_of(uint8_t id) {
+        return net::link::Address{net::link::AddressType::Serial, etl::array<uint8_t, 1>{id}};
+    }
+
+    inline net::node::NodeId id() const {
+        return net::node::NodeId{ms.address};
+    }
+
+    void execute(util::Time &time, util::Rand &rand) {
+        queue->execute(time);
+        lns.execute(ms, ls, nts, time);
+        ns.execute(fs, ms, lns, nts, time);
+        ds.execute(fs, ms, lns, ns, time, rand);
+        socket.execute(fs, ms, lns, ns, ds, time, rand);
+        nts.clear();
+
+        while (drains_received_frames && socket.poll_receive_frame().is_ready()) {
+            received_count++;
+        }
+    }
+
+    // 1byteのペイロード`data`を`dest`に送信し，送信結果を受け取るFutureを返す．
+    // バッファやソケットに空きがなく送信できない場合はnulloptを返す
+    etl::optional<nb::Future<etl::expected<void, net::neighbor::SendError>>> try_send(
+        const net::node::Destination &dest,
+        util::Time &time,
+        util::Rand &rand,
+        uint8_t data = 0
+    ) {
+        auto poll_writer = socket.poll_frame_writer(fs, lns, rand, dest, 1);
+        if (poll_writer.is_pending()) {
+            return etl::nullopt;
+        }
+        auto &writer = poll_writer.unwrap();
+        writer.write_unchecked(data);
+        auto poll_future = socket.poll_send_frame(dest, writer.create_reader());
+        if (poll_future.is_pending()) {
+            return etl::nullopt;
+        }
+        return etl::move(poll_future.unwrap());
+    }
+
+    inline etl::optional<nb::Future<etl::expected<void, net::neighbor::SendError>>> try_send_to(
+        const net::node::NodeId &destination,
+        util::Time &time,
+        util::Rand &rand,
+        uint8_t data = 0
+    ) {
+        return try_send(net::node::Destination::node(destination), time, rand, data);
+    }
+
+    nb::Future<etl::expected<void, net::neighbor::SendError>>
+    send_to(const net::node::NodeId &destination, util::Time &time, util::Rand &rand) {
+        auto opt_future = try_send_to(destination, time, rand);
+        FASSERT(opt_future.has_value());
+        return etl::move(*opt_future);
+    }
+};
+
+template <
+    uint8_t N,
+    typename Socket = net::routing::RoutingSocket<NETWORK_FRAME_DELAY_POOL_SIZE>>
+struct Network {
+    util::MockTime time{0};
+    SequentialRandom rand{};
+    etl::array<NetworkNode<Socket> *, N> nodes{};
+    etl::array<etl::array<bool, N>, N> links{};
+    etl::array<uint16_t, net::frame::NUM_PROTOCOLS> sent_frame_count{}; // プロトコルごと
+
+    explicit Network(
+        const net::discovery::DiscoveryConfig &config = net::discovery::DEFAULT_DISCOVERY_CONFIG
+    ) {
+        for (uint8_t i = 0; i < N; i++) {
+            nodes[i] = new NetworkNode<Socket>{time, static_cast<uint8_t>(i + 1), config};
+        }
+    }
+
+    inline NetworkNode<Socket> &operator[](uint8_t index) {
+        return *nodes[index];
+    }
+
+    inline uint16_t sent_count_of(net::frame::ProtocolNumber protocol) const {
+        return sent_frame_count[static_cast<uint8_t>(protocol)];
+    }
+
+    // 2つのノードをつなぎ，互いにHelloを送る
+    void connect(uint8_t a, uint8_t b, net::node::Cost cost = net::node::Cost(10)) {
+        links[a][b] = links[b][a] = true;
+        REQUIRE(run_until([&]() {
+            auto &na = *nodes[a];
+            return na.ns.poll_send_hello(na.ls, na.lns, nodes[b]->ms.address, cost, NETWORK_PORT)
+                .is_ready();
+        }));
+        REQUIRE(run_until([&]() {
+            return nodes[a]->ns.has_neighbor(nodes[b]->id()) &&
+                nodes[b]->ns.has_neighbor(nodes[a]->id());
+        }));
+    }
+
+    // 送信されたフレームを，つながっているノードにだけ届ける
+    void deliver(uint8_t from) {
+        auto &queue = nodes[from]->queue;
+        while (true) {
+            auto poll_frame =
+                queue->poll_get_send_requested_frame(NETWORK_PORT, net::link::AddressType::Serial);
+            if (poll_frame.is_pending()) {
+                return;
+            }
+
+            auto &frame = poll_frame.unwrap();
+            sent_frame_count[static_cast<uint8_t>(frame.protocol_number)]++;
+            for (uint8_t to = 0; to < N; to++) {
+                if (links[from][to] && nodes[to]->ms.address == frame.remote) {
+                    auto _ = nodes[to]->queue->poll_dispatch_received_frame(
+                        NETWORK_PORT, frame.protocol_number, nodes[from]->ms.address,
+                        etl::move(frame.reader), time
+                    );
+                }
+            }
+        }
+    }
+
+    void tick() {
+        for (uint8_t i = 0; i < N; i++) {
+            nodes[i]->execute(time, rand);
+        }
+        for (uint8_t i = 0; i < N; i++) {
+            deliver(i);
+        }
+        time.advance(util::Duration::from_millis(1));
+    }
+
+    void run_for(util::Duration duration) {
+        auto end = time.now() + duration;
+        while (time.now() < end) {
+            tick();
+        }
+    }
+
+    // `condition`が満たされるまで進める．`timeout`までに満たされなければfalseを返す
+    template <typename F>
+    bool run_until(F &&condition, util::Duration timeout = util::Duration::from_seconds(60)) {
+        auto end = time.now() + timeout;
+        while (!condition()) {
+            if (time.now() >= end) {
+                return false;
+            }
+            tick();
+        }
+        return true;
+    }
+
+    template <typename T>
+    T wait(nb::Future<T> &future) {
+        etl::optional<T> result;
+        REQUIRE(run_until([&]() {
+            auto poll = future.poll();
+            if (poll.is_ready()) {
+                result = etl::move(poll.unwrap().get());
+            }
+            return result.has_value();
+        }));
+        return etl::move(*result);
+    }
+};
@@ -0,0 +1,189 @@
+#include <doctest.h>
+
+#include <net/discovery/cache.h>
+
+using namespace net;
+
+static node::NodeId node_id(uint8_t body) {
+    return node::NodeId{link::Address{link::AddressType::Serial, etl::array<uint8_t, 1>{body}}};
+}
+
+static discovery::TotalCost total_cost(uint16_t cost) {
+    util::MockRandom rand{0};
+    auto frame = discovery::ReceivedDiscoveryFrame{
+        .type = discovery::DiscoveryFrameType::Request,
+        .frame_id = frame::FrameId::random(rand),
+        .total_cost = node::Cost{cost},
+        .source = node::Source{node_id(0), node::OptionalClusterId::no_cluster()},
+        .target = node::Destination::broadcast(),
+        .previousHop = node_id(0),
+    };
+    return frame.calculate_total_cost(node::Cost{0}, node::Cost{0});
+}
+
+using CacheSet = discovery::DiscoveryCacheSet<node::NodeId, 3>;
+
+static bool reachable(const node::NodeId &) {
+    return true;
+}
+
+TEST_CASE("update and get") {
+    util::MockTime time{0};
+    CacheSet cache;
+
+    cache.update(node_id(1), node_id(10), total_cost(1), time);
+    auto value = cache.get(node_id(1), reachable);
+    REQUIRE(value.has_value());
+    CHECK(value->gateway_id == node_id(10));
+    CHECK_FALSE(cache.get(node_id(2), reachable).has_value());
+
+    cache.update(node_id(1), node_id(10), total_cost(5), time);
+    CHECK(cache.size() == 1);
+    CHECK(cache.get(node_id(1), reachable)->total_cost == total_cost(5));
+}
+
+TEST_CASE("evict least recently used") {
+    util::MockTime time{0};
+    CacheSet cache;
+    for (uint8_t i = 1; i <= 3; i++) {
+        cache.update(node_id(i), node_id(10), total_cost(1), time);
+    }
+
+    // 参照したエントリは追い出されない
+    CHECK(cache.get(node_id(1), reachable).has_value());
+    cache.update(node_id(4), node_id(10), total_cost(1), time);
+
+    CHECK(cache.size() == 3);
+    CHECK(cache.get(node_id(1), reachable).has_value());
+    CHECK_FALSE(cache.get(node_id(2), reachable).has_value());
+    CHECK(cache.get(node_id(3), reachable).has_value());
+    CHECK(cache.get(node_id(4), reachable).has_value());
+}
+
+TEST_CASE("remove expired in update order") {
+    util::MockTime time{0};
+    CacheSet cache;
+    cache.update(node_id(1), node_id(10), total_cost(1), time);
+    time.advance(util::Duration::from_seconds(1));
+    cache.update(node_id(2), node_id(10), total_cost(1), time);
+
+    time.advance(discovery::DISCOVERY_CACHE_EXPIRATION - util::Duration::from_seconds(1));
+    cache.remove_expired(time.now());
+    CHECK_FALSE(cache.get(node_id(1), reachable).has_value());
+    CHECK(cache.get(node_id(2), reachable).has_value());
+
+    time.advance(util::Duration::from_seconds(1));
+    cache.remove_expired(time.now());
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("remove by gateway") {
+    util::MockTime time{0};
+    CacheSet cache;
+    cache.update(node_id(1), node_id(10), total_cost(1), time);
+    cache.update(node_id(2), node_id(11), total_cost(1), time);
+
+    cache.remove(node_id(10));
+    CHECK_FALSE(cache.get(node_id(1), reachable).has_value());
+    CHECK(cache.get(node_id(2), reachable).has_value());
+}
+
+TEST_CASE("spread load across gateways of similar cost") {
+    util::MockTime time{0};
+    CacheSet cache;
+    cache.update(node_id(1), node_id(10), total_cost(100), time);
+    cache.update(node_id(1), node_id(11), total_cost(100), time);
+
+    uint8_t count_10 = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        if (cache.get(node_id(1), reachable)->gateway_id == node_id(10)) {
+            count_10++;
+        }
+    }
+    CHECK(count_10 == 5);
+}
+
+TEST_CASE("prefer cheaper gateway and ignore costly one") {
+    util::MockTime time{0};
+    CacheSet cache;
+    cache.update(node_id(1), node_id(10), total_cost(100), time);
+    cache.update(node_id(1), node_id(11), total_cost(110), time);
+
+    uint8_t count_10 = 0;
+    for (uint8_t i = 0; i < 10; i++) {
+        if (cache.get(node_id(1), reachable)->gateway_id == node_id(10)) {
+            count_10++;
+        }
+    }
+    CHECK(count_10 > 5);
+    CHECK(count_10 < 10);
+
+    // 許容範囲を超えるゲートウェイは使わない
+    cache.update(node_id(1), node_id(11), total_cost(200), time);
+    for (uint8_t i = 0; i < 10; i++) {
+        CHECK(cache.get(node_id(1), reachable)->gateway_id == node_id(10));
+    }
+
+    // より安いゲートウェイは最も高いゲートウェイを置き換える
+    cache.update(node_id(1), node_id(12), total_cost(50), time);
+    cache.remove(node_id(10));
+    CHECK(cache.get(node_id(1), reachable)->gateway_id == node_id(12));
+}
+
+TEST_CASE("fail over to remaining gateway") {
+    util::MockTime time{0};
+    CacheSet cache;
+    cache.update(node_id(1), node_id(10), total_cost(100), time);
+    cache.update(node_id(1), node_id(11), total_cost(100), time);
+
+    auto without_10 = [](const node::NodeId &id) { return id != node_id(10); };
+    for (uint8_t i = 0; i < 4; i++) {
+        CHECK(cache.get(node_id(1), without_10)->gateway_id == node_id(11));
+    }
+
+    auto unreachable = [](const node::NodeId &) { return false; };
+    CHECK_FALSE(cache.get(node_id(1), unreachable).has_value());
+    CHECK(cache.size() == 0);
+}
+
+static node::Source source_of(uint8_t body) {
+    return node::Source{node_id(body), node::OptionalClusterId::no_cluster()};
+}
+
+// 何度選んでも`gateway_id`だけが選ばれるか
+static bool always_select(
+    discovery::DiscoveryCache &cache,
+    const node::Destination &destination,
+    const node::NodeId &gateway_id
+) {
+    for (uint8_t i = 0; i < 8; i++) {
+        auto gateway = cache.get_by_destination(destination, reachable);
+        if (!gateway.has_value() || gateway->gateway_id != gateway_id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("discovery replaces a learned reverse path") {
+    util::MockTime time{0};
+    discovery::DiscoveryCache cache{time};
+    auto destination = node::Destination(source_of(1));
+
+    // 逆経路は前ホップまでのコストしか含まないため，実際より安く見える
+    cache.learn_reverse_path(source_of(1), node_id(2), node::Cost{1}, node::Cost{0}, time);
+    CHECK(always_select(cache, destination, node_id(2)));
+
+    cache.update(destination, node_id(3), total_cost(10), time);
+    CHECK(always_select(cache, destination, node_id(3)));
+}
+
+TEST_CASE("learned reverse path does not override discovery") {
+    util::MockTime time{0};
+    discovery::DiscoveryCache cache{time};
+    auto destination = node::Destination(source_of(1));
+
+    cache.update(destination, node_id(3), total_cost(10), time);
+    cache.learn_reverse_path(source_of(1), node_id(2), node::Cost{1}, node::Cost{0}, time);
+    CHECK(always_select(cache, destination, node_id(3)));
+}
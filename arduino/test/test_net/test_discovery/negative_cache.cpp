@@ -0,0 +1,67 @@
+#include <doctest.h>
+
+#include <net/discovery/negative_cache.h>
+
+using namespace net;
+
+static node::Destination destination(uint8_t body) {
+    return node::Destination::node(
+        node::NodeId{link::Address{link::AddressType::Serial, etl::array<uint8_t, 1>{body}}}
+    );
+}
+
+TEST_CASE("suppress discovery until backoff elapses") {
+    util::MockTime time{0};
+    discovery::NegativeCache cache;
+    CHECK_FALSE(cache.poll_suppressed(destination(1), time));
+
+    cache.on_discovery_failed(destination(1), time);
+    CHECK(cache.poll_suppressed(destination(1), time));
+    CHECK_FALSE(cache.poll_suppressed(destination(2), time));
+    CHECK(cache.suppressed_count() == 1);
+
+    time.advance(discovery::NEGATIVE_CACHE_BASE_BACKOFF);
+    CHECK_FALSE(cache.poll_suppressed(destination(1), time));
+}
+
+TEST_CASE("double backoff on repeated failure") {
+    util::MockTime time{0};
+    discovery::NegativeCache cache;
+    cache.on_discovery_failed(destination(1), time);
+
+    // 抑制中の失敗は同じ経路探索のものとして数えない
+    cache.on_discovery_failed(destination(1), time);
+    time.advance(discovery::NEGATIVE_CACHE_BASE_BACKOFF);
+    CHECK_FALSE(cache.poll_suppressed(destination(1), time));
+
+    cache.on_discovery_failed(destination(1), time);
+    time.advance(discovery::NEGATIVE_CACHE_BASE_BACKOFF);
+    CHECK(cache.poll_suppressed(destination(1), time));
+    time.advance(discovery::NEGATIVE_CACHE_BASE_BACKOFF);
+    CHECK_FALSE(cache.poll_suppressed(destination(1), time));
+}
+
+TEST_CASE("forget failure when reachable") {
+    util::MockTime time{0};
+    discovery::NegativeCache cache;
+    cache.on_discovery_failed(destination(1), time);
+
+    cache.on_reachable(destination(1));
+    CHECK_FALSE(cache.poll_suppressed(destination(1), time));
+    CHECK(cache.suppressed_count() == 0);
+}
+
+TEST_CASE("forget failures of every destination on the node that sent a frame") {
+    util::MockTime time{0};
+    discovery::NegativeCache cache;
+    auto node_id = destination(1).node_id;
+    auto with_cluster = node::Destination::node_and_cluster(node_id, node::OptionalClusterId{2});
+    cache.on_discovery_failed(destination(1), time);
+    cache.on_discovery_failed(with_cluster, time);
+    cache.on_discovery_failed(destination(2), time);
+
+    cache.on_reachable(node_id);
+    CHECK_FALSE(cache.poll_suppressed(destination(1), time));
+    CHECK_FALSE(cache.poll_suppressed(with_cluster, time));
+    CHECK(cache.poll_suppressed(destination(2), time));
+}
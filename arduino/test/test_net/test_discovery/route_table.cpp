@@ -0,0 +1,134 @@
+#include <doctest.h>
+
+#include "../network.h"
+#include <net/discovery/route_table.h>
+
+using namespace net;
+
+static node::NodeId node_id(uint8_t body) {
+    return node::NodeId{link::Address{link::AddressType::Serial, etl::array<uint8_t, 1>{body}}};
+}
+
+static discovery::AdvertisedRoute
+route(uint8_t destination, uint16_t cost, uint8_t hop_count, uint8_t gateway) {
+    return discovery::AdvertisedRoute{
+        .destination = node_id(destination),
+        .gateway_id = node_id(gateway),
+        .cost = node::Cost{cost},
+        .hop_count = hop_count,
+    };
+}
+
+TEST_CASE("prefer cheaper gateway") {
+    util::MockTime time{0};
+    discovery::RouteTable table;
+    auto self = node_id(0);
+
+    table.on_route_advertised(self, node_id(1), node::Cost{10}, route(9, 10, 1, 9), time);
+    CHECK(table.get_gateway(node_id(9)) == node_id(1));
+
+    table.on_route_advertised(self, node_id(2), node::Cost{10}, route(9, 20, 1, 9), time);
+    CHECK(table.get_gateway(node_id(9)) == node_id(1));
+
+    table.on_route_advertised(self, node_id(2), node::Cost{1}, route(9, 1, 1, 9), time);
+    CHECK(table.get_gateway(node_id(9)) == node_id(2));
+}
+
+TEST_CASE("remove route over max hop count") {
+    util::MockTime time{0};
+    discovery::RouteTable table;
+    auto self = node_id(0);
+
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 1, 1, 9), time);
+    REQUIRE(table.get_gateway(node_id(9)).has_value());
+
+    table.on_route_advertised(
+        self, node_id(1), node::Cost{1}, route(9, 1, discovery::MAX_ROUTE_HOP_COUNT, 9), time
+    );
+    CHECK_FALSE(table.get_gateway(node_id(9)).has_value());
+}
+
+TEST_CASE("reject advertised hop count that would wrap") {
+    util::MockTime time{0};
+    discovery::RouteTable table;
+    auto self = node_id(0);
+
+    // 上限を超えたホップ数の広告は，1を加えても0に戻らず到達不能として扱う
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 1, 0xFF, 9), time);
+    CHECK_FALSE(table.get_gateway(node_id(9)).has_value());
+
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 1, 1, 9), time);
+    REQUIRE(table.get_gateway(node_id(9)).has_value());
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 1, 0xFF, 9), time);
+    CHECK_FALSE(table.get_gateway(node_id(9)).has_value());
+}
+
+TEST_CASE("poison reverse routes through self") {
+    util::MockTime time{0};
+    discovery::RouteTable table;
+    auto self = node_id(0);
+
+    // 自ノードを経由する経路は，広告されても採用しない
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 1, 1, 0), time);
+    CHECK_FALSE(table.get_gateway(node_id(9)).has_value());
+
+    // 現在のゲートウェイが自ノード経由の経路を広告した場合は，到達不能として削除する
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 1, 1, 2), time);
+    REQUIRE(table.get_gateway(node_id(9)) == node_id(1));
+    table.on_route_advertised(self, node_id(1), node::Cost{1}, route(9, 3, 2, 0), time);
+    CHECK_FALSE(table.get_gateway(node_id(9)).has_value());
+}
+
+TEST_CASE("no count to infinity after link break") {
+    // 0 - 1 - 9 のトポロジで，1と9の間のリンクが切断された後に0が経路を広告する
+    util::MockTime time{0};
+    discovery::RouteTable table0;
+    discovery::RouteTable table1;
+
+    table0.on_route_advertised(node_id(0), node_id(1), node::Cost{1}, route(9, 1, 1, 9), time);
+    REQUIRE(table0.get_gateway(node_id(9)) == node_id(1));
+
+    table0.for_each([&](const discovery::RouteEntry &entry) {
+        discovery::AdvertisedRoute advertised{
+            .destination = entry.destination,
+            .gateway_id = entry.gateway_id,
+            .cost = entry.cost,
+            .hop_count = entry.hop_count,
+        };
+        table1.on_route_advertised(node_id(1), node_id(0), node::Cost{1}, advertised, time);
+    });
+    CHECK_FALSE(table1.get_gateway(node_id(9)).has_value());
+}
+
+TEST_CASE("remove expired route") {
+    util::MockTime time{0};
+    discovery::RouteTable table;
+
+    table.on_route_advertised(node_id(0), node_id(1), node::Cost{1}, route(9, 1, 1, 9), time);
+    time.advance(discovery::ROUTE_EXPIRATION);
+    table.remove_expired(time.now());
+    CHECK_FALSE(table.get_gateway(node_id(9)).has_value());
+}
+
+TEST_CASE("first packet latency in line topology") {
+    // 0 - 1 - 2 - ... - 9 の直線状のネットワークで，経路広告により経路表を埋める
+    constexpr uint8_t NODE_COUNT = 10;
+    Network<NODE_COUNT> net{discovery::DiscoveryConfig{.enable_proactive_routing = true}};
+    for (uint8_t i = 0; i + 1 < NODE_COUNT; i++) {
+        net.connect(i, i + 1);
+    }
+
+    // 端のノードへの経路が，広告を繰り返して伝わるのを待つ
+    auto destination = node::Destination::node(net[NODE_COUNT - 1].id());
+    CHECK(net.run_until(
+        [&]() { return net[0].ds.find_known_gateway(net[0].ns, destination).has_value(); },
+        discovery::ROUTE_ADVERTISEMENT_INTERVAL * NODE_COUNT
+    ));
+    CHECK(net[0].ds.find_known_gateway(net[0].ns, destination) == net[1].id());
+
+    // 最初のユニキャストも，経路探索を行わずに届く
+    auto future = net[0].send_to(net[NODE_COUNT - 1].id(), net.time, net.rand);
+    CHECK(net.wait(future).has_value());
+    CHECK(net.run_until([&]() { return net[NODE_COUNT - 1].received_count == 1; }));
+    CHECK(net.sent_count_of(frame::ProtocolNumber::Discover) == 0);
+}
@@ -0,0 +1,146 @@
+#include <doctest.h>
+
+#include <net/frame/service.h>
+
+using namespace net::frame;
+
+static FrameService &make_frame_service() {
+    // プールは破棄するとpanicするため，意図的にリークさせる
+    auto pool = new memory::Static<MultiSizeFrameBufferPool<4, 0, 0>>{};
+    return *new FrameService{*pool};
+}
+
+// 1回のポーリングで`CHUNK_LENGTH`byteまで書き込めるWritable
+template <uint8_t CHUNK_LENGTH>
+struct ChunkedWritable {
+    etl::array<uint8_t, 32> data{};
+    uint8_t written_count{0};
+    uint8_t chunk_remaining{CHUNK_LENGTH};
+    uint8_t bulk_write_count{0};
+
+    nb::Poll<nb::ser::SerializeResult> poll_writable(uint8_t write_count) {
+        return chunk_remaining >= write_count ? nb::ready(nb::ser::SerializeResult::Ok)
+                                              : nb::pending;
+    }
+
+    void write_unchecked(uint8_t byte) {
+        data[written_count++] = byte;
+        chunk_remaining--;
+    }
+
+    nb::Poll<nb::ser::SerializeResult> write(uint8_t byte) {
+        SERDE_SERIALIZE_OR_RETURN(poll_writable(1));
+        write_unchecked(byte);
+        return nb::ser::SerializeResult::Ok;
+    }
+
+    uint8_t writable_length() const {
+        return chunk_remaining;
+    }
+
+    uint8_t write_from(etl::span<const uint8_t> src) {
+        uint8_t length = etl::min(static_cast<uint8_t>(src.size()), chunk_remaining);
+        for (uint8_t i = 0; i < length; i++) {
+            write_unchecked(src[i]);
+        }
+        bulk_write_count++;
+        return length;
+    }
+
+    void next_chunk() {
+        chunk_remaining = CHUNK_LENGTH;
+    }
+};
+
+// `writable_length`より少ないバイト数しか一度に受け付けないWritable
+struct ShortWritable : ChunkedWritable<4> {
+    uint8_t write_from(etl::span<const uint8_t> src) {
+        return ChunkedWritable<4>::write_from(src.first(etl::min<size_t>(src.size(), 1)));
+    }
+};
+
+static_assert(nb::AsyncBulkWritable<ChunkedWritable<1>>);
+static_assert(nb::AsyncBulkWritable<ShortWritable>);
+static_assert(nb::AsyncBulkReadable<FrameBufferReader>);
+static_assert(nb::AsyncBulkWritable<FrameBufferWriter>);
+static_assert(nb::AsyncBulkReadable<nb::AsyncSpanReadable>);
+static_assert(nb::AsyncBulkWritable<nb::AsyncSpanWritable>);
+
+TEST_CASE("read_into and write_from are bounded by available length") {
+    auto &fs = make_frame_service();
+    auto poll_writer = fs.request_frame_writer(4);
+    auto &writer = poll_writer.unwrap();
+    auto reader = writer.create_reader();
+
+    etl::array<uint8_t, 6> src{1, 2, 3, 4, 5, 6};
+    CHECK_EQ(writer.write_from(etl::span{src.data(), 3}), 3);
+    CHECK_EQ(writer.write_from(src), 1);
+    CHECK(writer.is_all_written());
+
+    etl::array<uint8_t, 3> dest{};
+    CHECK_EQ(reader.read_into(dest), 3);
+    CHECK_EQ(dest[2], 3);
+    CHECK_EQ(reader.read_into(dest), 1);
+    CHECK_EQ(dest[0], 1);
+    CHECK(reader.is_all_read());
+}
+
+TEST_CASE("serialize frame buffer in chunks") {
+    auto &fs = make_frame_service();
+    auto poll_writer = fs.request_frame_writer(10);
+    auto &writer = poll_writer.unwrap();
+    for (uint8_t i = 0; i < 10; i++) {
+        writer.write_unchecked(i);
+    }
+
+    ChunkedWritable<4> writable;
+    AsyncFrameBufferReaderSerializer serializer{writer.create_reader()};
+    CHECK(serializer.serialize(writable).is_pending());
+    CHECK_EQ(writable.written_count, 4);
+    writable.next_chunk();
+    CHECK(serializer.serialize(writable).is_pending());
+    writable.next_chunk();
+    CHECK(serializer.serialize(writable).unwrap() == nb::ser::SerializeResult::Ok);
+
+    CHECK_EQ(writable.bulk_write_count, 3);
+    for (uint8_t i = 0; i < 10; i++) {
+        CHECK_EQ(writable.data[i], i);
+    }
+}
+
+TEST_CASE("advance only by the number of bytes actually written") {
+    auto &fs = make_frame_service();
+    auto poll_writer = fs.request_frame_writer(6);
+    auto &writer = poll_writer.unwrap();
+    for (uint8_t i = 0; i < 6; i++) {
+        writer.write_unchecked(i);
+    }
+
+    ShortWritable writable;
+    AsyncFrameBufferReaderSerializer serializer{writer.create_reader()};
+    CHECK(serializer.serialize(writable).is_pending());
+    CHECK_EQ(writable.written_count, 4);
+    writable.next_chunk();
+    CHECK(serializer.serialize(writable).unwrap() == nb::ser::SerializeResult::Ok);
+
+    CHECK_EQ(writable.written_count, 6);
+    for (uint8_t i = 0; i < 6; i++) {
+        CHECK_EQ(writable.data[i], i);
+    }
+}
+
+TEST_CASE("deserialize frame buffer from span") {
+    auto &fs = make_frame_service();
+    auto poll_writer = fs.request_frame_writer(5);
+    auto reader = poll_writer.unwrap().create_reader();
+
+    etl::array<uint8_t, 6> src{1, 2, 3, 4, 5, 6};
+    nb::AsyncSpanReadable readable{src};
+    AsyncFrameBufferWriterDeserializer deserializer{etl::move(poll_writer.unwrap())};
+    CHECK(deserializer.deserialize(readable).unwrap() == nb::de::DeserializeResult::Ok);
+    CHECK_EQ(readable.readable_length(), 1);
+
+    etl::array<uint8_t, 5> dest{};
+    CHECK_EQ(reader.read_into(dest), 5);
+    CHECK_EQ(dest[4], 5);
+}
@@ -0,0 +1,184 @@
+#include <doctest.h>
+
+#include <etl/deque.h>
+#include <etl/vector.h>
+#include <net/frame/frame_id.h>
+#include <net/node.h>
+
+using namespace net;
+
+static const auto WINDOW = util::Duration::from_seconds(10);
+
+static frame::FrameId frame_id(uint16_t value) {
+    util::MockRandom rand{value};
+    return frame::FrameId::random(rand);
+}
+
+TEST_CASE("detect duplicate per source") {
+    util::MockTime time{0};
+    frame::DuplicateDetector<4> detector{WINDOW};
+    auto id = frame_id(1);
+
+    CHECK_FALSE(detector.insert_and_check_contains(1, id, time));
+    CHECK(detector.insert_and_check_contains(1, id, time));
+    CHECK_FALSE(detector.insert_and_check_contains(2, id, time));
+}
+
+TEST_CASE("count duplicates") {
+    util::MockTime time{0};
+    frame::DuplicateDetector<4> detector{WINDOW};
+    auto id = frame_id(1);
+
+    CHECK(detector.duplicate_count(1, id) == 0);
+    detector.insert_and_check_contains(1, id, time);
+    CHECK(detector.duplicate_count(1, id) == 0);
+    detector.insert_and_check_contains(1, id, time);
+    detector.insert_and_check_contains(1, id, time);
+    CHECK(detector.duplicate_count(1, id) == 2);
+    CHECK(detector.duplicate_count(2, id) == 0);
+}
+
+TEST_CASE("keep at least half of capacity") {
+    util::MockTime time{0};
+    frame::DuplicateDetector<4> detector{WINDOW};
+    auto first = frame_id(1);
+    auto second = frame_id(2);
+    auto third = frame_id(3);
+
+    detector.insert_and_check_contains(1, first, time);
+    detector.insert_and_check_contains(1, second, time);
+    detector.insert_and_check_contains(1, third, time);
+    CHECK(detector.insert_and_check_contains(1, first, time));
+    CHECK(detector.insert_and_check_contains(1, second, time));
+
+    // 4つ目以降を記録すると，最も古い世代が捨てられる
+    detector.insert_and_check_contains(1, frame_id(4), time);
+    detector.insert_and_check_contains(1, frame_id(5), time);
+    CHECK_FALSE(detector.insert_and_check_contains(1, first, time));
+}
+
+TEST_CASE("forget frames after window") {
+    util::MockTime time{0};
+    frame::DuplicateDetector<8> detector{WINDOW};
+    auto id = frame_id(1);
+
+    detector.insert_and_check_contains(1, id, time);
+    time.advance(WINDOW / 2);
+    CHECK(detector.insert_and_check_contains(1, id, time));
+    time.advance(WINDOW / 2);
+    CHECK_FALSE(detector.insert_and_check_contains(1, id, time));
+}
+
+TEST_CASE("generated id is detected as duplicate") {
+    util::MockTime time{0};
+    util::MockRandom rand{0};
+    frame::DuplicateDetector<8> detector{WINDOW};
+
+    auto id = detector.generate(1, rand);
+    CHECK(detector.insert_and_check_contains(1, id, time));
+}
+
+namespace {
+    // 4x5の格子状に並んだ20ノードで，各ノードが同時に送信したブロードキャストをフラッディングする
+    constexpr uint8_t WIDTH = 4;
+    constexpr uint8_t HEIGHT = 5;
+    constexpr uint8_t NODE_COUNT = WIDTH * HEIGHT;
+    constexpr uint8_t FRAMES_PER_NODE = 1;
+    constexpr uint8_t FRAME_COUNT = NODE_COUNT * FRAMES_PER_NODE;
+    constexpr uint8_t MAX_HOP_COUNT = WIDTH + HEIGHT - 2; // 格子の直径
+
+    struct Delivery {
+        uint8_t receiver;
+        uint8_t frame;
+        uint8_t hop_count;
+    };
+
+    struct FloodResult {
+        uint16_t forward_count;
+        uint16_t duplicate_forward_count;
+    };
+
+    template <uint8_t CAPACITY>
+    FloodResult flood() {
+        util::MockTime time{0};
+
+        etl::vector<frame::DuplicateDetector<CAPACITY>, NODE_COUNT> detectors;
+        for (uint8_t i = 0; i < NODE_COUNT; i++) {
+            detectors.emplace_back(WINDOW);
+        }
+
+        etl::vector<uint8_t, FRAME_COUNT> sources;
+        etl::vector<frame::FrameId, FRAME_COUNT> ids;
+        for (uint8_t i = 0; i < FRAME_COUNT; i++) {
+            uint8_t source = i % NODE_COUNT;
+            sources.push_back(source);
+            ids.push_back(frame_id(i));
+            detectors[source].insert_and_check_contains(source, ids[i], time);
+        }
+
+        static etl::deque<Delivery, 4096> queue;
+        queue.clear();
+        bool forwarded[NODE_COUNT][FRAME_COUNT] = {};
+        FloodResult result{0, 0};
+
+        auto forward = [&](uint8_t node, uint8_t frame, uint8_t hop_count) {
+            result.forward_count++;
+            if (forwarded[node][frame]) {
+                result.duplicate_forward_count++;
+            }
+            forwarded[node][frame] = true;
+            if (hop_count == MAX_HOP_COUNT) {
+                return;
+            }
+
+            // 送信キューが溢れた場合は破棄する
+            auto send = [&](uint8_t neighbor) {
+                if (queue.full()) {
+                    return;
+                }
+                queue.push_back(Delivery{neighbor, frame, static_cast<uint8_t>(hop_count + 1)});
+            };
+            uint8_t x = node % WIDTH;
+            uint8_t y = node / WIDTH;
+            if (x > 0) {
+                send(node - 1);
+            }
+            if (x < WIDTH - 1) {
+                send(node + 1);
+            }
+            if (y > 0) {
+                send(node - WIDTH);
+            }
+            if (y < HEIGHT - 1) {
+                send(node + WIDTH);
+            }
+        };
+
+        for (uint8_t i = 0; i < FRAME_COUNT; i++) {
+            forward(sources[i], i, 0);
+        }
+
+        while (!queue.empty()) {
+            auto delivery = queue.front();
+            queue.pop_front();
+            time.advance(util::Duration::from_millis(1));
+
+            auto &detector = detectors[delivery.receiver];
+            uint8_t source = sources[delivery.frame];
+            if (!detector.insert_and_check_contains(source, ids[delivery.frame], time)) {
+                forward(delivery.receiver, delivery.frame, delivery.hop_count);
+            }
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("duplicate forwarding rate in 20-node broadcast") {
+    // 同時に流れるフレームより記録が少ないと，重複したフレームを再び中継してしまう
+    auto small = flood<8>();
+    CHECK(small.duplicate_forward_count > small.forward_count / 2);
+
+    auto large = flood<32>();
+    CHECK(large.duplicate_forward_count == 0);
+    CHECK(large.forward_count == FRAME_COUNT * NODE_COUNT);
+}
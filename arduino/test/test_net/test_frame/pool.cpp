@@ -0,0 +1,147 @@
+#include <doctest.h>
+
+#include <net/frame/service.h>
+
+using namespace net::frame;
+
+template <uint8_t SHORT_BUFFER_COUNT, uint8_t MEDIUM_BUFFER_COUNT, uint8_t LARGE_BUFFER_COUNT>
+static FrameBufferAllocator make_allocator() {
+    // プールは破棄するとpanicするため，意図的にリークさせる
+    auto pool = new MultiSizeFrameBufferPool<
+        SHORT_BUFFER_COUNT, MEDIUM_BUFFER_COUNT, LARGE_BUFFER_COUNT>{};
+    return pool->allocator();
+}
+
+TEST_CASE("allocate from exact size class") {
+    auto allocator = make_allocator<1, 1, 1>();
+
+    auto short_ref = allocator.allocate(SHORT_BUFFER_LENGTH);
+    auto medium_ref = allocator.allocate(MEDIUM_BUFFER_LENGTH);
+    auto large_ref = allocator.allocate(LARGE_BUFFER_LENGTH);
+    CHECK(short_ref.is_ready());
+    CHECK(medium_ref.is_ready());
+    CHECK(large_ref.is_ready());
+
+    auto stats = allocator.stats();
+    CHECK_EQ(stats[0].in_use, 1);
+    CHECK_EQ(stats[1].in_use, 1);
+    CHECK_EQ(stats[2].in_use, 1);
+    CHECK_EQ(stats[0].fallback_count, 0);
+    CHECK_EQ(stats[1].fallback_count, 0);
+}
+
+TEST_CASE("allocate zero length") {
+    auto allocator = make_allocator<0, 0, 0>();
+    auto ref = allocator.allocate(0);
+    CHECK(ref.is_ready());
+    CHECK_EQ(ref.unwrap().buffer_length(), 0);
+}
+
+TEST_CASE("short class borrows from larger classes") {
+    auto allocator = make_allocator<1, 1, 1>();
+
+    auto r1 = allocator.allocate(10);
+    auto r2 = allocator.allocate(10);
+    auto r3 = allocator.allocate(10);
+    REQUIRE(r1.is_ready());
+    REQUIRE(r2.is_ready());
+    REQUIRE(r3.is_ready());
+    CHECK_EQ(r2.unwrap().buffer_length(), 10);
+    CHECK_EQ(r3.unwrap().buffer_length(), 10);
+
+    auto stats = allocator.stats();
+    CHECK_EQ(stats[0].in_use, 1);
+    CHECK_EQ(stats[1].in_use, 1);
+    CHECK_EQ(stats[2].in_use, 1);
+    CHECK_EQ(stats[0].fallback_count, 2);
+    CHECK_EQ(stats[0].failed_count, 0);
+
+    CHECK(allocator.allocate(10).is_pending());
+    CHECK_EQ(allocator.stats()[0].failed_count, 1);
+}
+
+TEST_CASE("larger class never borrows from smaller classes") {
+    auto allocator = make_allocator<2, 0, 1>();
+
+    auto r1 = allocator.allocate(MEDIUM_BUFFER_LENGTH);
+    REQUIRE(r1.is_ready());
+    CHECK_EQ(allocator.stats()[1].fallback_count, 1);
+
+    CHECK(allocator.allocate(SHORT_BUFFER_LENGTH + 1).is_pending());
+    CHECK(allocator.allocate(SHORT_BUFFER_LENGTH).is_ready());
+}
+
+TEST_CASE("no frame is lost while any suitable buffer is free") {
+    auto allocator = make_allocator<4, 2, 2>();
+
+    // 32バイト以下のフレームはすべてのクラスで受け入れられる
+    etl::vector<FrameBufferReference, 8> refs;
+    for (uint8_t i = 0; i < 8; i++) {
+        auto poll = allocator.allocate(SHORT_BUFFER_LENGTH);
+        REQUIRE(poll.is_ready());
+        refs.push_back(etl::move(poll.unwrap()));
+    }
+    CHECK(allocator.allocate(1).is_pending());
+
+    // 解放されたバッファはすぐに再利用できる
+    refs.pop_back();
+    CHECK(allocator.allocate(SHORT_BUFFER_LENGTH).is_ready());
+}
+
+TEST_CASE("released buffer returns to its own class") {
+    auto allocator = make_allocator<1, 0, 1>();
+
+    auto r1 = allocator.allocate(1);
+    {
+        auto r2 = allocator.allocate(1);
+        REQUIRE(r2.is_ready());
+        CHECK_EQ(allocator.stats()[2].in_use, 1);
+    }
+    CHECK_EQ(allocator.stats()[2].in_use, 0);
+    CHECK(allocator.allocate_max_length().is_ready());
+}
+
+TEST_CASE("reset stats") {
+    auto allocator = make_allocator<1, 0, 0>();
+
+    auto r1 = allocator.allocate(1);
+    CHECK(allocator.allocate(1).is_pending());
+    CHECK_EQ(allocator.stats()[0].high_water_mark, 1);
+    CHECK_EQ(allocator.stats()[0].failed_count, 1);
+
+    allocator.reset_stats();
+    CHECK_EQ(allocator.stats()[0].high_water_mark, 1);
+    CHECK_EQ(allocator.stats()[0].failed_count, 0);
+}
+
+TEST_CASE("report exhaustion only once until allocation succeeds again") {
+    FrameBufferPoolMeasurement measurement;
+    CHECK(measurement.on_allocation_failed());
+    CHECK_FALSE(measurement.on_allocation_failed());
+    CHECK_FALSE(measurement.on_allocation_failed());
+
+    measurement.on_allocated(1);
+    CHECK(measurement.on_allocation_failed());
+
+    measurement.on_fallback();
+    CHECK(measurement.on_allocation_failed());
+}
+
+TEST_CASE("count a pending request once however often it polls") {
+    auto allocator = make_allocator<1, 0, 0>();
+
+    {
+        auto r1 = allocator.allocate(1);
+        for (uint8_t i = 0; i < 100; i++) {
+            CHECK(allocator.allocate(1).is_pending());
+        }
+        CHECK_EQ(allocator.stats()[0].failed_count, 1);
+    }
+
+    // 解放されて確保できた後に再び枯渇した場合は，別の失敗として数える
+    auto r2 = allocator.allocate(1);
+    CHECK(r2.is_ready());
+    CHECK_EQ(allocator.stats()[0].failed_count, 1);
+    CHECK(allocator.allocate(1).is_pending());
+    CHECK_EQ(allocator.stats()[0].failed_count, 2);
+}
@@ -0,0 +1,221 @@
+#include <doctest.h>
+
+#include <net/frame/service.h>
+#include <net/link/broker.h>
+
+using namespace net;
+
+static frame::FrameService &make_frame_service() {
+    // プールは破棄するとpanicするため，意図的にリークさせる
+    auto pool = new memory::Static<frame::MultiSizeFrameBufferPool<32, 0, 0>>{};
+    return *new frame::FrameService{*pool};
+}
+
+static frame::FrameBufferReader make_reader(frame::FrameService &fs) {
+    return fs.request_frame_writer(1).unwrap().create_reader();
+}
+
+static link::Address address(link::AddressType type, uint8_t body) {
+    return link::Address{type, etl::array<uint8_t, 1>{body}};
+}
+
+static const link::MediaPortNumber PORT_0{0};
+static const link::MediaPortNumber PORT_1{1};
+
+TEST_CASE("receive frames per protocol") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+    auto remote = address(link::AddressType::Serial, 1);
+
+    queue.poll_dispatch_received_frame(
+        PORT_0, frame::ProtocolNumber::Tunnel, remote, make_reader(fs), time
+    );
+    queue.poll_dispatch_received_frame(
+        PORT_0, frame::ProtocolNumber::Rpc, remote, make_reader(fs), time
+    );
+
+    CHECK(queue.poll_receive_frame(frame::ProtocolNumber::Discover).is_pending());
+    auto poll = queue.poll_receive_frame(frame::ProtocolNumber::Rpc);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap().frame.protocol_number == frame::ProtocolNumber::Rpc);
+    CHECK(queue.poll_receive_frame(frame::ProtocolNumber::Tunnel).is_ready());
+    CHECK(queue.poll_receive_frame(frame::ProtocolNumber::Tunnel).is_pending());
+}
+
+TEST_CASE("receive queues share capacity") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+    auto remote = address(link::AddressType::Serial, 1);
+
+    for (uint8_t i = 0; i < link::MAX_FRAME_BUFFER_SIZE; i++) {
+        auto protocol = i % 2 == 0 ? frame::ProtocolNumber::Rpc : frame::ProtocolNumber::Tunnel;
+        CHECK(queue.poll_dispatch_received_frame(PORT_0, protocol, remote, make_reader(fs), time)
+                  .is_ready());
+    }
+    CHECK(queue
+              .poll_dispatch_received_frame(
+                  PORT_0, frame::ProtocolNumber::Discover, remote, make_reader(fs), time
+              )
+              .is_pending());
+}
+
+TEST_CASE("send frame by port and address type") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+
+    queue.poll_request_send_frame(
+        link::MediaPortMask::from_port_number(PORT_1), frame::ProtocolNumber::Rpc,
+        address(link::AddressType::Serial, 1), make_reader(fs), link::FramePriority::Rpc, time
+    );
+    time.advance(util::Duration::from_millis(1));
+    queue.poll_request_send_frame(
+        link::MediaPortMask::unspecified(), frame::ProtocolNumber::Rpc,
+        address(link::AddressType::UHF, 2), make_reader(fs), link::FramePriority::Rpc, time
+    );
+
+    CHECK(queue.poll_get_send_requested_frame(PORT_0, link::AddressType::Serial).is_pending());
+
+    auto poll = queue.poll_get_send_requested_frame(PORT_1, link::AddressType::UHF);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap().remote == address(link::AddressType::Serial, 1));
+
+    poll = queue.poll_get_send_requested_frame(PORT_0, link::AddressType::UHF);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap().remote == address(link::AddressType::UHF, 2));
+}
+
+TEST_CASE("send frame with multiple ports") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+
+    auto mask = link::MediaPortMask::from_port_number(PORT_0);
+    mask.set(PORT_1);
+    queue.poll_request_send_frame(
+        mask, frame::ProtocolNumber::Rpc, address(link::AddressType::Serial, 1), make_reader(fs),
+        link::FramePriority::Rpc, time
+    );
+
+    CHECK(queue.poll_get_send_requested_frame(link::MediaPortNumber{2}, link::AddressType::Serial)
+              .is_pending());
+    CHECK(queue.poll_get_send_requested_frame(PORT_1, link::AddressType::Serial).is_ready());
+    CHECK(queue.poll_get_send_requested_frame(PORT_0, link::AddressType::Serial).is_pending());
+}
+
+TEST_CASE("drop expired frames") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+    auto remote = address(link::AddressType::Serial, 1);
+
+    queue.poll_dispatch_received_frame(
+        PORT_0, frame::ProtocolNumber::Rpc, remote, make_reader(fs), time
+    );
+    time.advance(link::FRAME_EXPIRATION - util::Duration::from_millis(1));
+    queue.poll_dispatch_received_frame(
+        PORT_0, frame::ProtocolNumber::Rpc, remote, make_reader(fs), time
+    );
+
+    time.advance(util::Duration::from_millis(1));
+    queue.execute(time);
+
+    CHECK(queue.poll_receive_frame(frame::ProtocolNumber::Rpc).is_ready());
+    CHECK(queue.poll_receive_frame(frame::ProtocolNumber::Rpc).is_pending());
+}
+
+static void request_send(
+    link::LinkFrameQueue &queue,
+    frame::FrameService &fs,
+    uint8_t remote,
+    link::FramePriority priority,
+    util::Time &time
+) {
+    queue.poll_request_send_frame(
+        link::MediaPortMask::from_port_number(PORT_0), frame::ProtocolNumber::Rpc,
+        address(link::AddressType::Serial, remote), make_reader(fs), priority, time
+    );
+}
+
+TEST_CASE("send higher priority frame first") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+
+    request_send(queue, fs, 1, link::FramePriority::Bulk, time);
+    request_send(queue, fs, 2, link::FramePriority::Control, time);
+    request_send(queue, fs, 3, link::FramePriority::Rpc, time);
+
+    for (uint8_t remote : {2, 3, 1}) {
+        auto poll = queue.poll_get_send_requested_frame(PORT_0, link::AddressType::Serial);
+        REQUIRE(poll.is_ready());
+        CHECK(poll.unwrap().remote == address(link::AddressType::Serial, remote));
+    }
+}
+
+TEST_CASE("evict lower priority frame when full") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+
+    for (uint8_t i = 0; i < link::MAX_FRAME_BUFFER_SIZE; i++) {
+        request_send(queue, fs, i, link::FramePriority::Bulk, time);
+    }
+    CHECK(queue
+              .poll_request_send_frame(
+                  link::MediaPortMask::from_port_number(PORT_0), frame::ProtocolNumber::Tunnel,
+                  address(link::AddressType::Serial, 0xFF), make_reader(fs),
+                  link::FramePriority::Bulk, time
+              )
+              .is_pending());
+
+    request_send(queue, fs, 0xFE, link::FramePriority::Control, time);
+    CHECK(queue.dropped_frame_count(link::FramePriority::Bulk) == 1);
+    CHECK(queue.dropped_frame_count(link::FramePriority::Control) == 0);
+
+    auto poll = queue.poll_get_send_requested_frame(PORT_0, link::AddressType::Serial);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap().remote == address(link::AddressType::Serial, 0xFE));
+}
+
+TEST_CASE("count expired send frames per priority") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::LinkFrameQueue queue{time};
+
+    request_send(queue, fs, 1, link::FramePriority::Observer, time);
+    time.advance(link::FRAME_EXPIRATION);
+    queue.execute(time);
+
+    CHECK(queue.dropped_frame_count(link::FramePriority::Observer) == 1);
+    CHECK(queue.poll_get_send_requested_frame(PORT_0, link::AddressType::Serial).is_pending());
+}
+
+TEST_CASE("drop stale received frame when full") {
+    auto &fs = make_frame_service();
+    util::MockTime time{0};
+    link::MeasuredLinkFrameQueue queue{time};
+    auto remote = address(link::AddressType::Serial, 1);
+
+    for (uint8_t i = 0; i < link::MAX_FRAME_BUFFER_SIZE; i++) {
+        queue.poll_dispatch_received_frame(
+            PORT_0, frame::ProtocolNumber::Tunnel, remote, make_reader(fs), time
+        );
+    }
+    CHECK(queue
+              .poll_dispatch_received_frame(
+                  PORT_0, frame::ProtocolNumber::Rpc, remote, make_reader(fs), time
+              )
+              .is_pending());
+
+    time.advance(link::CODEL_TARGET);
+    CHECK(queue
+              .poll_dispatch_received_frame(
+                  PORT_0, frame::ProtocolNumber::Rpc, remote, make_reader(fs), time
+              )
+              .is_ready());
+    CHECK(queue.measurement().dropped_frame_count() == 1);
+    CHECK(queue.poll_receive_frame(frame::ProtocolNumber::Rpc, time).is_ready());
+}
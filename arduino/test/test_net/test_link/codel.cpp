@@ -0,0 +1,60 @@
+#include <doctest.h>
+
+#include <net/link/codel.h>
+
+using namespace net::link;
+
+static util::Instant at(util::MockTime &time, util::TimeDiff ms) {
+    time.set_now_ms(ms);
+    return time.now();
+}
+
+TEST_CASE("no drop below target") {
+    util::MockTime time{0};
+    CoDel codel{};
+    for (util::TimeDiff ms = 0; ms < 5000; ms += 100) {
+        CHECK_FALSE(codel.should_drop(CODEL_TARGET - util::Duration::from_millis(1), at(time, ms)));
+    }
+}
+
+TEST_CASE("drop after target exceeded for an interval") {
+    util::MockTime time{0};
+    CoDel codel{};
+    auto sojourn = CODEL_TARGET * 2;
+
+    CHECK_FALSE(codel.should_drop(sojourn, at(time, 0)));
+    CHECK_FALSE(codel.should_drop(sojourn, at(time, 999)));
+    CHECK(codel.should_drop(sojourn, at(time, 1000)));
+    CHECK(codel.is_dropping());
+
+    // 次の破棄までは CODEL_INTERVAL / sqrt(1) 待つ
+    CHECK_FALSE(codel.should_drop(sojourn, at(time, 1999)));
+    CHECK(codel.should_drop(sojourn, at(time, 2000)));
+
+    // 次の破棄までは CODEL_INTERVAL / sqrt(2) 待つ
+    CHECK_FALSE(codel.should_drop(sojourn, at(time, 2700)));
+    CHECK(codel.should_drop(sojourn, at(time, 2712)));
+}
+
+TEST_CASE("stop dropping when delay falls below target") {
+    util::MockTime time{0};
+    CoDel codel{};
+    auto sojourn = CODEL_TARGET * 2;
+
+    codel.should_drop(sojourn, at(time, 0));
+    CHECK(codel.should_drop(sojourn, at(time, 1000)));
+
+    CHECK_FALSE(codel.should_drop(util::Duration::zero(), at(time, 1001)));
+    CHECK_FALSE(codel.is_dropping());
+    CHECK_FALSE(codel.should_drop(sojourn, at(time, 2000)));
+}
+
+TEST_CASE("reset when queue becomes empty") {
+    util::MockTime time{0};
+    CoDel codel{};
+    auto sojourn = CODEL_TARGET * 2;
+
+    codel.should_drop(sojourn, at(time, 0));
+    codel.on_queue_empty();
+    CHECK_FALSE(codel.should_drop(sojourn, at(time, 1000)));
+}
@@ -0,0 +1,60 @@
+#include <doctest.h>
+
+#include <net/neighbor/suppression.h>
+
+using namespace net;
+
+static const auto WINDOW = util::Duration::from_seconds(10);
+
+static frame::FrameId frame_id(uint16_t value) {
+    util::MockRandom rand{value};
+    return frame::FrameId::random(rand);
+}
+
+static local::LocalNodeConfig config(uint8_t threshold) {
+    return local::LocalNodeConfig{.broadcast_suppression_threshold = threshold};
+}
+
+TEST_CASE("disabled by default") {
+    util::MockTime time{0};
+    util::MockRandom rand{0};
+    auto suppression =
+        neighbor::BroadcastSuppression::start(local::LocalNodeConfig{}, 1, frame_id(1), time, rand);
+    CHECK_FALSE(suppression.has_value());
+}
+
+TEST_CASE("suppress after overhearing enough copies") {
+    util::MockTime time{0};
+    util::MockRandom rand{10}; // 待機時間は10ms
+    frame::DuplicateDetector<4> detector{WINDOW};
+    auto id = frame_id(1);
+    detector.insert_and_check_contains(1, id, time);
+
+    auto suppression = neighbor::BroadcastSuppression::start(config(2), 1, id, time, rand);
+    REQUIRE(suppression.has_value());
+    CHECK(suppression->poll_suppressed(detector, time).is_pending());
+
+    detector.insert_and_check_contains(1, id, time);
+    detector.insert_and_check_contains(1, id, time);
+    time.advance(util::Duration::from_millis(10));
+    auto poll = suppression->poll_suppressed(detector, time);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap());
+}
+
+TEST_CASE("relay when too few copies are overheard") {
+    util::MockTime time{0};
+    util::MockRandom rand{10};
+    frame::DuplicateDetector<4> detector{WINDOW};
+    auto id = frame_id(1);
+    detector.insert_and_check_contains(1, id, time);
+
+    auto suppression = neighbor::BroadcastSuppression::start(config(2), 1, id, time, rand);
+    REQUIRE(suppression.has_value());
+
+    detector.insert_and_check_contains(1, id, time);
+    time.advance(util::Duration::from_millis(10));
+    auto poll = suppression->poll_suppressed(detector, time);
+    REQUIRE(poll.is_ready());
+    CHECK_FALSE(poll.unwrap());
+}
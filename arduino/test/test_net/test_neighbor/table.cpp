@@ -0,0 +1,199 @@
+#include <doctest.h>
+
+#include <net/neighbor/service/table.h>
+
+using namespace net;
+
+static link::Address serial_address(uint8_t body) {
+    return link::Address{link::AddressType::Serial, etl::array<uint8_t, 1>{body}};
+}
+
+static link::Address uhf_address(uint8_t body) {
+    return link::Address{link::AddressType::UHF, etl::array<uint8_t, 1>{body}};
+}
+
+static node::NodeId node_id(uint8_t body) {
+    return node::NodeId{serial_address(body)};
+}
+
+static void add(neighbor::NeighborList &list, uint8_t id, const link::Address &address) {
+    util::MockTime time{0};
+    list.add_neighbor(
+        node_id(id), node::Cost{1}, address, link::MediaPortMask::zero(), time
+    );
+}
+
+TEST_CASE("find neighbor by id") {
+    util::MockTime time{0};
+    neighbor::NeighborList list{time};
+    for (uint8_t i = 1; i <= neighbor::MAX_NEIGHBOR_NODE_COUNT; i++) {
+        add(list, i, serial_address(i));
+    }
+
+    for (uint8_t i = 1; i <= neighbor::MAX_NEIGHBOR_NODE_COUNT; i++) {
+        auto neighbor = list.get_neighbor_node(node_id(i));
+        REQUIRE(neighbor.has_value());
+        CHECK(neighbor->get().id() == node_id(i));
+    }
+    CHECK_FALSE(list.has_neighbor_node(node_id(0xFF)));
+}
+
+TEST_CASE("find neighbor by added address") {
+    util::MockTime time{0};
+    neighbor::NeighborList list{time};
+    add(list, 1, serial_address(1));
+    add(list, 1, uhf_address(10));
+
+    auto neighbor = list.resolve_neighbor_node_from_address(uhf_address(10));
+    REQUIRE(neighbor.has_value());
+    CHECK(neighbor->get().id() == node_id(1));
+    CHECK_FALSE(list.resolve_neighbor_node_from_address(uhf_address(11)).has_value());
+}
+
+TEST_CASE("find neighbor after removal") {
+    util::MockTime time{0};
+    neighbor::NeighborList list{time};
+    notification::NotificationService nts{};
+    add(list, 1, serial_address(1));
+    add(list, 2, serial_address(2));
+    add(list, 3, serial_address(3));
+
+    time.advance(neighbor::NEIGHBOR_EXPIRATION_TIMEOUT);
+    list.delay_expiration(node_id(2), time);
+    list.delay_expiration(node_id(3), time);
+    time.advance(util::Duration::from_millis(1));
+    list.execute(nts, time);
+
+    CHECK_FALSE(list.has_neighbor_node(node_id(1)));
+    CHECK_FALSE(list.resolve_neighbor_node_from_address(serial_address(1)).has_value());
+    for (uint8_t i = 2; i <= 3; i++) {
+        auto neighbor = list.resolve_neighbor_node_from_address(serial_address(i));
+        REQUIRE(neighbor.has_value());
+        CHECK(neighbor->get().id() == node_id(i));
+    }
+}
+
+TEST_CASE("send hello target") {
+    util::MockTime time{0};
+    neighbor::NeighborList list{time};
+    add(list, 1, serial_address(1));
+    add(list, 2, serial_address(2));
+    CHECK(list.poll_send_hello_target(time).is_pending());
+
+    time.advance(neighbor::SEND_HELLO_INTERVAL / 2);
+    list.delay_hello_interval(node_id(2), time);
+
+    time.advance(neighbor::SEND_HELLO_INTERVAL / 2);
+    auto poll = list.poll_send_hello_target(time);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap() == node_id(1));
+    CHECK(list.poll_send_hello_target(time).is_pending());
+
+    time.advance(neighbor::SEND_HELLO_INTERVAL / 2);
+    poll = list.poll_send_hello_target(time);
+    REQUIRE(poll.is_ready());
+    CHECK(poll.unwrap() == node_id(2));
+}
+
+// 各隣接ノードにシリアルとUHFのアドレスを1つずつ持たせた隣接ノード表
+template <uint8_t MAX_COUNT>
+struct FullNeighbors {
+    util::MockTime time{0};
+    nb::TimerWheel<node::NodeId, MAX_COUNT> timers{time, neighbor::NEIGHBOR_TIMER_TICK};
+    neighbor::PointableNeighbors<MAX_COUNT> neighbors{};
+
+    FullNeighbors() {
+        for (uint8_t i = 0; i < MAX_COUNT; i++) {
+            auto id = node_id(i + 1);
+            auto handle = timers.schedule(id, neighbor::NEIGHBOR_EXPIRATION_TIMEOUT, time);
+            REQUIRE(handle.has_value());
+            neighbors.emplace_back_neighbor(
+                id, node::Cost{1}, serial_address(i + 1), link::MediaPortMask::zero(),
+                neighbor::NeighborNodeTimer{*handle, *handle}
+            );
+            neighbors.update_neighbor_address(i, uhf_address(i + 1), link::MediaPortMask::zero());
+        }
+    }
+};
+
+template <uint8_t MAX_COUNT>
+static void check_find_every_address() {
+    FullNeighbors<MAX_COUNT> table{};
+    for (uint8_t i = 1; i <= MAX_COUNT; i++) {
+        for (const auto &address : {serial_address(i), uhf_address(i)}) {
+            auto neighbor = table.neighbors.find_by_address(address);
+            REQUIRE(neighbor.has_value());
+            CHECK(neighbor->get().id() == node_id(i));
+        }
+    }
+    CHECK_FALSE(table.neighbors.find_by_address(uhf_address(0xFF)).has_value());
+}
+
+TEST_CASE("find every address of a full neighbor table") {
+    check_find_every_address<10>();
+    check_find_every_address<32>();
+
+    // アドレスの索引に収まらない分は線形探索で見つかる
+    check_find_every_address<64>();
+}
+
+struct AddressLookupCost {
+    // 1回の検索でアドレスを照合した隣接ノードの数の平均
+    float indexed;
+    float linear;
+};
+
+// 隣接ノード表と同じ大きさの索引で，全アドレスを検索したときの照合回数を数える
+template <uint8_t MAX_COUNT>
+static AddressLookupCost measure_address_lookup() {
+    constexpr uint8_t capacity = neighbor::neighbor_address_index_capacity<MAX_COUNT>();
+    tl::IndexTable<tl::index_table_slot_count<capacity>()> index;
+
+    etl::vector<link::Address, MAX_COUNT * 2> addresses;
+    for (uint8_t i = 1; i <= MAX_COUNT; i++) {
+        addresses.push_back(serial_address(i));
+        addresses.push_back(uhf_address(i));
+    }
+    auto owner = [](uint8_t address_index) { return address_index / 2; };
+
+    bool overflowed = false;
+    for (uint8_t i = 0; i < addresses.size(); i++) {
+        if (index.size() >= capacity) {
+            overflowed = true;
+            continue;
+        }
+        index.insert(addresses[i].hash(), owner(i));
+    }
+
+    uint32_t indexed = 0;
+    uint32_t linear = 0;
+    for (uint8_t i = 0; i < addresses.size(); i++) {
+        auto matches = [&](uint8_t neighbor) {
+            indexed++;
+            return neighbor == owner(i);
+        };
+        auto found = index.find(addresses[i].hash(), matches);
+        if (!found.has_value()) {
+            CHECK(overflowed);
+            indexed += owner(i) + 1;
+        }
+        linear += owner(i) + 1;
+    }
+
+    float count = addresses.size();
+    return AddressLookupCost{indexed / count, linear / count};
+}
+
+TEST_CASE("address lookup cost of 10, 32 and 64 neighbors") {
+    auto small = measure_address_lookup<10>();
+    auto medium = measure_address_lookup<32>();
+    auto large = measure_address_lookup<64>();
+
+    // 索引に収まる場合は隣接ノード数によらずほぼ定数回で見つかる
+    CHECK(small.indexed < 2);
+    CHECK(medium.indexed < 2);
+    CHECK(medium.linear > 16);
+
+    // 索引に収まらないアドレスは線形探索になるが，全体としては線形探索より少ない
+    CHECK(large.indexed < large.linear / 2);
+}
@@ -0,0 +1,34 @@
+#include <doctest.h>
+
+#include "../network.h"
+
+using namespace net;
+
+TEST_CASE("relays waiting for assessment leave room for other broadcasts") {
+    // A - B - C の直線状のネットワークで，Bは中継を取りやめるかを判定してから中継する
+    Network<3> net;
+    net.connect(0, 1);
+    net.connect(1, 2);
+    net[1].lns.update_config(local::LocalNodeConfig{
+        .broadcast_suppression_threshold = 7,
+        .broadcast_assessment_delay = 3,
+    });
+
+    // 送信タスクの数より多くのブロードキャストを，Bが判定を終える前に届ける
+    constexpr uint8_t count = routing::DEFAULT_TASK_POOL_SIZE + 1;
+    uint8_t sent = 0;
+    CHECK(net.run_until([&]() {
+        if (sent < count && net[0].try_send(node::Destination::broadcast(), net.time, net.rand)) {
+            sent++;
+        }
+        return net[1].received_count == count;
+    }));
+    CHECK(net[2].received_count == 0);
+
+    // 判定を待つ中継があっても，B自身のブロードキャストを送信できる
+    CHECK(net[1].try_send(node::Destination::broadcast(), net.time, net.rand).has_value());
+
+    // 判定を待った中継はどれも破棄されずに送信される
+    CHECK(net.run_until([&]() { return net[2].received_count >= count; }));
+    CHECK(net[1].socket.dropped_relay_count() == 0);
+}
@@ -0,0 +1,62 @@
+#include <doctest.h>
+
+#include "../network.h"
+
+using namespace net;
+
+static uint8_t total_in_use(const frame::FrameService &fs) {
+    uint8_t in_use = 0;
+    for (const auto &stats : fs.pool_stats()) {
+        in_use += stats.in_use;
+    }
+    return in_use;
+}
+
+TEST_CASE("relay frame without allocating new buffer") {
+    // A - B - C の直線状のネットワークで，BがAからCへのフレームを中継する
+    Network<3> net;
+    net.connect(0, 1);
+    net.connect(1, 2);
+    auto &a = net[0];
+    auto &b = net[1];
+    auto &c = net[2];
+
+    // 先に経路探索を済ませ，中継の間にBが他のフレームを確保しないようにする
+    auto warm_up = a.send_to(c.id(), net.time, net.rand);
+    CHECK(net.wait(warm_up).has_value());
+    CHECK(net.run_until([&]() { return c.received_count == 1; }));
+    net.run_for(util::Duration::from_millis(100));
+    c.drains_received_frames = false;
+
+    // フレーム全体がMTUの長さになるペイロードを送る
+    auto destination = node::Destination::node(c.id());
+    auto length = a.socket.max_payload_length(a.lns.poll_info().unwrap().source, destination);
+    auto poll_writer = a.socket.poll_frame_writer(a.fs, a.lns, net.rand, destination, length);
+    REQUIRE(poll_writer.is_ready());
+    auto &writer = poll_writer.unwrap();
+    for (uint8_t i = 0; !writer.is_all_written(); i++) {
+        writer.write_unchecked(i);
+    }
+    auto poll_future = a.socket.poll_send_frame(destination, writer.create_reader());
+    REQUIRE(poll_future.is_ready());
+
+    // 中継の間も，Bのバッファプールの使用数は増えない
+    uint8_t in_use = total_in_use(b.fs);
+    uint8_t max_in_use = in_use;
+    nb::Poll<routing::RoutingFrame> poll_frame = nb::pending;
+    CHECK(net.run_until([&]() {
+        max_in_use = etl::max(max_in_use, total_in_use(b.fs));
+        poll_frame = c.socket.poll_receive_frame();
+        return poll_frame.is_ready();
+    }));
+    CHECK_EQ(max_in_use, in_use);
+    CHECK_EQ(total_in_use(b.fs), in_use);
+
+    // 中継されたペイロードは，送信したものと一致する
+    REQUIRE(poll_frame.is_ready());
+    auto &payload = poll_frame.unwrap().payload;
+    CHECK_EQ(payload.readable_length(), length);
+    for (uint8_t i = 0; i < length; i++) {
+        CHECK_EQ(payload.read_unchecked(), i);
+    }
+}
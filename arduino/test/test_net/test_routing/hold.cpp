@@ -0,0 +1,83 @@
+#include <doctest.h>
+
+#include "../network.h"
+
+using namespace net;
+
+using SendFutures = etl::vector<nb::Future<routing::SendResult>, routing::HOLDING_FRAME_QUEUE_SIZE>;
+
+// 経路探索を待つフレームとして保持できるだけ，`to`宛てのフレームを送信する
+template <uint8_t N>
+static SendFutures send_held_frames(Network<N> &net, uint8_t from, uint8_t to) {
+    SendFutures futures;
+    while (auto opt_future = net[from].try_send_to(net[to].id(), net.time, net.rand)) {
+        futures.push_back(etl::move(*opt_future));
+    }
+    return futures;
+}
+
+TEST_CASE("flush held frames together when the gateway is found") {
+    // A - B - C の直線状のネットワーク
+    Network<3> net;
+    net.connect(0, 1);
+    net.connect(1, 2);
+
+    auto futures = send_held_frames(net, 0, 2);
+    REQUIRE(futures.size() > 1);
+    for (auto &future : futures) {
+        CHECK(future.poll().is_pending());
+    }
+
+    // ゲートウェイが見つかると，保持していたフレームを続けて送信する
+    CHECK(net.run_until([&]() { return futures[0].poll().is_ready(); }));
+    auto resolved = net.time.now();
+    CHECK(net.run_until([&]() { return futures.back().poll().is_ready(); }));
+    CHECK(net.time.now() - resolved < util::Duration::from_millis(futures.size()));
+    for (auto &future : futures) {
+        auto poll = future.poll();
+        REQUIRE(poll.is_ready());
+        CHECK(poll.unwrap().get().has_value());
+    }
+    CHECK(net.run_until([&]() { return net[2].received_count == futures.size(); }));
+}
+
+TEST_CASE("fail held frames when discovery expires") {
+    // A - B と，どこにもつながっていないC
+    Network<3> net;
+    net.connect(0, 1);
+
+    auto start = net.time.now();
+    auto futures = send_held_frames(net, 0, 2);
+    REQUIRE(futures.size() > 1);
+
+    CHECK(net.run_until([&]() { return futures[0].poll().is_ready(); }));
+    CHECK(net.time.now() - start >= discovery::DISCOVERY_FIRST_RESPONSE_TIMEOUT);
+    for (auto &future : futures) {
+        auto poll = future.poll();
+        REQUIRE(poll.is_ready());
+        auto &result = poll.unwrap().get();
+        REQUIRE_FALSE(result.has_value());
+        CHECK(result.error() == neighbor::SendError::UnreachableNode);
+    }
+}
+
+TEST_CASE("held frames to the same destination share one discovery") {
+    // A - B - C の直線状のネットワークで，AからCへ1つだけ送信した場合と比べる
+    Network<3> single;
+    single.connect(0, 1);
+    single.connect(1, 2);
+    auto future = single[0].send_to(single[2].id(), single.time, single.rand);
+    CHECK(single.wait(future).has_value());
+    auto single_discover_count = single.sent_count_of(frame::ProtocolNumber::Discover);
+    CHECK(single_discover_count > 0);
+
+    Network<3> net;
+    net.connect(0, 1);
+    net.connect(1, 2);
+    auto futures = send_held_frames(net, 0, 2);
+    REQUIRE(futures.size() > 1);
+    for (auto &future : futures) {
+        CHECK(net.wait(future).has_value());
+    }
+    CHECK(net.sent_count_of(frame::ProtocolNumber::Discover) == single_discover_count);
+}
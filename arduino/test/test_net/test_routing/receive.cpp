@@ -0,0 +1,130 @@
+#include <doctest.h>
+
+#include "../network.h"
+#include <net/rpc/constants.h>
+
+using namespace net;
+
+TEST_CASE("a received frame lifts the discovery backoff for its source") {
+    Network<3> net;
+    net.connect(0, 1);
+    auto c = net[2].id();
+
+    // Cとつながっていない間に経路探索を繰り返し失敗させ，抑制時間を伸ばす
+    for (uint8_t i = 0; i < 4; i++) {
+        auto future = net[0].send_to(c, net.time, net.rand);
+        CHECK_FALSE(net.wait(future).has_value());
+        if (i < 3) {
+            net.run_for(discovery::NEGATIVE_CACHE_BASE_BACKOFF * (1 << i));
+        }
+    }
+
+    // CからAへ送信すると，AはCに到達できることを知る
+    net.connect(1, 2);
+    auto from_c = net[2].send_to(net[0].id(), net.time, net.rand);
+    CHECK(net.wait(from_c).has_value());
+    CHECK(net.run_until([&]() { return net[0].received_count == 1; }));
+
+    // 逆経路のキャッシュが消えた後も，抑制されずに経路探索できる
+    net.run_for(discovery::DISCOVERY_CACHE_EXPIRATION + discovery::NEGATIVE_CACHE_BASE_BACKOFF);
+    net[0].ds.reset_suppressed_discovery_count();
+    auto to_c = net[0].send_to(c, net.time, net.rand);
+    CHECK(net.wait(to_c).has_value());
+    CHECK(net[0].ds.suppressed_discovery_count() == 0);
+}
+
+TEST_CASE("reverse path avoids discovery on the return path") {
+    // A - B - C - D の直線状のネットワーク
+    Network<4> net;
+    net.connect(0, 1);
+    net.connect(1, 2);
+    net.connect(2, 3);
+
+    auto request = net[0].send_to(net[3].id(), net.time, net.rand);
+    CHECK(net.wait(request).has_value());
+    CHECK(net.run_until([&]() { return net[3].received_count == 1; }));
+    auto discover_count = net.sent_count_of(frame::ProtocolNumber::Discover);
+    CHECK(discover_count > 0);
+
+    // 応答は要求が通った経路を逆に辿るため，経路探索を行わない
+    auto response = net[3].send_to(net[0].id(), net.time, net.rand);
+    CHECK(net.wait(response).has_value());
+    CHECK(net.run_until([&]() { return net[0].received_count == 1; }));
+    CHECK(net.sent_count_of(frame::ProtocolNumber::Discover) == discover_count);
+}
+
+TEST_CASE("an unreachable destination does not stall receiving or relaying") {
+    // A - B - C の直線状のネットワークと，どこにもつながっていないD, E
+    Network<5> net;
+    net.connect(0, 1);
+    net.connect(1, 2);
+
+    // BはD, E宛てのフレームを保持できるだけ保持し，経路探索の完了を待ち続ける
+    etl::vector<nb::Future<routing::SendResult>, routing::HOLDING_FRAME_QUEUE_SIZE> unreachable;
+    unreachable.push_back(net[1].send_to(net[4].id(), net.time, net.rand));
+    while (auto opt_future = net[1].try_send_to(net[3].id(), net.time, net.rand)) {
+        unreachable.push_back(etl::move(*opt_future));
+    }
+    REQUIRE(unreachable.size() > 1);
+
+    // その間も，B宛てのフレームの受信と，Cへのフレームの中継は進む
+    auto to_b = net[0].send_to(net[1].id(), net.time, net.rand);
+    auto to_c = net[0].send_to(net[2].id(), net.time, net.rand);
+    CHECK(net.run_until(
+        [&]() { return net[1].received_count == 1 && net[2].received_count == 1; },
+        discovery::DISCOVERY_FIRST_RESPONSE_TIMEOUT / 2
+    ));
+    CHECK(to_b.poll().is_ready());
+    CHECK(to_c.poll().is_ready());
+    for (auto &future : unreachable) {
+        CHECK(future.poll().is_pending());
+    }
+    CHECK(net[1].socket.dropped_relay_count() == 0);
+}
+
+// 取り出されないまま`ACCEPTED_FRAME_QUEUE_SIZE`個より多くのフレームを受信させる
+template <uint8_t ACCEPTED_FRAME_QUEUE_SIZE, typename Socket>
+static void check_accepted_frame_overflow() {
+    Network<2, Socket> net;
+    net.connect(0, 1);
+    net[1].drains_received_frames = false;
+
+    constexpr uint8_t count = ACCEPTED_FRAME_QUEUE_SIZE + 1;
+    for (uint8_t i = 0; i < count; i++) {
+        etl::optional<nb::Future<routing::SendResult>> opt_future;
+        CHECK(net.run_until([&]() {
+            opt_future = net[0].try_send_to(net[1].id(), net.time, net.rand, i);
+            return opt_future.has_value();
+        }));
+        CHECK(net.wait(*opt_future).has_value());
+
+        // 受信側のディレイキューで溢れないよう，1つずつ届ける
+        net.run_for(util::Duration::from_millis(100));
+    }
+    CHECK(net[1].socket.dropped_frame_count() == 1);
+
+    // 先に届いた`ACCEPTED_FRAME_QUEUE_SIZE`個のフレームが，届いた順に取り出せる
+    for (uint8_t i = 0; i < ACCEPTED_FRAME_QUEUE_SIZE; i++) {
+        auto poll_frame = net[1].socket.poll_receive_frame();
+        REQUIRE(poll_frame.is_ready());
+        CHECK(poll_frame.unwrap().payload.read_unchecked() == i);
+    }
+    CHECK(net[1].socket.poll_receive_frame().is_pending());
+}
+
+TEST_CASE("frames beyond the accepted frame queue are dropped and counted") {
+    check_accepted_frame_overflow<
+        routing::DEFAULT_ACCEPTED_FRAME_QUEUE_SIZE,
+        routing::RoutingSocket<NETWORK_FRAME_DELAY_POOL_SIZE>>();
+}
+
+TEST_CASE("the rpc socket accepts more frames than the default") {
+    static_assert(rpc::ACCEPTED_FRAME_QUEUE_SIZE > routing::DEFAULT_ACCEPTED_FRAME_QUEUE_SIZE);
+
+    // `rpc::RpcSocket`と同じ構成のソケット
+    using RpcSocket = routing::RoutingSocket<
+        rpc::FRAME_DELAY_POOL_SIZE,
+        routing::DEFAULT_TASK_POOL_SIZE,
+        rpc::ACCEPTED_FRAME_QUEUE_SIZE>;
+    check_accepted_frame_overflow<rpc::ACCEPTED_FRAME_QUEUE_SIZE, RpcSocket>();
+}
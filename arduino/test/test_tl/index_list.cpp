@@ -0,0 +1,47 @@
+#include <doctest.h>
+
+#include <tl/index_list.h>
+
+using namespace tl;
+
+TEST_CASE("push and pop in order") {
+    IndexList<4> list{};
+    CHECK(list.empty());
+    CHECK(list.front() == etl::nullopt);
+
+    list.push_back(2);
+    list.push_back(0);
+    list.push_back(3);
+    CHECK(list.size() == 3);
+
+    CHECK(list.pop_front() == etl::optional<uint8_t>{2});
+    CHECK(list.pop_front() == etl::optional<uint8_t>{0});
+    CHECK(list.pop_front() == etl::optional<uint8_t>{3});
+    CHECK(list.pop_front() == etl::nullopt);
+}
+
+TEST_CASE("remove from middle") {
+    IndexList<4> list{};
+    for (uint8_t i = 0; i < 4; i++) {
+        list.push_back(i);
+    }
+
+    list.remove(1);
+    list.remove(3);
+    CHECK(list.size() == 2);
+    CHECK(list.pop_front() == etl::optional<uint8_t>{0});
+    CHECK(list.pop_front() == etl::optional<uint8_t>{2});
+}
+
+TEST_CASE("move to back") {
+    IndexList<3> list{};
+    for (uint8_t i = 0; i < 3; i++) {
+        list.push_back(i);
+    }
+
+    list.move_to_back(0);
+    uint8_t expected[] = {1, 2, 0};
+    uint8_t n = 0;
+    list.for_each([&](uint8_t index) { CHECK(index == expected[n++]); });
+    CHECK(n == 3);
+}
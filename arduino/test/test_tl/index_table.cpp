@@ -0,0 +1,57 @@
+#include <doctest.h>
+
+#include <tl/index_table.h>
+
+using namespace tl;
+
+TEST_CASE("slot count") {
+    CHECK(index_table_slot_count<1>() == 2);
+    CHECK(index_table_slot_count<3>() == 4);
+    CHECK(index_table_slot_count<10>() == 16);
+    CHECK(index_table_slot_count<20>() == 32);
+    CHECK(index_table_slot_count<96>() == 128);
+}
+
+TEST_CASE("find empty") {
+    IndexTable<4> table{};
+    CHECK(table.find(0, [](uint8_t) { return true; }) == etl::nullopt);
+}
+
+TEST_CASE("insert and find") {
+    IndexTable<4> table{};
+    table.insert(1, 0);
+    table.insert(2, 1);
+    CHECK(table.size() == 2);
+
+    CHECK(table.find(1, [](uint8_t i) { return i == 0; }) == etl::optional<uint8_t>{0});
+    CHECK(table.find(2, [](uint8_t i) { return i == 1; }) == etl::optional<uint8_t>{1});
+    CHECK(table.find(3, [](uint8_t i) { return i == 0; }) == etl::nullopt);
+}
+
+TEST_CASE("find colliding hash") {
+    IndexTable<4> table{};
+    table.insert(5, 0);
+    table.insert(5, 1);
+    table.insert(5, 2);
+
+    CHECK(table.find(5, [](uint8_t i) { return i == 2; }) == etl::optional<uint8_t>{2});
+    CHECK(table.find(5, [](uint8_t i) { return i == 3; }) == etl::nullopt);
+}
+
+TEST_CASE("find in full table") {
+    IndexTable<2> table{};
+    table.insert(0, 0);
+    table.insert(0, 1);
+    CHECK(table.full());
+
+    CHECK(table.find(1, [](uint8_t i) { return i == 0; }) == etl::optional<uint8_t>{0});
+    CHECK(table.find(1, [](uint8_t i) { return i == 2; }) == etl::nullopt);
+}
+
+TEST_CASE("clear") {
+    IndexTable<4> table{};
+    table.insert(1, 0);
+    table.clear();
+    CHECK(table.size() == 0);
+    CHECK(table.find(1, [](uint8_t) { return true; }) == etl::nullopt);
+}
@@ -0,0 +1,62 @@
+#include <doctest.h>
+
+#include <tl/queue_set.h>
+
+using namespace tl;
+
+TEST_CASE("push and pop in fifo order") {
+    QueueSet<uint8_t, 4, 2> queues{};
+    queues.emplace_back(0, 1);
+    queues.emplace_back(0, 2);
+    queues.emplace_back(1, 3);
+
+    CHECK(queues.size() == 3);
+    CHECK(queues.front(0) == 1);
+    CHECK(queues.pop_front(0) == 1);
+    CHECK(queues.pop_front(0) == 2);
+    CHECK(queues.empty(0));
+    CHECK(queues.pop_front(1) == 3);
+    CHECK(queues.size() == 0);
+}
+
+TEST_CASE("queues share capacity") {
+    QueueSet<uint8_t, 2, 2> queues{};
+    queues.emplace_back(0, 1);
+    queues.emplace_back(1, 2);
+    CHECK(queues.full());
+
+    queues.pop_front(0);
+    CHECK_FALSE(queues.full());
+    queues.emplace_back(1, 3);
+    CHECK(queues.pop_front(1) == 2);
+    CHECK(queues.pop_front(1) == 3);
+}
+
+TEST_CASE("pop first if") {
+    QueueSet<uint8_t, 4, 1> queues{};
+    queues.emplace_back(0, 1);
+    queues.emplace_back(0, 2);
+    queues.emplace_back(0, 3);
+
+    CHECK(queues.pop_first_if(0, [](uint8_t v) { return v == 4; }) == etl::nullopt);
+    CHECK(*queues.find_first_if(0, [](uint8_t v) { return v >= 2; }) == 2);
+
+    CHECK(queues.pop_first_if(0, [](uint8_t v) { return v == 3; }) == etl::optional<uint8_t>{3});
+    queues.emplace_back(0, 4);
+    CHECK(queues.pop_first_if(0, [](uint8_t v) { return v == 2; }) == etl::optional<uint8_t>{2});
+    CHECK(queues.pop_front(0) == 1);
+    CHECK(queues.pop_front(0) == 4);
+    CHECK(queues.empty(0));
+}
+
+TEST_CASE("pop back") {
+    QueueSet<uint8_t, 4, 1> queues{};
+    queues.emplace_back(0, 1);
+    queues.emplace_back(0, 2);
+
+    CHECK(queues.pop_back(0) == 2);
+    queues.emplace_back(0, 3);
+    CHECK(queues.pop_back(0) == 3);
+    CHECK(queues.pop_back(0) == 1);
+    CHECK(queues.empty(0));
+}
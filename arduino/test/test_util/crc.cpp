@@ -0,0 +1,22 @@
+#include <doctest.h>
+
+#include <util/crc.h>
+
+TEST_CASE("CRC-16/CCITT-FALSE check value") {
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    util::Crc16 crc;
+    crc.update(etl::span<const uint8_t>{data, sizeof(data)});
+    CHECK(crc.value() == 0x29B1);
+}
+
+TEST_CASE("update byte by byte") {
+    const uint8_t data[] = {0x00, 0xFF, 0x55, 0xAA};
+    util::Crc16 bulk;
+    bulk.update(etl::span<const uint8_t>{data, sizeof(data)});
+
+    util::Crc16 incremental;
+    for (uint8_t byte : data) {
+        incremental.update(byte);
+    }
+    CHECK(incremental.value() == bulk.value());
+}
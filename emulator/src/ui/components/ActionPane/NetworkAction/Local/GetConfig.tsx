@@ -1,4 +1,4 @@
-import { Config, RpcStatus } from "@core/net";
+import { Config, ConfigFlag, RpcStatus } from "@core/net";
 import { ActionContext } from "@emulator/ui/contexts/actionContext";
 import { NetContext } from "@emulator/ui/contexts/netContext";
 import { Stack, TableContainer, Table, TableHead, TableRow, TableCell, TableBody } from "@mui/material";
@@ -13,12 +13,16 @@ export const GetConfig: React.FC = () => {
     const rows =
         config === undefined
             ? undefined
-            : Object.values(Config)
-                  .filter((key): key is number => typeof key === "number")
-                  .map((key) => ({
-                      name: Config[key],
-                      value: (config & key) !== 0 ? "true" : "false",
-                  }));
+            : [
+                  ...Object.values(ConfigFlag)
+                      .filter((key): key is number => typeof key === "number")
+                      .map((key) => ({
+                          name: ConfigFlag[key],
+                          value: (config.flags & key) !== 0 ? "true" : "false",
+                      })),
+                  { name: "broadcastSuppressionThreshold", value: `${config.broadcastSuppressionThreshold}` },
+                  { name: "broadcastAssessmentDelay", value: `${config.broadcastAssessmentDelay}` },
+              ];
 
     const getConfig = async () => {
         const result = await net.rpc().requestGetConfig(target);
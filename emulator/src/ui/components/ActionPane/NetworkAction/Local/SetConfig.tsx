@@ -1,29 +1,36 @@
-import { Config, RpcResult } from "@core/net";
+import {
+    Config,
+    ConfigFlag,
+    DEFAULT_CONFIG,
+    MAX_BROADCAST_ASSESSMENT_DELAY,
+    MAX_BROADCAST_SUPPRESSION_THRESHOLD,
+    RpcResult,
+} from "@core/net";
 import { ActionContext } from "@emulator/ui/contexts/actionContext";
 import { NetContext } from "@emulator/ui/contexts/netContext";
 import { useContext, useState } from "react";
 import { ActionRpcForm } from "../../ActionTemplates";
-import { Checkbox, FormControlLabel } from "@mui/material";
+import { Checkbox, FormControlLabel, TextField } from "@mui/material";
 
-const configs: Config[] = Object.values(Config).filter((v): v is number => typeof v === "number");
+const flags: ConfigFlag[] = Object.values(ConfigFlag).filter((v): v is number => typeof v === "number");
 
 export const SetConfig: React.FC = () => {
     const net = useContext(NetContext);
     const { target } = useContext(ActionContext);
 
-    const [config, setConfig] = useState<Config | 0>(0);
+    const [config, setConfig] = useState<Config>(DEFAULT_CONFIG);
     const setConfigAction = async (): Promise<RpcResult<unknown>> => {
         return net.rpc().requestSetConfig(target, config);
     };
 
-    const onChange = (c: Config) => (e: React.ChangeEvent<HTMLInputElement>) => {
-        e.target.checked ? setConfig(config | c) : setConfig(config & ~c);
+    const onChange = (f: ConfigFlag) => (e: React.ChangeEvent<HTMLInputElement>) => {
+        setConfig({ ...config, flags: e.target.checked ? config.flags | f : config.flags & ~f });
     };
 
-    const selection = configs.map((c) => ({
-        name: Config[c],
-        value: c,
-        checked: (config & c) !== 0,
+    const selection = flags.map((f) => ({
+        name: ConfigFlag[f],
+        value: f,
+        checked: (config.flags & f) !== 0,
     }));
 
     return (
@@ -35,6 +42,22 @@ export const SetConfig: React.FC = () => {
                     label={c.name}
                 />
             ))}
+            <TextField
+                type="number"
+                label="broadcastSuppressionThreshold"
+                fullWidth
+                value={config.broadcastSuppressionThreshold}
+                inputProps={{ min: 0, max: MAX_BROADCAST_SUPPRESSION_THRESHOLD }}
+                onChange={(e) => setConfig({ ...config, broadcastSuppressionThreshold: parseInt(e.target.value) })}
+            />
+            <TextField
+                type="number"
+                label="broadcastAssessmentDelay"
+                fullWidth
+                value={config.broadcastAssessmentDelay}
+                inputProps={{ min: 0, max: MAX_BROADCAST_ASSESSMENT_DELAY }}
+                onChange={(e) => setConfig({ ...config, broadcastAssessmentDelay: parseInt(e.target.value) })}
+            />
         </ActionRpcForm>
     );
 };
@@ -21,6 +21,8 @@ export enum FrameType {
 export enum Procedure {
     // Debug 1~99
     Blink = 1,
+    GetFrameBufferPoolStats = 10,
+    ResetFrameBufferPoolStats = 11,
 
     // Media 100~199
     GetMediaList = 100,
@@ -37,6 +39,7 @@ export enum Procedure {
 
     // Serial 400~499
     SetAddress = 400,
+    NegotiateBaudRate = 401,
 
     // Ethernet 500~599
     SetEthernetIpAddress = 500,
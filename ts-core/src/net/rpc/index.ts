@@ -1,6 +1,12 @@
 export * from "./service";
 export * from "./procedures/handler";
-export { BlinkOperation, Config } from "./procedures";
-export type { MediaInfo } from "./procedures";
+export {
+    BlinkOperation,
+    ConfigFlag,
+    DEFAULT_CONFIG,
+    MAX_BROADCAST_ASSESSMENT_DELAY,
+    MAX_BROADCAST_SUPPRESSION_THRESHOLD,
+} from "./procedures";
+export type { Config, MediaInfo } from "./procedures";
 export * from "./frame";
 export * from "./request";
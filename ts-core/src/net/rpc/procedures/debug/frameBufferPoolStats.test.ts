@@ -0,0 +1,76 @@
+import { BufferReader } from "@core/net/buffer";
+import { LocalNodeService } from "@core/net/local";
+import { Destination, NodeId, Source } from "@core/net/node";
+import { FrameType, Procedure, RpcRequest, RpcResponse, RpcStatus } from "../../frame";
+import * as GetFrameBufferPoolStats from "./getFrameBufferPoolStats";
+import * as ResetFrameBufferPoolStats from "./resetFrameBufferPoolStats";
+
+const localNodeService = { getSource: async () => Source.loopback() } as unknown as LocalNodeService;
+const destination = Destination.fromNodeId(NodeId.loopback());
+
+const createResponse = (request: RpcRequest, status: RpcStatus, body: number[] = []): RpcResponse => ({
+    frameType: FrameType.Response,
+    procedure: request.procedure,
+    requestId: request.requestId,
+    status,
+    bodyReader: new BufferReader(new Uint8Array(body)),
+});
+
+describe("GetFrameBufferPoolStats", () => {
+    it("requests the stats with an empty body", async () => {
+        const client = new GetFrameBufferPoolStats.Client({ localNodeService });
+        const [request] = await client.createRequest(destination);
+        expect(request.procedure).toBe(Procedure.GetFrameBufferPoolStats);
+        expect(request.bodyReader.remainingLength()).toBe(0);
+    });
+
+    it("deserializes the stats of every size class", async () => {
+        const client = new GetFrameBufferPoolStats.Client({ localNodeService });
+        const [request, result] = await client.createRequest(destination);
+        // prettier-ignore
+        client.handleResponse(createResponse(request, RpcStatus.Success, [
+            2,
+            32, 8, 3, 5, 0x02, 0x01, 0x00, 0x00,
+            128, 4, 0, 1, 0x00, 0x00, 0x07, 0x00,
+        ]));
+        expect(await result).toEqual({
+            status: RpcStatus.Success,
+            value: [
+                { bufferLength: 32, capacity: 8, inUse: 3, highWaterMark: 5, failedCount: 0x0102, fallbackCount: 0 },
+                { bufferLength: 128, capacity: 4, inUse: 0, highWaterMark: 1, failedCount: 0, fallbackCount: 7 },
+            ],
+        });
+    });
+
+    it("fails on a truncated body", async () => {
+        const client = new GetFrameBufferPoolStats.Client({ localNodeService });
+        const [request, result] = await client.createRequest(destination);
+        client.handleResponse(createResponse(request, RpcStatus.Success, [1, 32, 8]));
+        expect(await result).toEqual({ status: RpcStatus.Failed });
+    });
+
+    it("passes through the status of a failed response", async () => {
+        const client = new GetFrameBufferPoolStats.Client({ localNodeService });
+        const [request, result] = await client.createRequest(destination);
+        client.handleResponse(createResponse(request, RpcStatus.NotSupported));
+        expect(await result).toEqual({ status: RpcStatus.NotSupported });
+    });
+});
+
+describe("ResetFrameBufferPoolStats", () => {
+    it("resolves on success", async () => {
+        const client = new ResetFrameBufferPoolStats.Client({ localNodeService });
+        const [request, result] = await client.createRequest(destination);
+        expect(request.procedure).toBe(Procedure.ResetFrameBufferPoolStats);
+
+        client.handleResponse(createResponse(request, RpcStatus.Success));
+        expect(await result).toEqual({ status: RpcStatus.Success, value: undefined });
+    });
+
+    it("passes through the status of a failed response", async () => {
+        const client = new ResetFrameBufferPoolStats.Client({ localNodeService });
+        const [request, result] = await client.createRequest(destination);
+        client.handleResponse(createResponse(request, RpcStatus.Busy));
+        expect(await result).toEqual({ status: RpcStatus.Busy });
+    });
+});
@@ -0,0 +1,48 @@
+import { Destination } from "@core/net/node";
+import { Procedure, RpcRequest, RpcResponse, RpcStatus } from "../../frame";
+import { RequestManager, RpcResult } from "../../request";
+import { RpcClient } from "../handler";
+import { LocalNodeService } from "@core/net/local";
+import { ObjectSerdeable, SerdeableValue, Uint16Serdeable, Uint8Serdeable, VectorSerdeable } from "@core/serde";
+
+const frameBufferPoolStatsSerdeable = new ObjectSerdeable({
+    bufferLength: new Uint8Serdeable(),
+    capacity: new Uint8Serdeable(),
+    inUse: new Uint8Serdeable(),
+    highWaterMark: new Uint8Serdeable(),
+    // 確保できていた状態から枯渇した回数
+    failedCount: new Uint16Serdeable(),
+    // 枯渇のため，より大きいサイズクラスから借りて確保した回数
+    fallbackCount: new Uint16Serdeable(),
+});
+
+export type FrameBufferPoolStats = SerdeableValue<typeof frameBufferPoolStatsSerdeable>;
+
+// サイズクラスの小さい順に並ぶ
+const resultSerdeable = new VectorSerdeable(frameBufferPoolStatsSerdeable);
+
+export class Client implements RpcClient<FrameBufferPoolStats[]> {
+    #requestManager: RequestManager<FrameBufferPoolStats[]>;
+
+    constructor({ localNodeService }: { localNodeService: LocalNodeService }) {
+        this.#requestManager = new RequestManager({ procedure: Procedure.GetFrameBufferPoolStats, localNodeService });
+    }
+
+    createRequest(destination: Destination): Promise<[RpcRequest, Promise<RpcResult<FrameBufferPoolStats[]>>]> {
+        return this.#requestManager.createRequest(destination);
+    }
+
+    handleResponse(response: RpcResponse): void {
+        if (response.status !== RpcStatus.Success) {
+            this.#requestManager.resolveFailure(response.requestId, response.status);
+            return;
+        }
+
+        const stats = resultSerdeable.deserializer().deserialize(response.bodyReader);
+        if (stats.isOk()) {
+            this.#requestManager.resolveSuccess(response.requestId, stats.unwrap());
+        } else {
+            this.#requestManager.resolveFailure(response.requestId, RpcStatus.Failed);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+import { Destination } from "@core/net/node";
+import { Procedure, RpcRequest, RpcResponse } from "../../frame";
+import { RequestManager, RpcResult } from "../../request";
+import { RpcClient } from "../handler";
+import { LocalNodeService } from "@core/net/local";
+
+export class Client implements RpcClient<void> {
+    #requestManager: RequestManager<void>;
+
+    constructor({ localNodeService }: { localNodeService: LocalNodeService }) {
+        this.#requestManager = new RequestManager({ procedure: Procedure.ResetFrameBufferPoolStats, localNodeService });
+    }
+
+    createRequest(destination: Destination): Promise<[RpcRequest, Promise<RpcResult<void>>]> {
+        return this.#requestManager.createRequest(destination);
+    }
+
+    handleResponse(response: RpcResponse): void {
+        this.#requestManager.resolveVoid(response);
+    }
+}
@@ -1,9 +1,16 @@
 export type { RpcServer } from "./handler";
 export { BlinkOperation } from "./debug/blink";
+export type { FrameBufferPoolStats } from "./debug/getFrameBufferPoolStats";
 export type { MediaInfo } from "./media/getMediaList";
 export type { SetEthernetIpAddressParam } from "./ethernet/setEthernetIpAddress";
 export type { SetEthernetSubnetMaskParam } from "./ethernet/setEthernetSubnetMask";
-export { Config } from "./local/config";
+export {
+    ConfigFlag,
+    DEFAULT_CONFIG,
+    MAX_BROADCAST_ASSESSMENT_DELAY,
+    MAX_BROADCAST_SUPPRESSION_THRESHOLD,
+} from "./local/config";
+export type { Config } from "./local/config";
 
 import { RoutingFrame } from "@core/net/routing";
 import { FrameType, Procedure, RpcRequest, RpcResponse, RpcStatus, deserializeFrame } from "../frame";
@@ -14,11 +21,14 @@ import { LinkService } from "@core/net/link";
 import { LocalNodeService } from "@core/net/local";
 
 import * as Blink from "./debug/blink";
+import * as GetFrameBufferPoolStats from "./debug/getFrameBufferPoolStats";
+import * as ResetFrameBufferPoolStats from "./debug/resetFrameBufferPoolStats";
 import * as GetMediaList from "./media/getMediaList";
 import * as StartServer from "./wifi/startServer";
 import * as CloseServer from "./wifi/closeServer";
 import * as ConnectToAccessPoint from "./wifi/connectToAccessPoint";
 import * as SetAddress from "./serial/setAddress";
+import * as NegotiateBaudRate from "./serial/negotiateBaudRate";
 import * as SetEthernetIpAddress from "./ethernet/setEthernetIpAddress";
 import * as EthernetSetSubnetMask from "./ethernet/setEthernetSubnetMask";
 import * as SetCost from "./local/setCost";
@@ -40,6 +50,7 @@ const createClients = (args: { localNodeService: LocalNodeService }) => {
         [Procedure.StartServer]: new StartServer.Client(args),
         [Procedure.CloseServer]: new CloseServer.Client(args),
         [Procedure.SetAddress]: new SetAddress.Client(args),
+        [Procedure.NegotiateBaudRate]: new NegotiateBaudRate.Client(args),
         [Procedure.SetEthernetIpAddress]: new SetEthernetIpAddress.Client(args),
         [Procedure.SetEthernetSubnetMask]: new EthernetSetSubnetMask.Client(args),
         [Procedure.SetCost]: new SetCost.Client(args),
@@ -50,6 +61,8 @@ const createClients = (args: { localNodeService: LocalNodeService }) => {
         [Procedure.GetVRouters]: new GetVRouters.Client(args),
         [Procedure.CreateVRouter]: new CreateVRouter.Client(args),
         [Procedure.DeleteVRouter]: new DeleteVRouter.Client(args),
+        [Procedure.GetFrameBufferPoolStats]: new GetFrameBufferPoolStats.Client(args),
+        [Procedure.ResetFrameBufferPoolStats]: new ResetFrameBufferPoolStats.Client(args),
     } as const;
 };
 
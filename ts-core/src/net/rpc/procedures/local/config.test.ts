@@ -0,0 +1,31 @@
+import { BufferReader, BufferWriter } from "@core/net/buffer";
+import { ConfigFlag, DEFAULT_CONFIG, configSerdeable } from "./config";
+
+describe("configSerdeable", () => {
+    it("deserializes the default config of a node", () => {
+        const reader = new BufferReader(new Uint8Array([0b01000100]));
+        expect(configSerdeable.deserializer().deserialize(reader).unwrap()).toEqual(DEFAULT_CONFIG);
+    });
+
+    it("serializes the broadcast suppression fields", () => {
+        const buffer = new Uint8Array(1);
+        const writer = new BufferWriter(buffer);
+        const config = {
+            flags: ConfigFlag.enableAutoNeighborDiscovery,
+            broadcastSuppressionThreshold: 5,
+            broadcastAssessmentDelay: 2,
+        };
+        expect(configSerdeable.serializer(config).serialize(writer).isOk()).toBe(true);
+        expect(buffer).toEqual(new Uint8Array([0b10101001]));
+    });
+
+    it("accepts every byte", () => {
+        const reader = new BufferReader(new Uint8Array([0xff]));
+        expect(configSerdeable.deserializer().deserialize(reader).unwrap()).toEqual({
+            flags:
+                ConfigFlag.enableAutoNeighborDiscovery | ConfigFlag.enableDynamicCostUpdate | ConfigFlag.enableFrameDelay,
+            broadcastSuppressionThreshold: 7,
+            broadcastAssessmentDelay: 3,
+        });
+    });
+});
@@ -1,10 +1,44 @@
-import { Uint8Serdeable } from "@core/serde";
-import { BitflagsSerdeable } from "@core/serde/bitflags";
+import { TransformSerdeable, Uint8Serdeable } from "@core/serde";
 
-export enum Config {
+export enum ConfigFlag {
     enableAutoNeighborDiscovery = 0b00000001,
     enableDynamicCostUpdate = 0b00000010,
     enableFrameDelay = 0b00000100,
 }
 
-export const configSerdeable = new BitflagsSerdeable<Config>(Config, new Uint8Serdeable());
+const FLAGS_MASK = 0b00000111;
+const SUPPRESSION_THRESHOLD_SHIFT = 3;
+const SUPPRESSION_THRESHOLD_MASK = 0b111;
+const ASSESSMENT_DELAY_SHIFT = 6;
+const ASSESSMENT_DELAY_MASK = 0b11;
+
+export const MAX_BROADCAST_SUPPRESSION_THRESHOLD = SUPPRESSION_THRESHOLD_MASK;
+export const MAX_BROADCAST_ASSESSMENT_DELAY = ASSESSMENT_DELAY_MASK;
+
+export interface Config {
+    flags: ConfigFlag | 0;
+    // ブロードキャストの中継を取りやめる，待機中に重複して受信した回数．0の場合は抑制しない
+    broadcastSuppressionThreshold: number;
+    // 中継の待機時間の上限．`BROADCAST_ASSESSMENT_DELAY_UNIT << broadcastAssessmentDelay`
+    broadcastAssessmentDelay: number;
+}
+
+export const DEFAULT_CONFIG: Config = {
+    flags: ConfigFlag.enableFrameDelay,
+    broadcastSuppressionThreshold: 0,
+    broadcastAssessmentDelay: 1,
+};
+
+const fromByte = (byte: number): Config => ({
+    flags: (byte & FLAGS_MASK) as ConfigFlag | 0,
+    broadcastSuppressionThreshold: (byte >> SUPPRESSION_THRESHOLD_SHIFT) & SUPPRESSION_THRESHOLD_MASK,
+    broadcastAssessmentDelay: (byte >> ASSESSMENT_DELAY_SHIFT) & ASSESSMENT_DELAY_MASK,
+});
+
+const toByte = (config: Config): number => {
+    const threshold = config.broadcastSuppressionThreshold & SUPPRESSION_THRESHOLD_MASK;
+    const delay = config.broadcastAssessmentDelay & ASSESSMENT_DELAY_MASK;
+    return (config.flags & FLAGS_MASK) | (threshold << SUPPRESSION_THRESHOLD_SHIFT) | (delay << ASSESSMENT_DELAY_SHIFT);
+};
+
+export const configSerdeable = new TransformSerdeable<number, Config>(new Uint8Serdeable(), fromByte, toByte);
@@ -0,0 +1,33 @@
+import { MediaPortNumber } from "@core/net/link";
+import { RpcClient } from "../handler";
+import { RequestManager, RpcResult } from "../../request";
+import { Destination } from "@core/net/node";
+import { Procedure, RpcRequest, RpcResponse } from "../../frame";
+import { LocalNodeService } from "@core/net/local";
+import { ObjectSerdeable, Uint32Serdeable } from "@core/serde";
+
+const paramSerdeable = new ObjectSerdeable({
+    portNumber: MediaPortNumber.serdeable,
+    baudRate: new Uint32Serdeable(),
+});
+
+export class Client implements RpcClient<void> {
+    #requestManager: RequestManager<void>;
+
+    constructor({ localNodeService }: { localNodeService: LocalNodeService }) {
+        this.#requestManager = new RequestManager({ procedure: Procedure.NegotiateBaudRate, localNodeService });
+    }
+
+    createRequest(
+        destination: Destination,
+        portNumber: MediaPortNumber,
+        baudRate: number,
+    ): Promise<[RpcRequest, Promise<RpcResult<void>>]> {
+        const body = paramSerdeable.serializer({ portNumber, baudRate });
+        return this.#requestManager.createRequest(destination, body);
+    }
+
+    handleResponse(response: RpcResponse): void {
+        this.#requestManager.resolveVoid(response);
+    }
+}
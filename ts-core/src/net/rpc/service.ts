@@ -15,6 +15,7 @@ import {
     SetEthernetIpAddressParam,
     SetEthernetSubnetMaskParam,
     Config,
+    FrameBufferPoolStats,
 } from "./procedures";
 import { VRouter } from "./procedures/vrouter/getVRouters";
 import { RpcResult } from "./request";
@@ -115,6 +116,16 @@ export class RpcService {
         return (await this.#sendRequest(request)) ?? result;
     }
 
+    async requestNegotiateSerialBaudRate(
+        destination: Destination,
+        portNumber: MediaPortNumber,
+        baudRate: number,
+    ): Promise<RpcResult<void>> {
+        const handler = this.#handler.getClient(Procedure.NegotiateBaudRate);
+        const [request, result] = await handler.createRequest(destination, portNumber, baudRate);
+        return (await this.#sendRequest(request)) ?? result;
+    }
+
     async requestSetClusterId(destination: Destination, clusterId: OptionalClusterId): Promise<RpcResult<void>> {
         const handler = this.#handler.getClient(Procedure.SetClusterId);
         const [request, result] = await handler.createRequest(destination, clusterId);
@@ -133,7 +144,7 @@ export class RpcService {
         return (await this.#sendRequest(request)) ?? result;
     }
 
-    async requestSetConfig(destination: Destination, config: 0 | Config): Promise<RpcResult<void>> {
+    async requestSetConfig(destination: Destination, config: Config): Promise<RpcResult<void>> {
         const handler = this.#handler.getClient(Procedure.SetConfig);
         const [request, result] = await handler.createRequest(destination, config);
         return (await this.#sendRequest(request)) ?? result;
@@ -185,4 +196,16 @@ export class RpcService {
         const [request, result] = await handler.createRequest(destination, { port });
         return (await this.#sendRequest(request)) ?? result;
     }
+
+    async requestGetFrameBufferPoolStats(destination: Destination): Promise<RpcResult<FrameBufferPoolStats[]>> {
+        const handler = this.#handler.getClient(Procedure.GetFrameBufferPoolStats);
+        const [request, result] = await handler.createRequest(destination);
+        return (await this.#sendRequest(request)) ?? result;
+    }
+
+    async requestResetFrameBufferPoolStats(destination: Destination): Promise<RpcResult<void>> {
+        const handler = this.#handler.getClient(Procedure.ResetFrameBufferPoolStats);
+        const [request, result] = await handler.createRequest(destination);
+        return (await this.#sendRequest(request)) ?? result;
+    }
 }